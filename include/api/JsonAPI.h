@@ -320,6 +320,12 @@ private:
 	///
 	void handleGetLedSnapshotCommand(const QJsonObject &message, const JsonApiCommand& cmd);
 
+	/// Handle an incoming JSON message to request the output processing latencies
+	///
+	/// @param message the incoming message
+	///
+	void handleGetLatencyStatisticsCommand(const QJsonObject &message, const JsonApiCommand& cmd);
+
 
 	void applyColorAdjustments(const QJsonObject &adjustment, ColorAdjustment *colorAdjustment);
 	void applyColorAdjustment(const QString &colorName, const QJsonObject &adjustment, RgbChannelAdjustment &rgbAdjustment);
@@ -88,6 +88,7 @@ public:
 		GetConfig,
 		GetImageSnapshot,
 		GetInfo,
+		GetLatencyStatistics,
 		GetLedSnapshot,
 		GetPendingTokenRequests,
 		GetProperties,
@@ -140,6 +141,7 @@ public:
 		case GetConfig: return "getconfig";
 		case GetImageSnapshot: return "getImageSnapshot";
 		case GetInfo: return "getInfo";
+		case GetLatencyStatistics: return "getLatencyStatistics";
 		case GetLedSnapshot: return "getLedSnapshot";
 		case GetPendingTokenRequests: return "getPendingTokenRequests";
 		case GetProperties: return "getProperties";
@@ -330,6 +332,7 @@ public:
 			{ {"instance", "switchTo"},                  { Command::Instance,       SubCommand::SwitchTo,                Authorization::Yes,    InstanceCmd::No,           InstanceCmd::MustRun_No,     NoListenerCmd::Yes } },
 			{ {"instance-data", "getImageSnapshot"},     { Command::InstanceData,   SubCommand::GetImageSnapshot,        Authorization::Yes,    InstanceCmd::Single,       InstanceCmd::MustRun_Yes,    NoListenerCmd::Yes } },
 			{ {"instance-data", "getLedSnapshot"},       { Command::InstanceData,   SubCommand::GetLedSnapshot,          Authorization::Yes,    InstanceCmd::Single,       InstanceCmd::MustRun_Yes,    NoListenerCmd::Yes } },
+			{ {"instance-data", "getLatencyStatistics"}, { Command::InstanceData,   SubCommand::GetLatencyStatistics,    Authorization::Yes,    InstanceCmd::Single,       InstanceCmd::MustRun_Yes,    NoListenerCmd::Yes } },
 			{ {"ledcolors", "imagestream-start"},        { Command::LedColors,      SubCommand::ImageStreamStart,        Authorization::Yes,    InstanceCmd::Single,       InstanceCmd::MustRun_Yes,    NoListenerCmd::No  } },
 			{ {"ledcolors", "imagestream-stop"},         { Command::LedColors,      SubCommand::ImageStreamStop,         Authorization::Yes,    InstanceCmd::Single,       InstanceCmd::MustRun_Yes,    NoListenerCmd::No  } },
 			{ {"ledcolors", "ledstream-start"},          { Command::LedColors,      SubCommand::LedStreamStart,          Authorization::Yes,    InstanceCmd::Single,       InstanceCmd::MustRun_Yes,    NoListenerCmd::No  } },
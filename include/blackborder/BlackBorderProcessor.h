@@ -2,6 +2,7 @@
 #define BLACK_BORDER_PROCESSOR_H
 
 #include <memory>
+#include <type_traits>
 
 // QT includes
 #include <QJsonObject>
@@ -10,6 +11,7 @@
 #include <utils/Logger.h>
 #include <utils/settings.h>
 #include <utils/Components.h>
+#include <utils/ImageAnalysisCache.h>
 
 // Local Hyperion includes
 #include "BlackBorderDetector.h"
@@ -41,6 +43,13 @@ namespace hyperion
 		///
 		bool enabled() const;
 
+		///
+		/// Return, if the current border is settled, i.e. processing the image last processed again
+		/// would neither change the current border nor advance a border switch
+		/// @return True, if the current border is settled
+		///
+		bool isSettled() const;
+
 		///
 		/// Set activation state of black border detector
 		/// @param enable current state
@@ -80,14 +89,15 @@ namespace hyperion
 				return true;
 			}
 
-			if (_detectionMode == "default") {
-				imageBorder = _detector->process(image);
-			} else if (_detectionMode == "classic") {
-				imageBorder = _detector->process_classic(image);
-			} else if (_detectionMode == "osd") {
-				imageBorder = _detector->process_osd(image);
-			} else if (_detectionMode == "letterbox") {
-				imageBorder = _detector->process_letterbox(image);
+			if constexpr (std::is_same_v<Pixel_T, ColorRgb>)
+			{
+				// Instances consuming the same frame with the same detector settings share the detection
+				const QByteArray key = QByteArray("blackborder/") + _detectionMode.toUtf8() + '/' + QByteArray::number(_oldThreshold);
+				imageBorder = *ImageAnalysisCache::getInstance().get<BlackBorder>(image, key, [&]() { return detectBorder(image); });
+			}
+			else
+			{
+				imageBorder = detectBorder(image);
 			}
 			// add blur to the border
 			if (imageBorder.horizontalSize > 0)
@@ -102,6 +112,35 @@ namespace hyperion
 			const bool borderUpdated = updateBorder(imageBorder);
 			return borderUpdated;
 		}
+
+	private:
+		///
+		/// Runs the configured detection mode on the given image
+		///
+		/// @param[in] image  The image on which detection is performed
+		///
+		/// @return The border detected in the image
+		///
+		template <typename Pixel_T>
+		BlackBorder detectBorder(const Image<Pixel_T> & image) const
+		{
+			BlackBorder imageBorder;
+			imageBorder.unknown = false;
+			imageBorder.horizontalSize = 0;
+			imageBorder.verticalSize = 0;
+
+			if (_detectionMode == "default") {
+				imageBorder = _detector->process(image);
+			} else if (_detectionMode == "classic") {
+				imageBorder = _detector->process_classic(image);
+			} else if (_detectionMode == "osd") {
+				imageBorder = _detector->process_osd(image);
+			} else if (_detectionMode == "letterbox") {
+				imageBorder = _detector->process_letterbox(image);
+			}
+			return imageBorder;
+		}
+
 	private slots:
 		///
 		/// @brief Handle settings update from Hyperion Settingsmanager emit or this constructor
@@ -18,6 +18,8 @@
 // Utility includes
 #include <utils/Logger.h>
 
+class QSocketNotifier;
+
 struct DrmProperty
 {
 	drmModePropertyPtr spec;
@@ -141,8 +143,57 @@ public:
 	 */
 	QJsonObject discover(const QJsonObject& params);
 
+	/**
+	 * @brief Enables capturing on page flips of the primary plane instead of at a fixed rate.
+	 * The plane is checked for a new framebuffer on every vertical blank of the active CRTC.
+	 *
+	 * @param enable True, to capture on page flips.
+	 */
+	void setEventDriven(bool enable) override;
+
+	/**
+	 * @brief Checks if vertical blank events are delivered, i.e. page flips are reported.
+	 *
+	 * @return True, if enabled and a vertical blank event is pending.
+	 */
+	bool isEventDriven() const override;
+
 private:
 
+	/**
+	 * @brief Starts the vertical blank events, if event-driven capturing is enabled.
+	 */
+	void setupVblank();
+
+	/**
+	 * @brief Stops the vertical blank events.
+	 */
+	void freeVblank();
+
+	/**
+	 * @brief Requests an event for the next vertical blank of the active CRTC.
+	 * @return True on success, false on failure.
+	 */
+	bool requestVblank();
+
+	/**
+	 * @brief Called for every vertical blank, emits frameAvailable() if the primary plane shows a new framebuffer.
+	 */
+	void handleVblank();
+
+	/**
+	 * @brief Makes the framebuffer the one to be captured, framebuffers of previous page flips are kept for reuse.
+	 * @param fbId The ID of the framebuffer shown by the primary plane.
+	 * @return True on success, false on failure.
+	 */
+	bool updateFramebuffer(uint32_t fbId);
+
+	/**
+	 * @brief Releases a framebuffer including the GEM handles acquired for it.
+	 * @param framebuffer The framebuffer to be released.
+	 */
+	void releaseFramebuffer(drmModeFB2Ptr framebuffer) const;
+
 	/**
 	 * @brief Releases all allocated DRM resources.
 	 * This includes closing the device file descriptor and freeing memory associated with
@@ -242,5 +293,17 @@ private:
 
 	/// The pixel format of the captured framebuffer.
 	PixelFormat _pixelFormat;
+
+	/// Index of the active CRTC in the DRM resources (selects its vertical blank events).
+	int _crtcIndex;
+
+	/// The ID of the framebuffer captured, i.e. last shown by the primary plane.
+	uint32_t _currentFbId;
+
+	/// Notifier for DRM events on the device file descriptor.
+	QSocketNotifier* _vblankNotifier;
+
+	/// Is a vertical blank event pending?
+	bool _isVblankRequested;
 };
 
@@ -1,8 +1,13 @@
 #ifndef ENCODERTHREAD_H
 #define ENCODERTHREAD_H
 
+// STL includes
+#include <atomic>
+#include <functional>
+
 // Qt includes
 #include <QThread>
+#include <QJsonObject>
 
 // util includes
 #include <utils/PixelFormat.h>
@@ -48,29 +53,58 @@ public:
 	explicit EncoderThread();
 	~EncoderThread() override;
 
+	///
+	/// @brief Set up the next frame to be processed
+	///
+	/// Without a release function the frame data is copied. With a release function the frame data is lent,
+	/// i.e. decoded in place: the thread is busy until the data is released, which happens on the encoder thread
+	/// as soon as the data is no longer accessed.
+	///
+	/// @param sequence     Capture sequence number of the frame, emitted with the result
+	/// @param releaseData  Function returning lent frame data to its owner (nullptr to copy the data)
+	///
 	void setup(
 		PixelFormat pixelFormat, uint8_t* sharedData,
 		int size, int width, int height, int lineLength,
 		int cropLeft, int cropTop, int cropBottom, int cropRight,
-		VideoMode videoMode, FlipMode flipMode, int pixelDecimation);
-
-	void process();
+		VideoMode videoMode, FlipMode flipMode, int pixelDecimation, bool boxFilter,
+		quint64 sequence, std::function<void()> releaseData = nullptr);
 
 	bool isBusy() const { return _busy; }
 
+public slots:
+	void process();
+
 signals:
-	void newFrame(const Image<ColorRgb>& data);
+	///
+	/// @brief Emits for every frame processed
+	/// @param sequence  Capture sequence number of the frame
+	/// @param data      The decoded image (null, if the frame could not be decoded)
+	///
+	void newFrame(quint64 sequence, const Image<ColorRgb>& data);
 
 private:
+	/// Returns lent frame data to its owner
+	void releaseFrameData();
+
 	QAtomicInt _busy = false;
 	PixelFormat _pixelFormat;
+	/// Owned buffer for copied or transformed frame data
 	uint8_t* _localData;
+	/// The frame data processed (owned or lent)
+	uint8_t* _frameData;
+	std::function<void()> _releaseData;
 	int	_scalingFactorsCount;
+	/// MJPEG frames are decoded at 1/_scaleDenominator of their size
+	int	_scaleDenominator;
+	/// Scaled MJPEG frames are cropped, flipped or decimated further after decoding
+	bool _resampleDecoded;
 	int	_width;
 	int	_height;
 	int	_lineLength;
 	int	_currentFrame;
 	int	_pixelDecimation;
+	quint64 _sequence;
 	unsigned long _size;
 	int	_cropLeft;
 	int _cropTop;
@@ -82,6 +116,8 @@ private:
 	bool _doTransform;
 
 	ImageResampler		_imageResampler;
+	/// Reused decode buffer of scaled MJPEG frames that are processed further
+	Image<ColorRgb>		_decodedImage;
 
 	// TurboJPEG members - always present for ODR compliance
 	// When HAVE_TURBO_JPEG is not defined, these are opaque void pointers
@@ -90,7 +126,14 @@ private:
 	tjtransform*		_xform;
 
 #ifdef HAVE_TURBO_JPEG
-	void processImageMjpeg();
+	///
+	/// @brief Get the libjpeg-turbo scale an MJPEG frame is decoded with
+	/// @param pixelDecimation  The configured decimation
+	/// @return Denominator of the largest power-of-two scale not exceeding the decimation (1, 2, 4 or 8)
+	///
+	int scaleDenominator(int pixelDecimation) const;
+	Image<ColorRgb> processImageMjpeg();
+	Image<ColorRgb> processImageMjpegScaled();
 	bool onError(const QString context) const;
 #endif
 };
@@ -119,14 +162,16 @@ public:
 		PixelFormat pixelFormat, uint8_t* sharedData,
 		int size, int width, int height, int lineLength,
 		int cropLeft, int cropTop, int cropBottom, int cropRight,
-		VideoMode videoMode, FlipMode flipMode, int pixelDecimation)
+		VideoMode videoMode, FlipMode flipMode, int pixelDecimation, bool boxFilter,
+		quint64 sequence, std::function<void()> releaseData = nullptr)
 	{
 		auto encThread = qobject_cast<EncoderThread*>(_thread);
 		if (encThread != nullptr)
 			encThread->setup(pixelFormat, sharedData,
 				size, width, height, lineLength,
 				cropLeft, cropTop, cropBottom, cropRight,
-				videoMode, flipMode, pixelDecimation);
+				videoMode, flipMode, pixelDecimation, boxFilter,
+				sequence, std::move(releaseData));
 	}
 
 	bool isBusy()
@@ -145,6 +190,14 @@ public:
 			encThread->process();
 	}
 
+	/// Processes the frame set up on the encoder thread, the caller returns immediately
+	void processAsync()
+	{
+		auto encThread = qobject_cast<EncoderThread*>(_thread);
+		if (encThread != nullptr)
+			QMetaObject::invokeMethod(encThread, "process", Qt::QueuedConnection);
+	}
+
 protected:
 	void run() override
 	{
@@ -153,54 +206,72 @@ protected:
 	}
 };
 
+///
+/// Distributes captured frames to the encoder threads and emits the decoded frames strictly in capture order.
+///
+/// Every frame gets a sequence number. The number of frames in flight is bounded by the queue depth, frames exceeding
+/// it are dropped at capture (back pressure). A frame completing after a newer one has already been emitted is stale
+/// and dropped, i.e. a frame is never emitted late.
+///
 class EncoderThreadManager : public QObject
 {
-    Q_OBJECT
+	Q_OBJECT
 public:
-	explicit EncoderThreadManager(QObject *parent = nullptr)
-		: QObject(parent)
-	{
-		_threads = new Thread<EncoderThread>*[_threadCount];
-		for (int i = 0; i < _threadCount; i++)
-		{
-			_threads[i] = new Thread<EncoderThread>(new EncoderThread, this);
-			_threads[i]->setObjectName("Encoder " + QString::number(i));
-		}
-	}
+	explicit EncoderThreadManager(QObject *parent = nullptr);
+	~EncoderThreadManager() override;
 
-	~EncoderThreadManager() override
-	{
-		if (_threads != nullptr)
-		{
-			for(int i = 0; i < _threadCount; i++)
-			{
-				_threads[i]->deleteLater();
-				_threads[i] = nullptr;
-			}
-
-			delete[] _threads;
-			_threads = nullptr;
-		}
-	}
+	void start();
+	void stop();
 
-	void start()
-	{
-		if (_threads != nullptr)
-			for (int i = 0; i < _threadCount; i++)
-				connect(_threads[i]->thread(), &EncoderThread::newFrame, this, &EncoderThreadManager::newFrame);
-	}
+	///
+	/// @brief Set the maximum number of frames being decoded at the same time
+	/// @param queueDepth  Number of frames (0 for the number of encoder threads)
+	///
+	void setQueueDepth(int queueDepth);
 
-	void stop()
-	{
-		if (_threads != nullptr)
-			for(int  i = 0; i < _threadCount; i++)
-				disconnect(_threads[i]->thread(), nullptr, nullptr, nullptr);
-	}
+	///
+	/// @brief Hand a captured frame to an idle encoder thread
+	///
+	/// Copied frames are decoded before the function returns, lent frames are decoded asynchronously.
+	///
+	/// @param releaseData  Function returning lent frame data to its owner (nullptr to copy the data)
+	/// @return False, if the frame was dropped (queue full or no encoder thread idle); lent data is not taken over then
+	///
+	bool process(
+		PixelFormat pixelFormat, uint8_t* sharedData,
+		int size, int width, int height, int lineLength,
+		int cropLeft, int cropTop, int cropBottom, int cropRight,
+		VideoMode videoMode, FlipMode flipMode, int pixelDecimation, bool boxFilter,
+		std::function<void()> releaseData = nullptr);
+
+	///
+	/// @brief Get the frame counters since the start (thread-safe)
+	/// @return Decoded and dropped frames (of them stale ones, decoded after a newer frame) and the queue depth
+	///
+	QJsonObject getStatistics() const;
 
 	int _threadCount = qMax(QThread::idealThreadCount(), DEFAULT_THREAD_COUNT);
 	Thread<EncoderThread>**	_threads = nullptr;
 
 signals:
 	void newFrame(const Image<ColorRgb>& data);
+
+private slots:
+	///
+	/// @brief Ordering stage, called in the manager's thread for every processed frame. Frames older than the last one emitted are dropped.
+	///
+	void handleFrame(quint64 sequence, const Image<ColorRgb>& image);
+
+private:
+	std::atomic<int> _queueDepth {0};
+	std::atomic<int> _framesInFlight {0};
+	quint64 _nextSequence = 0;
+	/// Sequence number following the last emitted frame
+	quint64 _nextEmitSequence = 0;
+
+	std::atomic<quint64> _decodedFrames {0};
+	std::atomic<quint64> _droppedFrames {0};
+	/// Frames dropped, as a newer frame was already emitted
+	std::atomic<quint64> _staleFrames {0};
 };
 #endif //ENCODERTHREAD_H
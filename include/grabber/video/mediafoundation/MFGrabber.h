@@ -72,6 +72,8 @@ public:
 	void setSignalThreshold(double redSignalThreshold, double greenSignalThreshold, double blueSignalThreshold, int noSignalCounterThreshold);
 	void setSignalDetectionOffset( double verticalMin, double horizontalMin, double verticalMax, double horizontalMax);
 	void setSignalDetectionEnable(bool enable);
+	void setDecoderQueueDepth(int queueDepth);
+	QJsonObject getStatistics() const override;
 	bool reload(bool force = false);
 
 	///
@@ -107,6 +109,7 @@ private:
 	IMFSourceReader*							_sourceReader;
 	SourceReaderCB*								_sourceReaderCB;
 	EncoderThreadManager*						_threadManager;
+	int											_decoderQueueDepth {0};
 	PixelFormat									_pixelFormat,
 												_pixelFormatConfig;
 	int											_lineLength,
@@ -1,6 +1,7 @@
 #pragma once
 
 // stl includes
+#include <atomic>
 #include <vector>
 #include <map>
 
@@ -76,6 +77,8 @@ public:
 	void setSignalThreshold(double redSignalThreshold, double greenSignalThreshold, double blueSignalThreshold, int noSignalCounterThreshold = 50);
 	void setSignalDetectionOffset( double verticalMin, double horizontalMin, double verticalMax, double horizontalMax);
 	void setSignalDetectionEnable(bool enable);
+	void setDecoderQueueDepth(int queueDepth);
+	QJsonObject getStatistics() const override;
 	bool reload(bool force = false);
 
 	QRectF getSignalDetectionOffset() const { return QRectF(_x_frac_min, _y_frac_min, _x_frac_max, _y_frac_max); } //used from hyperion-v4l2
@@ -100,6 +103,13 @@ signals:
 private slots:
 	int read_frame();
 
+	///
+	/// @brief Queue a capture buffer lent to an encoder thread again, once it is decoded
+	/// @param index       The index of the buffer
+	/// @param generation  The buffer generation the buffer was lent from (stale buffers are ignored)
+	///
+	void requeueBuffer(int index, int generation);
+
 private:
 	bool init();
 	void uninit();
@@ -112,7 +122,9 @@ private:
 	void uninit_device();
 	void start_capturing();
 	void stop_capturing();
-	bool process_image(const void *p, int size);
+	bool process_image(const void *p, int size, int bufferIndex = -1);
+	unsigned int captureBufferCount() const;
+	bool waitForLentBuffers();
 	int xioctl(int request, void *arg);
 	int xioctl(int fileDescriptor, int request, void *arg);
 
@@ -142,6 +154,7 @@ private:
 	QString _currentDevicePath;
 	QString _currentDeviceName;
 	EncoderThreadManager* _threadManager;
+	int _decoderQueueDepth {0};
 	QMap<QString, V4L2Grabber::DeviceProperties> _deviceProperties;
 	QMap<QString, QList<DeviceControls>> _deviceControls;
 
@@ -149,6 +162,11 @@ private:
 	int _fileDescriptor;
 	std::vector<buffer> _buffers;
 
+	/// Number of mmap buffers lent to encoder threads (decoded in place, queued again once decoded)
+	std::atomic<int> _lentBuffers {0};
+	/// Incremented whenever the mmap buffers are released
+	int _bufferGeneration {0};
+
 	PixelFormat _pixelFormat;
 	PixelFormat _pixelFormatConfig;
 	int _lineLength;
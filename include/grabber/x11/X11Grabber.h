@@ -26,6 +26,8 @@
 	#undef Bool
 #endif
 
+class QSocketNotifier;
+
 class X11Grabber : public Grabber , public QAbstractNativeEventFilter
 {
 public:
@@ -60,6 +62,13 @@ public:
 
 	void setVideoMode(VideoMode mode) override;
 
+	///
+	/// @brief Apply if frames are captured on screen damage (XDamage) instead of at a fixed rate
+	///
+	void setEventDriven(bool enable) override;
+
+	bool isEventDriven() const override;
+
 	///
 	/// @brief Apply new width/height values, overwrite Grabber.h implementation as X11 doesn't use width/height, just pixelDecimation to calc dimensions
 	///
@@ -100,6 +109,17 @@ private:
 	void freeResources();
 	void setupResources();
 
+	///
+	/// @brief Report damage of the root window via the display connection, if event-driven capturing is enabled
+	///
+	void setupDamage();
+	void freeDamage();
+
+	///
+	/// @brief Process the pending events of the display connection, emits frameAvailable() on damage
+	///
+	void processDamageEvents();
+
 	/// Reference to the X11 display (nullptr if not opened)
 	Display* _x11Display;
 	Window _window;
@@ -117,6 +137,11 @@ private:
 
 	int _xRandREventBase;
 
+	/// Damage object of the root window (None, if not reporting)
+	XID _damage;
+	int _xDamageEventBase;
+	QSocketNotifier* _damageNotifier;
+
 	XTransform _transform;
 
 	int _screenWidth;
@@ -19,6 +19,7 @@
 #include <xcb/xcb_image.h>
 
 class Logger;
+class QSocketNotifier;
 
 class XcbGrabber : public Grabber, public QAbstractNativeEventFilter
 {
@@ -46,6 +47,12 @@ public:
 	bool setPixelDecimation(int pixelDecimation) override;
 	void setCropping(int cropLeft, int cropRight, int cropTop, int cropBottom) override;
 
+	///
+	/// @brief Apply if frames are captured on screen damage (XCB damage extension) instead of at a fixed rate
+	///
+	void setEventDriven(bool enable) override;
+	bool isEventDriven() const override;
+
 	///
 	/// @brief Discover XCB screens available (for configuration).
 	///
@@ -66,6 +73,9 @@ private:
 	void setupRender();
 	void setupRandr();
 	void setupShm();
+	void setupDamage();
+	void freeDamage();
+	void processDamageEvents();
 	xcb_screen_t * getScreen(const xcb_setup_t *setup, int screen_num) const;
 	xcb_render_pictformat_t findFormatForVisual(xcb_visualid_t visual) const;
 
@@ -94,4 +104,9 @@ private:
 	uint8_t * _shmData;
 
 	int _XcbRandREventBase;
+
+	/// Damage object of the root window (0, if not reporting)
+	uint32_t _damage;
+	int _XcbDamageEventBase;
+	QSocketNotifier * _damageNotifier;
 };
@@ -0,0 +1,112 @@
+#ifndef COLORADJUSTMENTLUT_H
+#define COLORADJUSTMENTLUT_H
+
+// STL includes
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Utils includes
+#include <utils/ColorRgb.h>
+
+class ColorAdjustment;
+
+///
+/// Compiles the color adjustment chain of a ColorAdjustment (OKHSV, gamma, channel adjustments and temperature)
+/// into a 3D lookup table, which is applied by a single tetrahedral interpolation per color.
+///
+/// The table is rebuilt lazily, when the settings of the adjustment have changed.
+/// The backlight depends on the output color and runtime state. It is applied exactly after the table walk,
+/// i.e. colors within the table's error of the backlight threshold may switch differently than calculated exactly.
+///
+/// Gamma is a per channel curve, which is applied exactly before the table walk, if the table covers the
+/// channel adjustments and temperature only. The OKHSV transformation is included in the table (then indexed by
+/// the input color), if the table reproduces it within MAX_ERROR. Otherwise (e.g. saturation gains > 1 distort
+/// the colors close to gray too much), OKHSV is calculated exactly before gamma.
+///
+class ColorAdjustmentLut
+{
+public:
+	/// Number of grid points per axis
+	static constexpr int GRID_SIZE = 33;
+
+	/// Maximum deviation per channel from the exact calculation accepted for including OKHSV in the table
+	static constexpr int MAX_ERROR = 4;
+
+	///
+	/// Constructs the table for the given adjustment
+	///
+	/// @param adjustment The adjustment compiled into the table (the reference has to stay valid)
+	///
+	explicit ColorAdjustmentLut(ColorAdjustment& adjustment);
+
+	///
+	/// Rebuilds the table, if the settings of the adjustment have changed since the last build
+	///
+	/// @return True, if the table was rebuilt
+	///
+	bool update();
+
+	///
+	/// Applies the adjustment using the table. The table has to be up to date (see update()).
+	///
+	/// @param[in,out] color The color to be adjusted
+	///
+	void apply(ColorRgb& color) const;
+
+	///
+	/// Applies the adjustment using the table to a color given by its channels. The table has to be up to date.
+	///
+	/// @param[in,out] red   The red channel
+	/// @param[in,out] green The green channel
+	/// @param[in,out] blue  The blue channel
+	///
+	void apply(uint8_t& red, uint8_t& green, uint8_t& blue) const;
+
+	///
+	/// Applies the adjustment by calculating the full chain (reference for the table)
+	///
+	/// @param[in,out] color The color to be adjusted
+	///
+	void applyExact(ColorRgb& color);
+
+	///
+	/// @return True, if the OKHSV transformation is included in the table
+	///
+	bool coversOkhsv() const { return _coversOkhsv; }
+
+private:
+	/// The settings of an adjustment the table depends on
+	using Settings = std::array<double, 32>;
+
+	Settings currentSettings() const;
+
+	/// Exact OKHSV transformation (if not identity) and gamma
+	void applyOkhsvGamma(uint8_t& red, uint8_t& green, uint8_t& blue) const;
+
+	/// Exact channel adjustments and temperature of a gamma corrected color
+	ColorRgb applyChannelAdjustments(uint8_t red, uint8_t green, uint8_t blue);
+
+	/// Fills the table with the exact results at the grid points
+	void build(bool coversOkhsv);
+
+	/// @return The maximum deviation per channel at the cell centers
+	int verify();
+
+	/// Interpolates the table at the given input (grid coordinates)
+	ColorRgb lookup(uint8_t red, uint8_t green, uint8_t blue) const;
+
+	ColorAdjustment& _adjustment;
+
+	/// Settings the table was built for
+	Settings _settings;
+	bool _isValid;
+
+	/// The table includes OKHSV and gamma (indexed by the input color)
+	bool _coversOkhsv;
+
+	/// Adjusted colors at the grid points, blue varying fastest
+	std::vector<ColorRgb> _table;
+};
+
+#endif // COLORADJUSTMENTLUT_H
@@ -0,0 +1,100 @@
+#ifndef DIRTYBLOCKS_H
+#define DIRTYBLOCKS_H
+
+// STL includes
+#include <cstdint>
+#include <vector>
+
+// hyperion-utils includes
+#include <utils/Image.h>
+#include <utils/ColorRgb.h>
+
+namespace hyperion
+{
+	///
+	/// The DirtyBlocks track which blocks of a frame changed compared to the previous frame.
+	/// The image is divided into square blocks, of which only the watched ones (e.g. the blocks covered by LED areas)
+	/// are compared. The previous frame is kept as a shallow copy, i.e. no pixels are copied. Unchanged rows of a block
+	/// are compared in full, a block is marked changed at its first differing row.
+	///
+	class DirtyBlocks
+	{
+	public:
+		/// Width and height of a block [pixels]
+		static constexpr int BLOCK_SIZE = 16;
+
+		DirtyBlocks();
+
+		///
+		/// Sets the size of the frames compared. No block is watched and the previous frame is discarded.
+		///
+		/// @param[in] width   The width of the frames
+		/// @param[in] height  The height of the frames
+		///
+		void setSize(int width, int height);
+
+		///
+		/// Watches the blocks intersecting the given rectangle
+		///
+		/// @param[in] minX  First column of the rectangle
+		/// @param[in] minY  First row of the rectangle
+		/// @param[in] maxX  Column following the last column of the rectangle
+		/// @param[in] maxY  Row following the last row of the rectangle
+		///
+		void watch(int minX, int minY, int maxX, int maxY);
+
+		///
+		/// Compares the watched blocks of the frame with the previous frame, which is replaced by the frame.
+		///
+		/// @param[in] image  The frame
+		///
+		/// @return False, if there was no previous frame of the same size to compare with, i.e. all blocks are to be considered changed
+		///
+		bool update(const Image<ColorRgb> &image);
+
+		///
+		/// Checks, if a watched block intersecting the given rectangle changed with the last update
+		///
+		/// @param[in] minX  First column of the rectangle
+		/// @param[in] minY  First row of the rectangle
+		/// @param[in] maxX  Column following the last column of the rectangle
+		/// @param[in] maxY  Row following the last row of the rectangle
+		///
+		/// @return True, if the rectangle changed
+		///
+		bool isDirty(int minX, int minY, int maxX, int maxY) const;
+
+		///
+		/// @return The number of watched blocks and the number of them changed with the last update
+		///
+		int watchedCount() const { return _watchedCount; }
+		int dirtyCount() const { return _dirtyCount; }
+
+		///
+		/// Discards the previous frame, the next update reports all blocks changed
+		///
+		void reset();
+
+	private:
+		/// The width and height of the frames
+		int _width;
+		int _height;
+		/// The number of block columns and rows
+		int _columns;
+		int _rows;
+
+		/// Per block (row by row), 1 if watched
+		std::vector<uint8_t> _watched;
+		/// Per block (row by row), 1 if changed with the last update
+		std::vector<uint8_t> _dirty;
+
+		int _watchedCount;
+		int _dirtyCount;
+
+		/// The frame of the last update
+		Image<ColorRgb> _previous;
+	};
+
+} // end namespace hyperion
+
+#endif // DIRTYBLOCKS_H
@@ -5,6 +5,7 @@
 #include <QObject>
 #include <QSize>
 #include <QJsonArray>
+#include <QJsonObject>
 #include <QLoggingCategory>
 
 #include <utils/ColorRgb.h>
@@ -100,6 +101,23 @@ public:
 	///
 	virtual bool setPixelDecimation(int pixelDecimation);
 
+	///
+	/// @brief Apply if decimated pixels are averaged (box filter) instead of sampled
+	///
+	virtual void setBoxFilter(bool enable);
+
+	///
+	/// @brief Apply if frames are captured on change events (screen damage, page flips) instead of at a fixed rate
+	///
+	/// Grabbers supporting change events emit frameAvailable() whenever the displayed content changed.
+	///
+	virtual void setEventDriven(bool enable);
+
+	///
+	/// @brief Determine if change events are enabled and delivered, i.e. frameAvailable() is emitted on changes
+	///
+	virtual bool isEventDriven() const { return false; }
+
 	///
 	/// @brief Apply display index (used from qt)
 	///
@@ -152,9 +170,22 @@ public:
 	virtual QSize getScreenSize() const { return QSize(); }
 	virtual QJsonArray getInputDeviceDetails() const { return QJsonArray(); }
 
+	///
+	/// @brief Get processing statistics of the grabber (thread-safe)
+	///
+	/// @return The statistics, empty if the grabber does not provide any
+	///
+	virtual QJsonObject getStatistics() const { return QJsonObject(); }
+
 	QJsonArray getFpsSupported() const { return _fpsSupportedList; }
 	void setFpsSupported(const QJsonArray& fpsSupported) { _fpsSupportedList = fpsSupported; }
 
+signals:
+	///
+	/// @brief Emits when the displayed content changed (event-driven grabbers only)
+	///
+	void frameAvailable();
+
 public slots:
 
 	virtual void handleEvent(Event event) { /* to be overridden by subclasses */ }
@@ -188,6 +219,12 @@ protected:
 	/// Image size decimation
 	int _pixelDecimation;
 
+	/// Average decimated pixels instead of sampling them
+	bool _boxFilter;
+
+	/// Capture on change events instead of at a fixed rate
+	bool _eventDriven;
+
 	/// the used Flip Mode
 	FlipMode _flipMode;
 
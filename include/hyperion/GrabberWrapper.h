@@ -7,6 +7,7 @@
 #include <QStringList>
 #include <QMultiMap>
 #include <QScopedPointer>
+#include <QElapsedTimer>
 #include <QLoggingCategory>
 
 #include <utils/Logger.h>
@@ -54,6 +55,8 @@ public:
 	static const int DEFAULT_MIN_GRAB_RATE_HZ;
 	static const int DEFAULT_MAX_GRAB_RATE_HZ;
 	static const int DEFAULT_PIXELDECIMATION;
+	/// Maximum interval between captures of event-driven grabbers [ms]
+	static const int EVENT_FALLBACK_INTERVAL_MS;
 
 	static QMap<int, QString> GRABBER_SYS_CLIENTS;
 	static QMap<int, QString> GRABBER_V4L_CLIENTS;
@@ -107,6 +110,13 @@ public:
 
 	static QStringList availableGrabbers(GrabberTypeFilter type = GrabberTypeFilter::ALL);
 
+	///
+	/// @brief Get the runtime statistics of the existing grabbers
+	/// @param type Filter for a given grabber type
+	/// @return Statistics per grabber name (only grabbers reporting statistics are listed)
+	///
+	static QJsonObject getStatistics(GrabberTypeFilter type = GrabberTypeFilter::ALL);
+
 	template <typename Grabber_T>
 	bool transferFrame(Grabber_T &grabber)
 	{
@@ -175,6 +185,12 @@ private slots:
 	/// Will start and stop grabber based on active listeners count
 	void handleSourceRequest(hyperion::Components component, int hyperionInd, bool listen);
 
+	/// @brief Capture a frame, called by the update timer or for change events
+	void triggerAction();
+
+	/// @brief Schedule a capture for a change event of the grabber, limited to the update rate
+	void handleFrameAvailable();
+
 protected:
 
 	///
@@ -205,12 +221,27 @@ private:
 	void handleSourceRequestVideo(hyperion::Components component, int hyperionInd, bool listen);
 	void handleSourceRequestAudio(hyperion::Components component, int hyperionInd, bool listen);
 
+	/// @return Interval of the update timer, the fallback interval for event-driven grabbers [ms]
+	int timerInterval() const;
+
+	/// @return Type of a grabber derived from its name
+	static GrabberTypeFilter grabberType(const QString& grabberName);
+
+	/// All existing grabber wrappers
+	static QList<GrabberWrapper*> _wrappers;
+
 	Grabber *_ggrabber;
 	QString _grabberName;
 
 	/// The timer for generating events with the specified update rate
 	QScopedPointer<QTimer> _timer;
 
+	/// Single shot timer for captures scheduled by change events
+	QScopedPointer<QTimer> _eventTimer;
+
+	/// Time since the last capture
+	QElapsedTimer _lastAction;
+
 	/// The calculated update rate [ms]
 	int _updateInterval_ms;
 
@@ -4,6 +4,7 @@
 #include <list>
 #include <chrono>
 #include <atomic>
+#include <memory>
 
 // QT includes
 #include <QString>
@@ -19,6 +20,7 @@
 #include <QSharedPointer>
 #include <QThread>
 #include <QTimer>
+#include <QMutex>
 #include <QLoggingCategory>
 
 // hyperion-utils includes
@@ -26,9 +28,12 @@
 #include <utils/ColorRgb.h>
 #include <utils/Components.h>
 #include <utils/VideoMode.h>
+#include <utils/LatencyHistogram.h>
 
 // Hyperion includes
 #include <hyperion/LedString.h>
+#include <hyperion/LedColorPlanes.h>
+#include <hyperion/ProcessingThread.h>
 #include <hyperion/PriorityMuxer.h>
 #include <hyperion/MultiColorAdjustment.h>
 #include <hyperion/ColorAdjustment.h>
@@ -109,6 +114,13 @@ public:
 	///
 	QString getActiveDeviceType() const;
 
+	///
+	/// @brief Get the latencies of the output processing since the last statistics report (thread-safe)
+	/// @return Queue latency (update requested to processing started) and total latency (update requested to handoff
+	///         to smoothing/LED-device) histograms
+	///
+	QJsonObject getLatencyStatistics() const;
+
 public slots:
 
 	///
@@ -473,6 +485,11 @@ signals:
 	///
 	void ledDeviceData(const QVector<ColorRgb>& ledValues);
 
+	///
+	/// @brief Emits whenever the processing thread has new data for smoothing (handled on the instance's thread)
+	///
+	void smoothingData(const QVector<ColorRgb>& ledValues);
+
 	///
 	/// @brief Emits whenever new untransformed ledColos data is available, reflects the current visible device
 	///
@@ -504,6 +521,19 @@ private slots:
 	///
 	void handleSettingsUpdate(settings::type type, const QJsonDocument& config);
 
+	///
+	///	@brief Forward settings updates to the instance's components, while the output processing is held
+	///	@param type   The type from enum
+	///	@param config The configuration
+	///
+	void handleSettingsChanged(settings::type type, const QJsonDocument& config);
+
+	///
+	///	@brief Hand processed LED colors over to smoothing, which runs on the instance's thread
+	///	@param ledColors The LED colors
+	///
+	void handleSmoothingData(const QVector<ColorRgb>& ledColors);
+
 	///
 	/// @brief Apply new videoMode from Daemon to _currVideoMode
 	///
@@ -535,7 +565,8 @@ private slots:
 	///
 	void reportImagesProcessedStatistics();
 	///
-	/// @brief Process images for output.
+	/// @brief Take a snapshot of the current input and process it for output,
+	/// either directly or on the dedicated processing thread
 	///
 	void processUpdate();	
 
@@ -548,24 +579,47 @@ private:
 	void updateLedLayout(const QJsonArray& ledLayout);
 
 	///
-	/// Applies the blacklist to a vector of LED colors, setting blacklisted LEDs to black.
+	/// Applies the blacklist to the LED colors, setting blacklisted LEDs to black.
 	///
-	/// @param ledColors The vector of LED colors to modify.
+	/// @param ledColors The LED colors to modify.
 	///
-	void applyBlacklist(QVector<ColorRgb>& ledColors);
+	void applyBlacklist(LedColorPlanes& ledColors);
 
 	///
-	/// Applies the configured color order to a vector of LED colors.
+	/// Applies the configured color order to the LED colors.
 	///
-	/// @param ledColors The vector of LED colors to modify.
+	/// @param ledColors The LED colors to modify.
 	///
-	void applyColorOrder(QVector<ColorRgb>& ledColors) const;
+	void applyColorOrder(LedColorPlanes& ledColors) const;
 
 	///
 	/// Writes the final LED colors to the LED device.
 	/// This involves smoothing and throttling.
 	///
-	void writeToLeds();
+	/// @return True, if the colors were handed to the LED device or smoothing
+	///
+	bool writeToLeds();
+
+	///
+	/// Forces the next frame to be processed, even if it is unchanged.
+	/// To be called with the processing mutex held, whenever the processing state (layout, adjustments, mapping) changes.
+	///
+	void invalidateFrameFingerprint();
+
+	///
+	/// Processes a snapshot of the input for output (LED mapping, output stages, handoff to the LED device).
+	/// Runs on the processing thread, if enabled.
+	///
+	/// @param frame The input snapshot
+	///
+	void processFrame(ProcessingThread::Frame& frame);
+
+	///
+	/// (Re)creates or removes the dedicated processing thread as configured
+	///
+	/// @param smoothingConfig The smoothing configuration
+	///
+	void updateProcessingThread(const QJsonObject& smoothingConfig);
 
 	/// instance index
 	const quint8 _instIndex;
@@ -576,7 +630,8 @@ private:
 	/// The specifiation of the led frame construction and picture integration
 	LedString _ledString;
 
-	QVector<ColorOrder> _ledStringColorOrder;
+	/// The color order per LED of the layout
+	LedColorPlanes::ColorOrderMap _ledStringColorOrder;
 
 	/// Register that holds component states
 	QSharedPointer<ComponentRegister> _componentRegister;
@@ -624,12 +679,34 @@ private:
 
 	std::atomic<bool> _isUpdatePending{ false };
 	std::atomic<bool> _isUpdateQueued{ false };
+
+	/// Time the pending update was requested
+	std::chrono::steady_clock::time_point _updateRequested;
+
+	/// Held while a frame is processed and while the processing state (layout, adjustments, mapping) is changed
+	QMutex _processingMutex;
+
+	/// Latency from the update request to the start of processing and to the handoff of the LED colors
+	LatencyHistogram _queueLatency;
+	LatencyHistogram _totalLatency;
+
+	/// Dedicated output processing thread (if enabled), stopped before the state it processes is destroyed
+	std::unique_ptr<ProcessingThread> _processingThread;
 	
 	// buffer for leds (with adjustment)
 	QVector<ColorRgb> _ledBuffer;
 
+	// LED colors while being processed (blacklist, adjustment, color order)
+	LedColorPlanes _ledPlanes;
+
+	/// Fingerprint of the image last processed, 0 if the next frame must be processed
+	quint64 _lastFingerprint = 0;
+	/// True, if the LED colors of the last processed frame were handed to the LED device or smoothing
+	bool _isLastFrameDelivered = false;
+
 	/// statistics timer
 	QScopedPointer<QTimer> _statisticsTimer;
 	std::atomic<int> _totalImagesProcessed{ 0 };
 	std::atomic<int> _imagesSkipped{ 0 };
+	std::atomic<int> _imagesUnchanged{ 0 };
 };
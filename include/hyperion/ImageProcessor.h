@@ -1,5 +1,10 @@
 #pragma once
 
+// STL includes
+#include <memory>
+#include <type_traits>
+
+#include <QByteArray>
 #include <QString>
 #include <QVector>
 #include <QSharedPointer>
@@ -7,10 +12,12 @@
 
 // Utils includes
 #include <utils/Image.h>
+#include <utils/ImageAnalysisCache.h>
 
 // Hyperion includes
 #include <hyperion/LedString.h>
 #include <hyperion/ImageToLedsMap.h>
+#include <hyperion/IntegralImage.h>
 #include <utils/Logger.h>
 
 // settings
@@ -60,6 +67,12 @@ public:
 	/// Returns state of black border detector
 	bool blackBorderDetectorEnabled() const;
 
+	///
+	/// Returns, if processing the image last processed again would result in the same LED colors,
+	/// i.e. the black border detection does not track a border change and the dominant color advanced clusters converged
+	///
+	bool isSettled() const;
+
 	///
 	///  Factor to reduce the number of pixels evaluated during processing
 	///
@@ -82,6 +95,28 @@ public:
 	static int mappingTypeToInt(const QString& mappingType);
 	static QString mappingTypeToStr(int mappingType);
 
+	///
+	/// Returns the key identifying a mapping, mappings with the same key calculate identical LED colors for the same frame
+	///
+	/// @param[in] width                        The width of the image
+	/// @param[in] height                       The height of the image
+	/// @param[in] horizontalBorder             The size of the horizontal border
+	/// @param[in] verticalBorder               The size of the vertical border
+	/// @param[in] reducedPixelSetFactorFactor  Every "reducedPixelSetFactorFactor" pixel is evaluated
+	/// @param[in] accuracyLevel                The accuracy level
+	/// @param[in] leds                         The LEDs and their areas
+	///
+	static QByteArray mappingKey(int width, int height, int horizontalBorder, int verticalBorder,
+								 int reducedPixelSetFactorFactor, int accuracyLevel, const QVector<Led>& leds);
+
+	///
+	/// Returns the processing cost of the dominant color advanced (k-means) mapping collected since the last call
+	/// and resets it
+	///
+	/// @return The k-means statistics
+	///
+	hyperion::ImageToLedsMap::KMeansStatistics takeKMeansStatistics();
+
 	///
 	/// @brief Set the Hyperion::update() request LED mapping type. This type is used in favour of type set with setLedMappingType.
 	/// 	   If you don't want to force a mapType set this to -1 (user choice will be set)
@@ -138,30 +173,19 @@ public:
 			// Check black border detection
 			verifyBorder(image);
 
-			// Create a result vector and call the 'in place' function
-			switch (_mappingType)
+			// The k-means mappings are warm-started from the instance's previous frame, i.e. their result is instance specific
+			if constexpr (std::is_same_v<Pixel_T, ColorRgb>)
 			{
-			case 1:
-				colors = _imageToLedColors->getUniLedColor(image);
-				break;
-			case 2:
-				colors = _imageToLedColors->getMeanSqrtLedColor(image);
-				break;
-			case 3:
-				colors = _imageToLedColors->getDominantLedColor(image);
-				break;
-			case 4:
-				colors = _imageToLedColors->getDominantUniLedColor(image);
-				break;
-			case 5:
-				colors = _imageToLedColors->getDominantAdvLedColor(image);
-				break;
-			case 6:
-				colors = _imageToLedColors->getDominantAdvUniLedColor(image);
-				break;
-			default:
-				colors = _imageToLedColors->getMeanLedColor(image);
+				if (_mappingType != 5 && _mappingType != 6)
+				{
+					// Instances with an identical layout and mapping share the LED colors of the same frame
+					const QByteArray key = "leds/" + QByteArray::number(_mappingType) + '/' + _mappingKey;
+					colors = *ImageAnalysisCache::getInstance().get<QVector<ColorRgb>>(image, key, [&]() { return calculateLedColors(image); });
+					return colors;
+				}
 			}
+
+			colors = calculateLedColors(image);
 		}
 		else
 		{
@@ -212,6 +236,9 @@ public:
 			case 6:
 				_imageToLedColors->getDominantAdvUniLedColor(image, ledColors);
 				break;
+			case 7:
+				_imageToLedColors->getMeanLedColor(integralImage(image), ledColors);
+				break;
 
 			default:
 				_imageToLedColors->getMeanLedColor(image, ledColors);
@@ -236,6 +263,67 @@ public:
 
 private:
 
+	///
+	/// Determines the led colors of the image using the current mapping
+	///
+	/// @param[in] image  The image to translate to LED values
+	///
+	/// @return The color value per LED
+	///
+	template <typename Pixel_T>
+	QVector<ColorRgb> calculateLedColors(const Image<Pixel_T>& image)
+	{
+		switch (_mappingType)
+		{
+		case 1:
+			return _imageToLedColors->getUniLedColor(image);
+		case 2:
+			return _imageToLedColors->getMeanSqrtLedColor(image);
+		case 3:
+			return _imageToLedColors->getDominantLedColor(image);
+		case 4:
+			return _imageToLedColors->getDominantUniLedColor(image);
+		case 5:
+			return _imageToLedColors->getDominantAdvLedColor(image);
+		case 6:
+			return _imageToLedColors->getDominantAdvUniLedColor(image);
+		case 7:
+		{
+			QVector<ColorRgb> colors(_ledString.leds().size(), ColorRgb::BLACK);
+			_imageToLedColors->getMeanLedColor(integralImage(image), colors);
+			return colors;
+		}
+		default:
+			return _imageToLedColors->getMeanLedColor(image);
+		}
+	}
+
+	///
+	/// Returns the integral image of the given image, which is shared between instances for RGB images
+	///
+	/// @param[in] image  The image the integral image is built from
+	///
+	/// @return The integral image
+	///
+	template <typename Pixel_T>
+	const hyperion::IntegralImage& integralImage(const Image<Pixel_T>& image)
+	{
+		if constexpr (std::is_same_v<Pixel_T, ColorRgb>)
+		{
+			_sharedIntegralImage = ImageAnalysisCache::getInstance().get<hyperion::IntegralImage>(image, "integral", [&]() {
+				hyperion::IntegralImage integral;
+				integral.build(image);
+				return integral;
+			});
+			return *_sharedIntegralImage;
+		}
+		else
+		{
+			_integralImage.build(image);
+			return _integralImage;
+		}
+	}
+
 	void registerProcessingUnit(
 		int width,
 		int height,
@@ -297,6 +385,14 @@ private:
 	/// The mapping of image-pixels to LEDs
 	QSharedPointer<hyperion::ImageToLedsMap> _imageToLedColors;
 
+	/// The integral image of the current frame (integral mapping type only)
+	hyperion::IntegralImage _integralImage;
+	/// The integral image of the current frame shared with other instances (RGB images only)
+	std::shared_ptr<const hyperion::IntegralImage> _sharedIntegralImage;
+
+	/// Identifies the mapping's layout (size, borders, pixel set reduction, accuracy and LED areas)
+	QByteArray _mappingKey;
+
 	/// Type of image to LED mapping
 	int _mappingType;
 	/// Type of last requested user type
@@ -307,6 +403,9 @@ private:
 	int _accuracyLevel;
 	int _reducedPixelSetFactorFactor;
 
+	/// k-means statistics of mapping units already replaced
+	hyperion::ImageToLedsMap::KMeansStatistics _kmeansStatistics;
+
 	/// Hyperion instance pointer
 	QWeakPointer<Hyperion> _hyperionWeak;
 };
@@ -2,11 +2,16 @@
 #define IMAGETOLEDSMAP_H
 
 // STL includes
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <memory>
 #include <sstream>
 #include <cmath>
 #include <array>
+#include <type_traits>
+#include <vector>
 
 #include <QVector>
 
@@ -15,16 +20,53 @@
 #include <utils/Logger.h>
 #include <utils/ColorRgbScalar.h>
 #include <utils/ColorSys.h>
+#include <utils/PixelAccumulator.h>
+#include <utils/WorkerPool.h>
 #include <QLoggingCategory>
 
 // hyperion includes
 #include <hyperion/LedString.h>
+#include <hyperion/IntegralImage.h>
+#include <hyperion/DirtyBlocks.h>
 
 Q_DECLARE_LOGGING_CATEGORY(imageToLedsMap_calc);
 Q_DECLARE_LOGGING_CATEGORY(imageToLedsMap_calc);
 
 namespace hyperion
 {
+	///
+	/// A run of pixels sampled from a single row of a row-oriented image
+	///
+	struct PixelRun
+	{
+		/// Index of the first pixel of the run into the image data
+		int offset;
+		/// Number of pixels sampled in the run
+		int length;
+		/// Distance between two consecutive sampled pixels (1 = contiguous)
+		int stride;
+	};
+
+	///
+	/// The image area assigned to a single LED, stored as one run per sampled row.
+	/// The memory used is proportional to the number of rows and not to the number of pixels.
+	///
+	struct LedArea
+	{
+		/// The runs making up the area
+		QVector<PixelRun> runs;
+		/// The total number of pixels sampled for the area
+		int pixelCount {0};
+
+		/// The rectangle covered by the area (max values are exclusive)
+		int minX {0};
+		int minY {0};
+		int maxX {0};
+		int maxY {0};
+
+		bool isEmpty() const { return pixelCount == 0; }
+	};
+
 	///
 	/// The ImageToLedsMap holds a mapping of indices into an image to LEDs. It can be used to
 	/// calculate the average (aka mean) or dominant color per LED for a given region.
@@ -37,8 +79,8 @@ namespace hyperion
 	
 		///
 		/// Constructs an mapping from the absolute indices in an image to each LED based on the border
-		/// definition given in the list of LEDs. The map holds absolute indices to any given image,
-		/// provided that it is row-oriented.
+		/// definition given in the list of LEDs. The map holds runs of absolute indices (one per sampled row)
+		/// to any given image, provided that it is row-oriented.
 		/// The mapping is created purely on size (width and height). The given borders are excluded
 		/// from indexing.
 		///
@@ -86,6 +128,43 @@ namespace hyperion
 		/// @param[in] level  The accuracy level (0-4)
 		void setAccuracyLevel(int level);
 
+		///
+		/// Returns, if the clusters of all areas converged with the last dominant color advanced (k-means) calculation.
+		/// Otherwise, the calculation stopped at the iteration limit and continues to refine the LED colors of the same image.
+		///
+		bool isKMeansConverged() const { return _isKMeansConverged; }
+
+		///
+		/// Processing cost of the dominant color advanced (k-means) calculation
+		///
+		struct KMeansStatistics
+		{
+			/// Number of frames processed
+			quint64 frames {0};
+			/// Number of areas evaluated
+			quint64 areas {0};
+			/// Number of k-means iterations over all areas
+			quint64 iterations {0};
+			/// Total processing time
+			std::chrono::nanoseconds duration {0};
+
+			KMeansStatistics &operator+=(const KMeansStatistics &other)
+			{
+				frames += other.frames;
+				areas += other.areas;
+				iterations += other.iterations;
+				duration += other.duration;
+				return *this;
+			}
+		};
+
+		///
+		/// Returns the k-means statistics collected since the last call and resets them
+		///
+		/// @return The k-means statistics
+		///
+		KMeansStatistics takeKMeansStatistics();
+
 		///
 		/// Determines the mean color for each LED using the LED area mapping given
 		/// at construction.
@@ -121,16 +200,25 @@ namespace hyperion
 			}
 
 			// Iterate each led and compute the mean
-			auto led = ledColors.begin();
-			for (auto colors = _colorsMap.begin(); colors != _colorsMap.end(); ++colors, ++led)
-			{
-				const ColorRgb color = calcMeanColor(image, *colors);
-				*led = color;
-			}
+			ColorRgb *led = ledColors.data();
+			processChangedLeds(image, ColorSource::Mean, ledColors, [&](int index) {
+				led[index] = calcMeanColor(image, _colorsMap[index]);
+			});
 
 			qCDebug(imageToLedsMap_calc) << "Get Mean Color completed" << ledColors;
 		}
 
+		///
+		/// Determines the mean color for each LED using the LED area mapping given
+		/// at construction. Instead of evaluating the image pixels, each LED's rectangle
+		/// is looked-up in the integral image built for the current frame.
+		/// Areas are evaluated in full, i.e. a reduced pixel set factor is not applied.
+		///
+		/// @param[in] integralImage  The integral image of the frame from which to extract the LED colors
+		/// @param[out] ledColors  The vector containing the output
+		///
+		void getMeanLedColor(const IntegralImage &integralImage, QVector<ColorRgb> &ledColors) const;
+
 		///
 		/// Determines the mean color squared for each LED using the LED area mapping given
 		/// at construction.
@@ -166,12 +254,10 @@ namespace hyperion
 			}
 
 			// Iterate each led and compute the mean
-			auto led = ledColors.begin();
-			for (auto colors = _colorsMap.begin(); colors != _colorsMap.end(); ++colors, ++led)
-			{
-				const ColorRgb color = calcMeanColorSqrt(image, *colors);
-				*led = color;
-			}
+			ColorRgb *led = ledColors.data();
+			processChangedLeds(image, ColorSource::MeanSqrt, ledColors, [&](int index) {
+				led[index] = calcMeanColorSqrt(image, _colorsMap[index]);
+			});
 		}
 
 		///
@@ -248,12 +334,10 @@ namespace hyperion
 			}
 
 			// Iterate each led and compute the dominant color
-			auto led = ledColors.begin();
-			for (auto colors = _colorsMap.begin(); colors != _colorsMap.end(); ++colors, ++led)
-			{
-				const ColorRgb color = calculateDominantColor(image, *colors);
-				*led = color;
-			}
+			ColorRgb *led = ledColors.data();
+			processChangedLeds(image, ColorSource::Dominant, ledColors, [&](int index) {
+				led[index] = calculateDominantColor(image, _colorsMap[index]);
+			});
 		}
 
 		///
@@ -329,13 +413,33 @@ namespace hyperion
 				return;
 			}
 
-			// Iterate each led and compute the dominant color
-			auto led = ledColors.begin();
-			for (auto colors = _colorsMap.begin(); colors != _colorsMap.end(); ++colors, ++led)
+			const auto start = std::chrono::steady_clock::now();
+			if (_kmeansStates.size() != _colorsMap.size())
 			{
-				const ColorRgb color = calculateDominantColorAdv(image, *colors);
-				*led = color;
+				_kmeansStates.resize(_colorsMap.size());
 			}
+
+			// Iterate each led and compute the dominant color, continuing from the led's clusters of the previous frame
+			std::atomic<int> iterations {0};
+			std::atomic<int> areas {0};
+			std::atomic<int> unconvergedAreas {0};
+			ColorRgb *led = ledColors.data();
+			KMeansState *state = _kmeansStates.data();
+
+			// The colors of unchanged areas are only final, if their clusters converged
+			processChangedLeds(image, ColorSource::DominantAdv, ledColors, [&](int index) {
+				int ledIterations = 0;
+				led[index] = calculateDominantColorAdv(image, _colorsMap[index], state[index], ledIterations);
+				iterations.fetch_add(ledIterations, std::memory_order_relaxed);
+				areas.fetch_add(1, std::memory_order_relaxed);
+				if (!state[index].isConverged)
+				{
+					unconvergedAreas.fetch_add(1, std::memory_order_relaxed);
+				}
+			}, _isKMeansConverged);
+
+			_isKMeansConverged = (unconvergedAreas.load() == 0);
+			updateKMeansStatistics(areas.load(), iterations.load(), std::chrono::steady_clock::now() - start);
 		}
 
 		///
@@ -370,10 +474,16 @@ namespace hyperion
 				return;
 			}
 
+			const auto start = std::chrono::steady_clock::now();
+
 			// calculate dominant color
-			const ColorRgb color = calculateDominantColorAdv(image);
+			int iterations = 0;
+			const ColorRgb color = calculateDominantColorAdv(image, wholeImageArea(image), _kmeansUniState, iterations);
 			// Update all LEDs with same color
 			std::fill(ledColors.begin(), ledColors.end(), color);
+
+			_isKMeansConverged = _kmeansUniState.isConverged;
+			updateKMeansStatistics(1, iterations, std::chrono::steady_clock::now() - start);
 		}
 
 	private:
@@ -392,24 +502,209 @@ namespace hyperion
 
 		/// Number of clusters used during dominant color advanced processing (k-means)
 		int _clusterCount;
+		/// Maximum number of pixels per area evaluated during dominant color advanced processing (0 = all)
+		int _kmeansSampleLimit;
 
-		/// The absolute indices into the image for each led
-		QVector<QVector<int>> _colorsMap;
+		/// Number of bits per color channel used to quantize colors during dominant color processing
+		int _histogramBits;
+
+		/// The image area (as runs of pixels) for each led
+		QVector<LedArea> _colorsMap;
+
+		/// The total number of pixels evaluated over all LED areas
+		qint64 _totalPixelCount;
+
+		/// Minimum number of pixels to be evaluated per frame before LEDs are processed in parallel
+		static constexpr qint64 PARALLEL_PIXEL_THRESHOLD = 16384;
+
+		///
+		/// The calculation the LED colors of the previous frame were determined with
+		///
+		enum class ColorSource
+		{
+			None,
+			Mean,
+			MeanSqrt,
+			Dominant,
+			DominantAdv
+		};
+
+		/// The blocks of the image covered by LED areas, which changed since the previous frame
+		mutable DirtyBlocks _dirtyBlocks;
+		/// The LED colors of the previous frame
+		mutable QVector<ColorRgb> _previousColors;
+		/// The calculation of the LED colors of the previous frame
+		mutable ColorSource _previousColorSource;
+
+		///
+		/// Calls the given function for every LED index. If the LED areas cover enough pixels,
+		/// the LEDs are split into chunks and processed in parallel on the process-wide worker pool.
+		/// The function must only write results of the given LED.
+		///
+		/// @param[in] func The function to be called per LED index
+		///
+		template <typename Func>
+		void processLeds(Func func) const
+		{
+			const int ledCount = static_cast<int>(_colorsMap.size());
+			WorkerPool &pool = WorkerPool::instance();
+			if (_totalPixelCount < PARALLEL_PIXEL_THRESHOLD || ledCount < 2 || pool.threadCount() < 2)
+			{
+				for (int index = 0; index < ledCount; ++index)
+				{
+					func(index);
+				}
+				return;
+			}
+
+			// Several chunks per thread, so that threads finishing early can take over remaining work
+			const int chunkSize = std::max(1, ledCount / (pool.threadCount() * 4));
+			pool.run(ledCount, chunkSize, [&func](int begin, int end) {
+				for (int index = begin; index < end; ++index)
+				{
+					func(index);
+				}
+			});
+		}
+
+		///
+		/// Calls the given function for every LED index, whose area intersects a block changed since the previous frame.
+		/// The other LEDs keep their color of the previous frame, if it was determined the same way.
+		/// Only RGB images are tracked, the function is called for every LED index for other pixel types.
+		///
+		/// @param[in] image The image to be processed
+		/// @param[in] source The calculation the function performs
+		/// @param[in,out] ledColors The LED colors written by the function
+		/// @param[in] func The function to be called per LED index
+		/// @param[in] isReusable False, if the colors of the previous frame must not be kept (e.g. are not final)
+		///
+		template <typename Pixel_T, typename Func>
+		void processChangedLeds(const Image<Pixel_T> &image, ColorSource source, QVector<ColorRgb> &ledColors, Func func, bool isReusable = true) const
+		{
+			if constexpr (std::is_same_v<Pixel_T, ColorRgb>)
+			{
+				const bool isTracked = _dirtyBlocks.update(image) && isReusable && _previousColorSource == source && _previousColors.size() == ledColors.size();
+
+				ColorRgb *led = ledColors.data();
+				const ColorRgb *previous = _previousColors.constData();
+				processLeds([&](int index) {
+					const LedArea &area = _colorsMap[index];
+					if (isTracked && !_dirtyBlocks.isDirty(area.minX, area.minY, area.maxX, area.maxY))
+					{
+						led[index] = previous[index];
+					}
+					else
+					{
+						func(index);
+					}
+				});
+
+				qCDebug(imageToLedsMap_calc) << "Changed blocks:" << (isTracked ? _dirtyBlocks.dirtyCount() : _dirtyBlocks.watchedCount()) << "of" << _dirtyBlocks.watchedCount();
+
+				_previousColors = ledColors;
+				_previousColorSource = source;
+			}
+			else
+			{
+				processLeds(func);
+			}
+		}
+
+		///
+		/// Returns the calling thread's histogram buffer for the dominant color calculation.
+		/// All bins are zero, callers have to reset the bins they used.
+		///
+		/// @param[in] binCount The number of bins required
+		///
+		/// @return The histogram buffer
+		///
+		static uint32_t *histogramBuffer(size_t binCount)
+		{
+			thread_local std::vector<uint32_t> histogram;
+			if (histogram.size() < binCount)
+			{
+				histogram.assign(binCount, 0);
+			}
+			return histogram.data();
+		}
+
+		///
+		/// Returns the calling thread's list to track the histogram bins used by a calculation
+		///
+		/// @return The list of used bins
+		///
+		static std::vector<uint32_t> &histogramBinsUsed()
+		{
+			thread_local std::vector<uint32_t> binsUsed;
+			return binsUsed;
+		}
+
+		///
+		/// Returns an area covering all pixels of the given image as a single contiguous run
+		///
+		/// @param[in] image The image to be covered
+		///
+		/// @return The area covering the whole image
+		///
+		template <typename Pixel_T>
+		static LedArea wholeImageArea(const Image<Pixel_T> &image)
+		{
+			const int pixelNum = image.width() * image.height();
+			LedArea area;
+			if (pixelNum > 0)
+			{
+				area.runs.append({0, pixelNum, 1});
+				area.pixelCount = pixelNum;
+			}
+			return area;
+		}
+
+		///
+		/// Calls the given function for every pixel of an LED area.
+		/// Contiguous runs are streamed sequentially, so the compiler can vectorize the accumulation.
+		///
+		/// @param[in] image The image the area refers to
+		/// @param[in] area The LED area to be evaluated
+		/// @param[in] func The function to be called per pixel
+		///
+		template <typename Pixel_T, typename Func>
+		static void forEachPixel(const Image<Pixel_T> &image, const LedArea &area, Func func)
+		{
+			const Pixel_T *imgData = image.memptr();
+			for (const PixelRun &run : area.runs)
+			{
+				const Pixel_T *pixel = imgData + run.offset;
+				if (run.stride == 1)
+				{
+					for (const Pixel_T *const end = pixel + run.length; pixel != end; ++pixel)
+					{
+						func(*pixel);
+					}
+				}
+				else
+				{
+					for (int i = 0; i < run.length; ++i, pixel += run.stride)
+					{
+						func(*pixel);
+					}
+				}
+			}
+		}
 
 		///
 		/// Calculates the 'mean color' over the given image. This is the mean over each color-channel
 		/// (red, green, blue)
 		///
 		/// @param[in] image The image a section from which an average color must be computed
-		/// @param[in] pixels The list of pixel indices for the given image to be evaluated///
+		/// @param[in] area The LED area of the given image to be evaluated
 		///
 		/// @return The mean of the given list of colors (or black when empty)
 		///
 		template <typename Pixel_T>
-		ColorRgb calcMeanColor(const Image<Pixel_T> &image, const QVector<int32_t> &pixels) const
+		ColorRgb calcMeanColor(const Image<Pixel_T> &image, const LedArea &area) const
 		{
-			qCDebug(imageToLedsMap_calc) << "Calculate Mean Color on image sized" << image.width() << "x" << image.height() << "and #pixels" << pixels.size();
-			const auto pixelNum = pixels.size();
+			qCDebug(imageToLedsMap_calc) << "Calculate Mean Color on image sized" << image.width() << "x" << image.height() << "and #pixels" << area.pixelCount;
+			const auto pixelNum = static_cast<uint_fast32_t>(area.pixelCount);
 			if (pixelNum == 0)
 			{
 				return ColorRgb::BLACK;
@@ -420,13 +715,26 @@ namespace hyperion
 			uint_fast32_t cummGreen = 0;
 			uint_fast32_t cummBlue = 0;
 
-			const auto &imgData = image.memptr();
-			for (const int pixelOffset : pixels)
+			if constexpr (std::is_same_v<Pixel_T, ColorRgb>)
 			{
-				const auto &pixel = imgData[pixelOffset];
-				cummRed += pixel.red;
-				cummGreen += pixel.green;
-				cummBlue += pixel.blue;
+				// Use the vectorized kernels for packed RGB24 images
+				PixelAccumulator::Sums sums;
+				const ColorRgb *imgData = image.memptr();
+				for (const PixelRun &run : area.runs)
+				{
+					PixelAccumulator::sum(imgData + run.offset, run.length, run.stride, sums);
+				}
+				cummRed = sums.red;
+				cummGreen = sums.green;
+				cummBlue = sums.blue;
+			}
+			else
+			{
+				forEachPixel(image, area, [&](const Pixel_T &pixel) {
+					cummRed += pixel.red;
+					cummGreen += pixel.green;
+					cummBlue += pixel.blue;
+				});
 			}
 
 			// Compute the average of each color channel
@@ -480,15 +788,15 @@ namespace hyperion
 		/// (red, green, blue)
 		///
 		/// @param[in] image The image a section from which an average color must be computed
-		/// @param[in] pixels The list of pixel indices for the given image to be evaluated
+		/// @param[in] area The LED area of the given image to be evaluated
 		///
 		/// @return The mean of the given list of colors (or black when empty)
 		///
 		template <typename Pixel_T>
-		ColorRgb calcMeanColorSqrt(const Image<Pixel_T> &image, const QVector<int32_t> &pixels) const
+		ColorRgb calcMeanColorSqrt(const Image<Pixel_T> &image, const LedArea &area) const
 		{
-			qCDebug(imageToLedsMap_calc) << "Calculate Mean Color Squared on image sized" << image.width() << "x" << image.height() << "and #pixels" << pixels.size();
-			const auto pixelNum = pixels.size();
+			qCDebug(imageToLedsMap_calc) << "Calculate Mean Color Squared on image sized" << image.width() << "x" << image.height() << "and #pixels" << area.pixelCount;
+			const auto pixelNum = static_cast<uint_fast32_t>(area.pixelCount);
 			if (pixelNum == 0)
 			{
 				return ColorRgb::BLACK;
@@ -499,15 +807,26 @@ namespace hyperion
 			uint_fast32_t cummGreen = 0;
 			uint_fast32_t cummBlue = 0;
 
-			const auto &imgData = image.memptr();
-
-			for (const int colorOffset : pixels)
+			if constexpr (std::is_same_v<Pixel_T, ColorRgb>)
 			{
-				const auto &pixel = imgData[colorOffset];
-
-				cummRed += pixel.red * pixel.red;
-				cummGreen += pixel.green * pixel.green;
-				cummBlue += pixel.blue * pixel.blue;
+				// Use the vectorized kernels for packed RGB24 images
+				PixelAccumulator::Sums sums;
+				const ColorRgb *imgData = image.memptr();
+				for (const PixelRun &run : area.runs)
+				{
+					PixelAccumulator::sumSquared(imgData + run.offset, run.length, run.stride, sums);
+				}
+				cummRed = sums.red;
+				cummGreen = sums.green;
+				cummBlue = sums.blue;
+			}
+			else
+			{
+				forEachPixel(image, area, [&](const Pixel_T &pixel) {
+					cummRed += pixel.red * pixel.red;
+					cummGreen += pixel.green * pixel.green;
+					cummBlue += pixel.blue * pixel.blue;
+				});
 			}
 
 			// Compute the average of each color channel
@@ -561,47 +880,76 @@ namespace hyperion
 		}
 
 		///
-		/// Calculates the 'dominant color' of an image area defined by a list of pixel indices
+		/// Calculates the 'dominant color' of an image area.
+		/// Colors are quantized to the configured number of bits per channel and counted in a flat histogram.
+		/// The dominant color is the mean of all pixels falling into the most frequent histogram bin.
 		///
 		/// @param[in] image The image for which a dominant color is to be computed
-		/// @param[in] pixels The list of pixel indices for the given image to be evaluated
+		/// @param[in] area The LED area of the given image to be evaluated
 		///
-		/// @return The image area's dominant color or black, if no pixel indices provided
+		/// @return The image area's dominant color or black, if the area is empty
 		///
 		template <typename Pixel_T>
-		ColorRgb calculateDominantColor(const Image<Pixel_T> &image, const QVector<int> &pixels) const
+		ColorRgb calculateDominantColor(const Image<Pixel_T> &image, const LedArea &area) const
 		{
-			qCDebug(imageToLedsMap_calc) << "Calculate Dominant Color on image sized" << image.width() << "x" << image.height() << "and #pixels" << pixels.size();
-			ColorRgb dominantColor{ColorRgb::BLACK};
-
-			const auto pixelNum = pixels.size();
-			if (pixelNum > 0)
+			qCDebug(imageToLedsMap_calc) << "Calculate Dominant Color on image sized" << image.width() << "x" << image.height() << "and #pixels" << area.pixelCount;
+			if (area.isEmpty())
 			{
-				const auto &imgData = image.memptr();
+				return ColorRgb::BLACK;
+			}
 
-				QMap<QRgb, int> colorDistributionMap;
-				int count = 0;
-				for (const int pixelOffset : pixels)
+			const int bits = _histogramBits;
+			const int shift = 8 - bits;
+			const auto toBin = [bits, shift](const Pixel_T &pixel) -> uint32_t {
+				return (static_cast<uint32_t>(pixel.red >> shift) << (2 * bits)) |
+					   (static_cast<uint32_t>(pixel.green >> shift) << bits) |
+					   static_cast<uint32_t>(pixel.blue >> shift);
+			};
+
+			// Count the quantized colors and track the most frequent one
+			std::vector<uint32_t> &binsUsed = histogramBinsUsed();
+			uint32_t *histogram = histogramBuffer(size_t(1) << (3 * bits));
+			uint32_t maxCount = 0;
+			uint32_t dominantBin = 0;
+			forEachPixel(image, area, [&](const Pixel_T &pixel) {
+				const uint32_t bin = toBin(pixel);
+				uint32_t &count = histogram[bin];
+				if (count == 0)
 				{
-					QRgb color = imgData[pixelOffset].rgb();
-					if (colorDistributionMap.contains(color))
-					{
-						colorDistributionMap[color] = colorDistributionMap[color] + 1;
-					}
-					else
-					{
-						colorDistributionMap[color] = 1;
-					}
-
-					int colorsFound = colorDistributionMap[color];
-					if (colorsFound > count)
-					{
-						dominantColor.setRgb(color);
-						count = colorsFound;
-					}
+					binsUsed.push_back(bin);
 				}
+				if (++count > maxCount)
+				{
+					maxCount = count;
+					dominantBin = bin;
+				}
+			});
+
+			// Only reset the bins used, to keep the cost independent of the histogram's size
+			for (const uint32_t bin : binsUsed)
+			{
+				histogram[bin] = 0;
 			}
-			return dominantColor;
+			binsUsed.clear();
+
+			// Determine the mean of the colors quantized into the dominant bin
+			uint_fast32_t cummRed = 0;
+			uint_fast32_t cummGreen = 0;
+			uint_fast32_t cummBlue = 0;
+			forEachPixel(image, area, [&](const Pixel_T &pixel) {
+				if (toBin(pixel) == dominantBin)
+				{
+					cummRed += pixel.red;
+					cummGreen += pixel.green;
+					cummBlue += pixel.blue;
+				}
+			});
+
+			return {
+				static_cast<uint8_t>(cummRed / maxCount),
+				static_cast<uint8_t>(cummGreen / maxCount),
+				static_cast<uint8_t>(cummBlue / maxCount)
+			};
 		}
 
 		///
@@ -615,152 +963,155 @@ namespace hyperion
 		ColorRgb calculateDominantColor(const Image<Pixel_T> &image) const
 		{
 			qCDebug(imageToLedsMap_calc) << "Calculate Dominant Color on image sized" << image.width() << "x" << image.height();
-			const unsigned pixelNum = image.width() * image.height();
-
-			QVector<int> pixels(pixelNum);
-			std::iota(pixels.begin(), pixels.end(), 0);
-
-			return calculateDominantColor(image, pixels);
+			return calculateDominantColor(image, wholeImageArea(image));
 		}
 
-		template <typename Pixel_T>
-		struct ColorCluster
-		{
-
-			ColorCluster() = default;
-			explicit ColorCluster(Pixel_T color) : color(color) {}
-
-			Pixel_T color;
-			Pixel_T newColor;
-			int count{0};
-		};
 		const std::array<ColorRgb, 5> DEFAULT_CLUSTER_COLORS{{{ColorRgb::BLACK},
 															  {ColorRgb::GREEN},
 															  {ColorRgb::WHITE},
 															  {ColorRgb::RED},
 															  {ColorRgb::YELLOW}}};
 
+		/// Upper bound of k-means iterations per area and frame
+		static constexpr int KMEANS_MAX_ITERATIONS = 8;
+		/// Clusters are considered converged, if no centroid moved by more than this squared distance
+		static constexpr int KMEANS_CONVERGENCE_DISTANCE = 2;
+
+		///
+		/// Cluster centroids of an area, kept between frames to warm-start the k-means algorithm
+		///
+		struct KMeansState
+		{
+			std::array<ColorRgb, 5> centroids;
+			/// Number of valid centroids (0 = not initialised yet)
+			int clusterCount {0};
+			/// The centroids converged within the iteration limit
+			bool isConverged {false};
+		};
+
+		/// The k-means state per LED area
+		mutable QVector<KMeansState> _kmeansStates;
+		/// The k-means state for the whole image (unicolor)
+		mutable KMeansState _kmeansUniState;
+		/// The k-means statistics since they were taken last
+		mutable KMeansStatistics _kmeansStatistics;
+		/// The clusters of all areas converged with the last k-means calculation
+		mutable bool _isKMeansConverged;
+
+		///
+		/// Adds the cost of a single frame to the k-means statistics
+		///
+		/// @param[in] areas The number of areas evaluated
+		/// @param[in] iterations The total number of iterations over all areas
+		/// @param[in] duration The processing time of the frame
+		///
+		void updateKMeansStatistics(int areas, int iterations, std::chrono::nanoseconds duration) const;
+
+		static int squaredDistance(int red, int green, int blue, const ColorRgb &color)
+		{
+			const int deltaRed = red - color.red;
+			const int deltaGreen = green - color.green;
+			const int deltaBlue = blue - color.blue;
+			return deltaRed * deltaRed + deltaGreen * deltaGreen + deltaBlue * deltaBlue;
+		}
+
 		///
-		/// Calculates the 'dominant color' of an image area defined by a list of pixel indices
+		/// Calculates the 'dominant color' of an image area
 		/// using a k-means algorithm (https://robocraft.ru/computervision/1063)
 		///
+		/// The clusters are warm-started from the centroids of the previous frame, the number of iterations is bounded
+		/// and distances are calculated as integer squared distances. Large areas are subsampled to the configured sample limit.
+		///
 		/// @param[in] image The image for which a dominant color is to be computed
-		/// @param[in] pixels The list of pixel indices for the given image to be evaluated
+		/// @param[in] area The LED area of the given image to be evaluated
+		/// @param[in,out] state The area's clusters of the previous frame, updated with the current result
+		/// @param[in,out] iterations The number of k-means iterations, incremented by the iterations performed
 		///
-		/// @return The image area's dominant color or black, if no pixel indices provided
+		/// @return The image area's dominant color or black, if the area is empty
 		///
 		template <typename Pixel_T>
-		ColorRgb calculateDominantColorAdv(const Image<Pixel_T> &image, const QVector<int> &pixels) const
+		ColorRgb calculateDominantColorAdv(const Image<Pixel_T> &image, const LedArea &area, KMeansState &state, int &iterations) const
 		{
-			qCDebug(imageToLedsMap_calc) << "Calculate Dominant Color Advanced on image sized" << image.width() << "x" << image.height() << "and #pixels" << pixels.size();
-			ColorRgb dominantColor{ColorRgb::BLACK};
-			const auto pixelNum = pixels.size();
-			if (pixelNum > 0)
+			qCDebug(imageToLedsMap_calc) << "Calculate Dominant Color Advanced on image sized" << image.width() << "x" << image.height() << "and #pixels" << area.pixelCount;
+			if (area.isEmpty())
 			{
-				// initial cluster with different colors
-				auto clusters(std::make_unique<ColorCluster<ColorRgbScalar>[]>(_clusterCount));
-				for (int k = 0; k < _clusterCount; ++k)
-				{
-					clusters.get()[k].newColor = DEFAULT_CLUSTER_COLORS[k];
-				}
-
-				// k-means
-				double min_rgb_euclidean{0};
-				double old_rgb_euclidean{0};
+				state.isConverged = true;
+				return ColorRgb::BLACK;
+			}
 
-				while (true)
-				{
-					for (int k = 0; k < _clusterCount; ++k)
-					{
-						clusters.get()[k].count = 0;
-						clusters.get()[k].color = clusters.get()[k].newColor;
-						clusters.get()[k].newColor.setRgb(ColorRgb::BLACK);
-					}
+			const int clusterCount = _clusterCount;
+			if (state.clusterCount != clusterCount)
+			{
+				// (Re-)start from the default cluster colors
+				std::copy(DEFAULT_CLUSTER_COLORS.begin(), DEFAULT_CLUSTER_COLORS.end(), state.centroids.begin());
+				state.clusterCount = clusterCount;
+			}
 
-					const auto &imgData = image.memptr();
-					for (const int pixelOffset : pixels)
-					{
-						const auto &pixel = imgData[pixelOffset];
+			// Evaluate every "sampleStep" pixel only, if the area exceeds the sample limit
+			const int sampleStep = (_kmeansSampleLimit > 0 && area.pixelCount > _kmeansSampleLimit)
+									   ? (area.pixelCount + _kmeansSampleLimit - 1) / _kmeansSampleLimit
+									   : 1;
 
-						min_rgb_euclidean = 255 * 255 * 255;
-						int clusterIndex = -1;
-						for (int k = 0; k < _clusterCount; ++k)
-						{
-							double euclid = ColorSys::rgb_euclidean(ColorRgbScalar(pixel), clusters.get()[k].color);
+			std::array<uint32_t, 5> counts {};
+			std::array<std::array<uint32_t, 3>, 5> sums {};
 
-							if (euclid < min_rgb_euclidean)
-							{
-								min_rgb_euclidean = euclid;
-								clusterIndex = k;
-							}
-						}
+			state.isConverged = false;
+			for (int iteration = 0; iteration < KMEANS_MAX_ITERATIONS; ++iteration)
+			{
+				counts.fill(0);
+				sums.fill({0, 0, 0});
 
-						clusters.get()[clusterIndex].count++;
-						clusters.get()[clusterIndex].newColor += ColorRgbScalar(pixel);
+				// Assign each pixel to its nearest cluster
+				int sample = 0;
+				forEachPixel(image, area, [&](const Pixel_T &pixel) {
+					if (sampleStep > 1 && (sample++ % sampleStep) != 0)
+					{
+						return;
 					}
 
-					min_rgb_euclidean = 0;
-					for (int k = 0; k < _clusterCount; ++k)
+					int clusterIndex = 0;
+					int minDistance = squaredDistance(pixel.red, pixel.green, pixel.blue, state.centroids[0]);
+					for (int k = 1; k < clusterCount; ++k)
 					{
-						if (clusters.get()[k].count > 0)
+						const int distance = squaredDistance(pixel.red, pixel.green, pixel.blue, state.centroids[k]);
+						if (distance < minDistance)
 						{
-							// new color
-							clusters.get()[k].newColor /= clusters.get()[k].count;
-							double ecli = ColorSys::rgb_euclidean(clusters.get()[k].newColor, clusters.get()[k].color);
-							if (ecli > min_rgb_euclidean)
-							{
-								min_rgb_euclidean = ecli;
-							}
+							minDistance = distance;
+							clusterIndex = k;
 						}
 					}
 
-					if (fabs(min_rgb_euclidean - old_rgb_euclidean) < 1)
-					{
-						break;
-					}
+					++counts[clusterIndex];
+					sums[clusterIndex][0] += pixel.red;
+					sums[clusterIndex][1] += pixel.green;
+					sums[clusterIndex][2] += pixel.blue;
+				});
 
-					old_rgb_euclidean = min_rgb_euclidean;
-				}
+				++iterations;
 
-				int colorsFoundMax = 0;
-				int dominantClusterIdx{0};
-
-				for (int clusterIdx = 0; clusterIdx < _clusterCount; ++clusterIdx)
+				// Move the centroids to the mean of their pixels, empty clusters keep their centroid
+				int maxMovement = 0;
+				for (int k = 0; k < clusterCount; ++k)
 				{
-					int colorsFoundinCluster = clusters.get()[clusterIdx].count;
-					if (colorsFoundinCluster > colorsFoundMax)
+					if (counts[k] > 0)
 					{
-						colorsFoundMax = colorsFoundinCluster;
-						dominantClusterIdx = clusterIdx;
+						const int red = static_cast<int>(sums[k][0] / counts[k]);
+						const int green = static_cast<int>(sums[k][1] / counts[k]);
+						const int blue = static_cast<int>(sums[k][2] / counts[k]);
+						maxMovement = std::max(maxMovement, squaredDistance(red, green, blue, state.centroids[k]));
+						state.centroids[k] = ColorRgb(static_cast<uint8_t>(red), static_cast<uint8_t>(green), static_cast<uint8_t>(blue));
 					}
 				}
 
-				dominantColor.red = static_cast<uint8_t>(clusters.get()[dominantClusterIdx].newColor.red);
-				dominantColor.green = static_cast<uint8_t>(clusters.get()[dominantClusterIdx].newColor.green);
-				dominantColor.blue = static_cast<uint8_t>(clusters.get()[dominantClusterIdx].newColor.blue);
+				if (maxMovement <= KMEANS_CONVERGENCE_DISTANCE)
+				{
+					state.isConverged = true;
+					break;
+				}
 			}
 
-			return dominantColor;
-		}
-
-		///
-		/// Calculates the 'dominant color' of an image area defined by a list of pixel indices
-		/// using a k-means algorithm (https://robocraft.ru/computervision/1063)
-		///
-		/// @param[in] image The image for which a dominant color is to be computed
-		///
-		/// @return The image's dominant color
-		///
-		template <typename Pixel_T>
-		ColorRgb calculateDominantColorAdv(const Image<Pixel_T> &image) const
-		{
-			qCDebug(imageToLedsMap_calc) << "Calculate Dominant Color Advanced on image sized" << image.width() << "x" << image.height();
-			const unsigned pixelNum = image.width() * image.height();
-
-			QVector<int> pixels(pixelNum);
-			std::iota(pixels.begin(), pixels.end(), 0);
-
-			return calculateDominantColorAdv(image, pixels);
+			const auto dominantCluster = std::max_element(counts.begin(), counts.begin() + clusterCount);
+			return state.centroids[static_cast<size_t>(std::distance(counts.begin(), dominantCluster))];
 		}
 	};
 
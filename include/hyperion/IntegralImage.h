@@ -0,0 +1,113 @@
+#ifndef INTEGRALIMAGE_H
+#define INTEGRALIMAGE_H
+
+// STL includes
+#include <cstdint>
+#include <vector>
+
+// hyperion-utils includes
+#include <utils/Image.h>
+#include <utils/ColorRgb.h>
+
+namespace hyperion
+{
+	///
+	/// The IntegralImage (aka summed-area table) holds, per color channel, the sum of all pixels above and
+	/// left of every image position. Once built for a frame, the mean color of any rectangular area
+	/// can be determined by four lookups, independent of the size of the area.
+	///
+	/// The sums are stored as unsigned 32-bit values. Overflows of the table cancel out when computing an area,
+	/// as long as the sum of a single area fits into 32-bit (i.e. areas of up to 16 million pixels).
+	///
+	class IntegralImage
+	{
+	public:
+		IntegralImage();
+
+		///
+		/// Builds the integral image for the given image.
+		/// Memory is only re-allocated if the image's size changed.
+		///
+		/// @param[in] image  The image the table is built for
+		///
+		template <typename Pixel_T>
+		void build(const Image<Pixel_T> &image)
+		{
+			resize(image.width(), image.height());
+
+			const int stride = _width + 1;
+			const Pixel_T *pixel = image.memptr();
+
+			// Row 0 and column 0 stay zero, so every area can be calculated without boundary checks
+			for (int y = 0; y < _height; ++y)
+			{
+				const ChannelSums *above = &_sums[static_cast<size_t>(y) * stride + 1];
+				ChannelSums *current = &_sums[static_cast<size_t>(y + 1) * stride + 1];
+
+				uint32_t rowRed = 0;
+				uint32_t rowGreen = 0;
+				uint32_t rowBlue = 0;
+				for (int x = 0; x < _width; ++x, ++pixel)
+				{
+					rowRed += pixel->red;
+					rowGreen += pixel->green;
+					rowBlue += pixel->blue;
+
+					current[x].red = above[x].red + rowRed;
+					current[x].green = above[x].green + rowGreen;
+					current[x].blue = above[x].blue + rowBlue;
+				}
+			}
+		}
+
+		///
+		/// Determines the mean color of a rectangular image area.
+		///
+		/// @param[in] minX  First column of the area
+		/// @param[in] minY  First row of the area
+		/// @param[in] maxX  Column following the last column of the area
+		/// @param[in] maxY  Row following the last row of the area
+		///
+		/// @return The mean color of the area (or black when empty)
+		///
+		ColorRgb meanColor(int minX, int minY, int maxX, int maxY) const;
+
+		///
+		/// Returns the width of the image the table was built for
+		///
+		int width() const { return _width; }
+
+		///
+		/// Returns the height of the image the table was built for
+		///
+		int height() const { return _height; }
+
+	private:
+
+		struct ChannelSums
+		{
+			uint32_t red;
+			uint32_t green;
+			uint32_t blue;
+		};
+
+		///
+		/// Resizes the table to the given image dimensions
+		///
+		/// @param[in] width   The width of the image
+		/// @param[in] height  The height of the image
+		///
+		void resize(int width, int height);
+
+		/// The width of the image the table was built for
+		int _width;
+		/// The height of the image the table was built for
+		int _height;
+
+		/// The summed-area table of size (width+1) x (height+1)
+		std::vector<ChannelSums> _sums;
+	};
+
+} // end namespace hyperion
+
+#endif // INTEGRALIMAGE_H
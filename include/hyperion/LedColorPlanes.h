@@ -0,0 +1,116 @@
+#ifndef LEDCOLORPLANES_H
+#define LEDCOLORPLANES_H
+
+// STL includes
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <QVector>
+
+// Utils includes
+#include <utils/ColorRgb.h>
+
+// Hyperion includes
+#include <hyperion/LedString.h>
+
+///
+/// LED colors stored as separate, aligned red, green and blue planes (structure of arrays).
+///
+/// The LED output stages (blacklist, color adjustment, color order) operate on whole planes, so that they can be
+/// processed by vector instructions. The colors are converted from and to ColorRgb only at the boundaries of the
+/// pipeline (raw LED colors in, LED device buffer out).
+///
+class LedColorPlanes
+{
+public:
+	enum Channel
+	{
+		RED = 0,
+		GREEN = 1,
+		BLUE = 2
+	};
+
+	///
+	/// The color order per LED, prepared for applying it to whole planes
+	///
+	class ColorOrderMap
+	{
+	public:
+		ColorOrderMap() = default;
+
+		///
+		/// @param colorOrders The color order per LED
+		///
+		explicit ColorOrderMap(const QVector<ColorOrder>& colorOrders);
+
+		/// @return The number of LEDs the map is defined for
+		int size() const { return _size; }
+
+	private:
+		friend class LedColorPlanes;
+
+		int _size {0};
+
+		/// All LEDs have the same color order, i.e. it is applied by exchanging planes
+		bool _isUniform {true};
+		/// Source channel per output channel of the uniform order
+		std::array<int, 3> _uniformSource {{RED, GREEN, BLUE}};
+
+		/// Per output and source channel, 0xFF for the LEDs taking the output channel from the source channel
+		std::array<std::array<std::vector<uint8_t>, 3>, 3> _masks;
+	};
+
+	LedColorPlanes();
+
+	///
+	/// Fills the planes with the given colors
+	///
+	/// @param[in] colors The LED colors
+	///
+	void assign(const QVector<ColorRgb>& colors);
+
+	///
+	/// Copies the LED colors to the given buffer. Only the first min(size(), colors.size()) entries are written.
+	///
+	/// @param[out] colors The buffer the colors are written to
+	///
+	void copyTo(QVector<ColorRgb>& colors) const;
+
+	/// @return The number of LEDs
+	int size() const { return _size; }
+
+	/// @return The plane of the given channel (padded to a multiple of the plane alignment)
+	uint8_t* plane(Channel channel) { return _planes[channel]; }
+	const uint8_t* plane(Channel channel) const { return _planes[channel]; }
+
+	///
+	/// Sets the given LEDs to black
+	///
+	/// @param[in] ids The indices of the LEDs (indices beyond size() are ignored)
+	///
+	void setBlack(const QVector<int>& ids);
+
+	///
+	/// Applies the color order per LED. LEDs beyond the map's size are left unchanged.
+	///
+	/// @param[in] map The color order per LED
+	///
+	void applyColorOrder(const ColorOrderMap& map);
+
+private:
+	/// Alignment of the planes in bytes (covers AVX registers and cache lines)
+	static constexpr int ALIGNMENT = 64;
+
+	void resize(int size);
+
+	int _size;
+	int _stride;
+
+	/// Storage of the three planes and three scratch planes
+	std::vector<uint8_t> _buffer;
+	std::array<uint8_t*, 3> _planes;
+	std::array<uint8_t*, 3> _scratch;
+};
+
+#endif // LEDCOLORPLANES_H
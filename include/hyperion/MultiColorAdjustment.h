@@ -1,6 +1,7 @@
 #pragma once
 
 // STL includes
+#include <memory>
 #include <vector>
 #include <QStringList>
 #include <QString>
@@ -8,6 +9,8 @@
 // Hyperion includes
 #include <utils/ColorRgb.h>
 #include <hyperion/ColorAdjustment.h>
+#include <hyperion/ColorAdjustmentLut.h>
+#include <hyperion/LedColorPlanes.h>
 
 ///
 /// The LedColorTransform is responsible for performing color transformation from 'raw' colors
@@ -48,11 +51,12 @@ public:
 	ColorAdjustment* getAdjustment(const QString& adjutmentId);
 
 	///
-	/// Performs the color adjustment from raw-color to led-color
+	/// Performs the color adjustment from raw-color to led-color.
+	/// Each adjustment is applied via its lookup table, which is rebuilt if the adjustment's settings have changed.
 	///
-	/// @param ledColors The list with raw colors
+	/// @param ledColors The raw colors, adjusted in place
 	///
-	void applyAdjustment(QVector<ColorRgb>& ledColors);
+	void applyAdjustment(LedColorPlanes& ledColors);
 
 private:
 	/// List with transform ids
@@ -61,9 +65,15 @@ private:
 	/// List with unique ColorTransforms
 	QVector<ColorAdjustment*> _adjustment;
 
+	/// Lookup tables of the ColorTransforms (same order as _adjustment)
+	std::vector<std::unique_ptr<ColorAdjustmentLut>> _luts;
+
 	/// List with a pointer to the ColorAdjustment for each individual led
 	QVector<ColorAdjustment*> _ledAdjustments;
 
+	/// List with a pointer to the lookup table for each individual led
+	QVector<const ColorAdjustmentLut*> _ledLuts;
+
 	// logger instance
 	QSharedPointer<Logger> _log;
 };
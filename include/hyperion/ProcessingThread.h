@@ -0,0 +1,84 @@
+#ifndef PROCESSINGTHREAD_H
+#define PROCESSINGTHREAD_H
+
+// STL includes
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+#include <QThread>
+#include <QSemaphore>
+#include <QVector>
+#include <QSharedPointer>
+
+// Utils includes
+#include <utils/Image.h>
+#include <utils/ColorRgb.h>
+#include <utils/Logger.h>
+
+///
+/// Dedicated thread running the output processing of an instance (LED mapping, adjustments, device handoff).
+///
+/// Frames are handed over via a lock-free single-slot mailbox: posting a frame replaces a frame not yet picked up,
+/// so the thread always processes the latest input and a slow pass never builds up a queue.
+/// On Linux the thread can optionally be run with real-time priority (SCHED_FIFO) and be pinned to a CPU core.
+///
+class ProcessingThread : public QThread
+{
+public:
+	///
+	/// A snapshot of the input to be processed
+	///
+	struct Frame
+	{
+		Image<ColorRgb> image;
+		QVector<ColorRgb> ledColors;
+		/// Time the update was requested
+		std::chrono::steady_clock::time_point requested;
+	};
+
+	///
+	/// @param[in] process           Function processing a frame (called on the processing thread)
+	/// @param[in] realtimePriority  SCHED_FIFO priority (1..99), 0 to keep the default scheduling
+	/// @param[in] cpuAffinity       CPU core the thread is pinned to, -1 for no affinity
+	/// @param[in] log               The logger of the instance
+	///
+	ProcessingThread(std::function<void(Frame&)> process, int realtimePriority, int cpuAffinity, QSharedPointer<Logger> log);
+	~ProcessingThread() override;
+
+	///
+	/// Hands over a frame for processing. A frame not yet picked up by the thread is dropped.
+	///
+	/// @param[in] frame The frame
+	/// @return False, if a pending frame was dropped
+	///
+	bool post(Frame&& frame);
+
+	///
+	/// Stops the thread after the current frame and drops a pending one
+	///
+	void stop();
+
+	int getRealtimePriority() const { return _realtimePriority; }
+	int getCpuAffinity() const { return _cpuAffinity; }
+
+protected:
+	void run() override;
+
+private:
+	/// Applies the configured scheduling policy and affinity to the calling thread
+	void applySchedulingPolicy();
+
+	std::function<void(Frame&)> _process;
+	const int _realtimePriority;
+	const int _cpuAffinity;
+	QSharedPointer<Logger> _log;
+
+	/// The latest frame not yet picked up
+	std::atomic<Frame*> _mailbox;
+	/// Released whenever the mailbox becomes occupied
+	QSemaphore _frameAvailable;
+	std::atomic<bool> _isStopping;
+};
+
+#endif // PROCESSINGTHREAD_H
@@ -92,7 +92,8 @@ public:
 	/// @brief Set a device's latch time.
 	///
 	/// Latch time is the time-frame a device requires until the next update can be processed.
-	/// During that time-frame any updates done via updateLeds are skipped.
+	/// An update done via updateLeds during that time-frame is deferred until the latch time has passed,
+	/// newer updates replace the deferred one, i.e. the newest update is written.
 	///
 	/// @param[in] latchTime_ms Latch time in milliseconds
 	///
@@ -107,6 +108,17 @@ public:
 	///
 	void setRewriteTime(int rewriteTime_ms);
 
+	///
+	/// @brief Set a device's partial update behaviour.
+	///
+	/// With partial updates, devices supporting sparse writes send only the parts (e.g. universes, packets, panels) of an update
+	/// with LEDs changed since the last update written. All LEDs are written at least once per full refresh interval.
+	///
+	/// @param[in] isPartialUpdate True, if only changed parts are to be written
+	/// @param[in] fullRefreshTime_ms Interval in milliseconds all LEDs are written in
+	///
+	void setPartialUpdate(bool isPartialUpdate, int fullRefreshTime_ms);
+
 	/// @brief Set a device's enablement cycle's parameters.
 	///
 	/// @param[in] maxEnableRetries Maximum number of attempts to enable a device, if reached retries will be stopped
@@ -378,6 +390,26 @@ protected:
 	///
 	virtual int writeColor(const ColorRgb& color, int numberOfWrites = 1);
 
+	///
+	/// @brief Check, if a range of LEDs is to be written with the current update.
+	///
+	/// To be used by write() implementations supporting sparse writes, to skip parts of an update not changed.
+	/// Outside of partial updates (e.g. partial updates disabled, full refresh due, rewrites, writing a color) all LEDs are to be written.
+	///
+	/// @param[in] ledValues The RGB-color per LED of the update
+	/// @param[in] firstLed The first LED of the range
+	/// @param[in] count The number of LEDs in the range
+	/// @return True, if the range is to be written
+	///
+	bool isLedRangeChanged(const QVector<ColorRgb>& ledValues, int firstLed, int count) const;
+
+	///
+	/// @brief Check, if all LEDs are to be written with the current update.
+	///
+	/// @return True, if no part of the update may be skipped
+	///
+	bool isFullUpdate() const { return _isFullUpdate; }
+
 	///
 	/// @brief Power-/turn on the LED-device.
 	///
@@ -501,8 +533,8 @@ protected:
 	/// Is the device in error state, but is retries might resolve the situation?
 	bool _isDeviceRecoverable;
 
-	/// Timestamp of last write
-	QDateTime _lastWriteTime;
+	/// Timestamp of last write (monotonic)
+	std::chrono::steady_clock::time_point _lastWriteTime;
 
 protected slots:
 
@@ -533,6 +565,11 @@ private slots:
 	///
 	void retryEnable();
 
+	///
+	/// @brief Write the newest LED update deferred by the latch time
+	///
+	void processDeferredLedUpdate();
+
 private:
 	class SwitchOffCompletionGuard final
 	{
@@ -575,6 +612,9 @@ private:
 	/// @brief Stop refresh cycle
 	void stopRefreshTimer();
 
+	/// @brief Stop a pending deferred write
+	void stopLatchTimer();
+
 	/// @brief Wait until a pending switchOff() operation finishes.
 	void waitForPendingSwitchOff() const;
 
@@ -593,6 +633,9 @@ private:
 	/// Timer that enables a device (used to retry enablement, if enabled failed before)
 	QScopedPointer<QTimer>	_enableAttemptsTimer;
 
+	/// Timer writing an update received within the latch time, once the latch time has passed
+	QScopedPointer<QTimer>	_latchTimer;
+
 	// Device configuration parameters
 
 	std::chrono::seconds _enableAttemptTimerInterval;
@@ -612,6 +655,17 @@ private:
 	/// Last LED values written
 	QVector<ColorRgb> _lastLedValues;
 
+	/// Are only changed parts of an update written?
+	bool _isPartialUpdate;
+	/// Interval in milliseconds all LEDs are written in with partial updates
+	int _fullRefreshTime_ms;
+	/// Is the current write to cover all LEDs?
+	bool _isFullUpdate;
+	/// Timestamp of the last update written in full
+	std::chrono::steady_clock::time_point _lastFullUpdateTime;
+	/// LED values of the last update written, the reference for the changes of the next partial update
+	QVector<ColorRgb> _writtenLedValues;
+
 	std::atomic<bool> _isLedUpdatePending{ false };
 	std::atomic<bool> _isSwitchOffInProgress{ false };
 	std::atomic<bool> _isStopDeferred{ false };
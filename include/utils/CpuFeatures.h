@@ -0,0 +1,26 @@
+#ifndef CPUFEATURES_H
+#define CPUFEATURES_H
+
+///
+/// Runtime detection of the SIMD instruction sets available on the executing CPU.
+/// Used to dispatch between vectorized and scalar implementations of hot loops.
+///
+namespace CpuFeatures {
+
+	///
+	/// @return True, if SSE2 is supported (always true on x86-64)
+	///
+	bool hasSse2();
+
+	///
+	/// @return True, if AVX2 is supported by the CPU and enabled by the OS
+	///
+	bool hasAvx2();
+
+	///
+	/// @return True, if NEON (Advanced SIMD) is available (decided at compile time)
+	///
+	bool hasNeon();
+}
+
+#endif // CPUFEATURES_H
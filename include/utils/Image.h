@@ -138,7 +138,7 @@ public:
 	///
 	Pixel_T& operator()(int x, int y);
 
-	/// Resize the image
+	/// Resize the image, the pixel values are unspecified after a change of the size
 	/// @param width The width of the image
 	/// @param height The height of the image
 	void resize(int width, int height);
@@ -188,8 +188,33 @@ public:
 	///
 	void reset();
 
+	///
+	/// Returns the id of this image handle. Every (shallow) copy of an image gets its own id.
+	///
 	quint64 id() const;
 
+	///
+	/// Returns the id of the pixel data. Shallow copies of an image share the same data id,
+	/// a new id is assigned when the data is detached (i.e. before it can be modified).
+	/// The id therefore identifies a frame's content, as long as a handle to it is kept.
+	///
+	quint64 dataId() const;
+
+	///
+	/// Returns a 64-bit hash of the image size and pixels. Images with the same fingerprint can be
+	/// treated as identical frames. The fingerprint stored by updateFingerprint() is returned,
+	/// if the pixels have not been modified since, otherwise it is computed on the fly.
+	///
+	/// @return The fingerprint, never 0
+	///
+	quint64 fingerprint() const;
+
+	///
+	/// Computes the fingerprint and stores it with the pixel data, e.g. once a frame has been captured.
+	/// Shallow copies share the stored fingerprint. Modifying the pixels discards it.
+	///
+	void updateFingerprint();
+
 	///
 	/// Returns a const QImage that shares data with this Image object.
 	/// No data is copied. The returned QImage is read-only.
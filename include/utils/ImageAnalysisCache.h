@@ -0,0 +1,97 @@
+#ifndef IMAGEANALYSISCACHE_H
+#define IMAGEANALYSISCACHE_H
+
+// STL includes
+#include <deque>
+#include <future>
+#include <memory>
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+
+#include <utils/Image.h>
+#include <utils/ColorRgb.h>
+
+///
+/// Process-wide cache of analysis results per captured frame, shared between all instances.
+///
+/// Instances consuming the same capture receive the same frame data. Results derived from a frame
+/// (e.g. black border detection, integral image or LED colors of an identical layout) are calculated by the first
+/// instance requesting them and reused by the others. Results are identified by the frame's data id and a key
+/// describing the analysis and all its parameters.
+///
+/// Only the most recent frames are kept. A cached frame is referenced by the cache, so that its data cannot be
+/// modified in place while results exist for it.
+///
+class ImageAnalysisCache
+{
+public:
+	///
+	/// @return The process-wide cache
+	///
+	static ImageAnalysisCache& getInstance();
+
+	///
+	/// Returns the result of an analysis of the given frame. If no result exists yet, it is calculated by the
+	/// given function. Concurrent requests for the same frame and key wait for the result of the first request.
+	///
+	/// @param[in] image    The frame analysed
+	/// @param[in] key      Key identifying the analysis and its parameters (has to map to a single result type)
+	/// @param[in] compute  Function calculating the result, if it is not cached
+	///
+	/// @return The (shared) result
+	///
+	template <typename T, typename Compute>
+	std::shared_ptr<const T> get(const Image<ColorRgb>& image, const QByteArray& key, Compute compute)
+	{
+		std::shared_ptr<std::promise<Result>> promise;
+		const std::shared_future<Result> future = acquire(image, key, promise);
+		if (promise)
+		{
+			// This caller calculates the result, others requesting the same frame and key wait for it
+			std::shared_ptr<const T> result = std::make_shared<T>(compute());
+			promise->set_value(result);
+			return result;
+		}
+		return std::static_pointer_cast<const T>(future.get());
+	}
+
+	ImageAnalysisCache(const ImageAnalysisCache&) = delete;
+	ImageAnalysisCache& operator=(const ImageAnalysisCache&) = delete;
+
+private:
+	ImageAnalysisCache() = default;
+
+	using Result = std::shared_ptr<const void>;
+
+	///
+	/// Looks up the result of an analysis. If there is none, a promise is returned that the caller has to fulfil.
+	///
+	/// @param[in] image     The frame analysed
+	/// @param[in] key       Key identifying the analysis
+	/// @param[out] promise  Set, if the caller has to calculate the result
+	///
+	/// @return The future result
+	///
+	std::shared_future<Result> acquire(const Image<ColorRgb>& image, const QByteArray& key, std::shared_ptr<std::promise<Result>>& promise);
+
+	struct Entry
+	{
+		/// The frame's data id
+		quint64 dataId;
+		/// Reference to the frame, keeps its data from being modified in place
+		Image<ColorRgb> image;
+		/// The results per analysis key
+		QHash<QByteArray, std::shared_future<Result>> results;
+	};
+
+	/// Number of frames results are kept for (e.g. frames of screen and video capture interleaving)
+	static constexpr size_t MAX_FRAMES = 2;
+
+	QMutex _mutex;
+	/// Cached frames, most recent last
+	std::deque<Entry> _entries;
+};
+
+#endif // IMAGEANALYSISCACHE_H
@@ -97,6 +97,9 @@ public:
 
 	void reset();
 
+	quint64 fingerprint() const;
+	void updateFingerprint();
+
 private:
 	int toIndex(int x, int y) const;
 
@@ -106,6 +109,8 @@ private:
 	int _height;
 	/// The pixels of the image
 	std::vector<pixel_type> _pixels;
+	/// Fingerprint of the pixels, 0 if not computed or the pixels may have been modified since
+	quint64 _fingerprint;
 
 	quint64 _instanceId; // Unique ID for this data block
 };
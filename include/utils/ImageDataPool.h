@@ -0,0 +1,86 @@
+#ifndef IMAGEDATAPOOL_H
+#define IMAGEDATAPOOL_H
+
+// STL includes
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+
+///
+/// Counters shared by the pools of all pixel types
+///
+class ImageDataPoolStatistics
+{
+public:
+	///
+	/// @return Hits, misses, buffers and bytes held by the pools of all pixel types (thread-safe)
+	///
+	static QJsonObject get();
+
+protected:
+	static std::atomic<quint64> _hits;
+	static std::atomic<quint64> _misses;
+	static std::atomic<qint64> _buffersHeld;
+	static std::atomic<qint64> _bytesHeld;
+};
+
+///
+/// Process-wide pool of the pixel buffers of image data.
+///
+/// Captured frames keep their size from frame to frame. Instead of allocating the pixels of every new image and
+/// freeing them once the last handle to the image is gone, the buffer of destroyed image data is kept per image size
+/// and handed to the next image of the same size. The number of buffers per size and the total size held are limited,
+/// buffers of other sizes are freed first (e.g. after a resolution change) and buffers exceeding the limits are freed.
+///
+template <typename Pixel_T>
+class ImageDataPool : public ImageDataPoolStatistics
+{
+public:
+	///
+	/// @return The process-wide pool for the pixel type
+	///
+	static ImageDataPool& getInstance();
+
+	///
+	/// Returns a buffer for an image of the given size, the pixel values are unspecified.
+	///
+	/// @param[in] width   The width of the image
+	/// @param[in] height  The height of the image
+	///
+	/// @return Buffer of width * height pixels
+	///
+	std::vector<Pixel_T> acquire(int width, int height);
+
+	///
+	/// Hands the buffer of an image back to the pool.
+	///
+	/// @param[in] width   The width of the image
+	/// @param[in] height  The height of the image
+	/// @param[in] pixels  The buffer of width * height pixels
+	///
+	void release(int width, int height, std::vector<Pixel_T>&& pixels);
+
+	ImageDataPool(const ImageDataPool&) = delete;
+	ImageDataPool& operator=(const ImageDataPool&) = delete;
+
+private:
+	ImageDataPool() = default;
+
+	static quint64 key(int width, int height);
+	static qint64 bytes(const std::vector<Pixel_T>& pixels);
+
+	/// Maximum number of buffers held per image size
+	static constexpr int MAX_BUFFERS_PER_SIZE = 4;
+	/// Maximum number of bytes held for the pixel type
+	static constexpr qint64 MAX_BYTES = 64 * 1024 * 1024;
+
+	QMutex _mutex;
+	QHash<quint64, std::vector<std::vector<Pixel_T>>> _buffers;
+	qint64 _bytes = 0;
+};
+
+#endif // IMAGEDATAPOOL_H
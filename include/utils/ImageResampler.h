@@ -17,9 +17,85 @@ public:
 	void setCropping(int cropLeft, int cropRight, int cropTop, int cropBottom);
 	void setVideoMode(VideoMode mode) { _videoMode = mode; }
 	void setFlipMode(FlipMode mode) { _flipMode = mode; }
+
+	///
+	/// @brief Select how decimated pixels are calculated
+	///
+	/// By default one pixel per block is sampled. With the box filter enabled the average of all pixels of a block is
+	/// calculated, which avoids aliasing (flickering colors) at high decimation factors. BGR16 is always sampled.
+	///
+	/// @param enable True, to average the pixels of a block
+	///
+	void setBoxFilter(bool enable) { _boxFilter = enable; }
+
 	void processImage(const uint8_t * data, int width, int height, size_t lineLength, PixelFormat pixelFormat, Image<ColorRgb> & outputImage) const;
 
+	///
+	/// @brief Memory layout of a frame stored in tiles
+	///
+	struct TiledLayout
+	{
+		enum class Type
+		{
+			/// Broadcom SAND: The planes are stored in vertical columns of columnWidth bytes, each column holds columnHeight lines (of all planes)
+			BROADCOM_SAND,
+			/// Broadcom VC4 T-tiled: 4 KiB tiles of 2x2 1 KiB sub-tiles of 4x4 micro-tiles (64 bytes), the order of the tiles alternates per row of tiles
+			VC4_T_TILED
+		};
+
+		Type type;
+		/// BROADCOM_SAND: Width of a column [bytes] and number of lines per column
+		int columnWidth;
+		int columnHeight;
+		/// VC4_T_TILED: Bytes per line, a multiple of the 128 bytes of a tile's line
+		int pitch;
+		/// Offset of the first plane (luma or RGB) and of the chroma plane [bytes]
+		size_t planeOffsets[2];
+	};
+
+	///
+	/// @brief Returns the number of bytes a tiled frame spans
+	///
+	/// @return The size of the frame, 0 if the pixel format is not supported for the layout
+	///
+	static size_t tiledImageSize(int width, int height, const TiledLayout & layout, PixelFormat pixelFormat);
+
+	///
+	/// @brief Decimate a frame stored in tiles
+	///
+	/// Only the sampled pixels are read out of the tiles, the frame is not converted to a linear layout first.
+	/// Supported are NV12 and NV21 in the BROADCOM_SAND layout and RGB32 and BGR32 in the VC4_T_TILED layout.
+	/// Pixels are always sampled, the box filter is not applied.
+	///
+	/// @return False, if the pixel format is not supported for the layout
+	///
+	bool processTiledImage(const uint8_t * data, int width, int height, const TiledLayout & layout, PixelFormat pixelFormat, Image<ColorRgb> & outputImage) const;
+
 private:
+	///
+	/// @brief Cropping and size of the output resolved for the video mode, flip mode resolved to mirrored rows/columns
+	///
+	struct Geometry
+	{
+		int cropLeft;
+		int cropRight;
+		int cropTop;
+		int cropBottom;
+		int outputWidth;
+		int outputHeight;
+		bool mirrorRows;
+		bool mirrorColumns;
+	};
+
+	Geometry geometry(int width, int height) const;
+
+	///
+	/// @brief Decimate by averaging the pixels of each block (cropping already resolved)
+	///
+	void processImageBoxFilter(const uint8_t * data, int width, int height, size_t lineLength, PixelFormat pixelFormat,
+							   int cropLeft, int cropRight, int cropTop, int cropBottom,
+							   bool mirrorRows, bool mirrorColumns, Image<ColorRgb> & outputImage) const;
+
 	int _horizontalDecimation;
 	int _verticalDecimation;
 	int _cropLeft;
@@ -28,5 +104,6 @@ private:
 	int _cropBottom;
 	VideoMode _videoMode;
 	FlipMode _flipMode;
+	bool _boxFilter;
 };
 
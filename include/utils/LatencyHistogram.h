@@ -0,0 +1,62 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+// STL includes
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <QJsonObject>
+
+///
+/// Lock-free histogram of latencies, recorded and read from any thread.
+///
+/// The buckets follow a 1-2-5 series from 100 µs to 500 ms, plus one bucket for all larger latencies.
+/// Percentiles are estimated by the upper bound of the bucket they fall into.
+///
+class LatencyHistogram
+{
+public:
+	/// Upper bounds of the buckets in microseconds (the last bucket is unbounded)
+	static constexpr std::array<int64_t, 12> BUCKET_BOUNDS_US {{ 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000, 500000 }};
+	static constexpr int BUCKET_COUNT = static_cast<int>(BUCKET_BOUNDS_US.size()) + 1;
+
+	LatencyHistogram();
+
+	///
+	/// Records a latency
+	///
+	/// @param[in] latency The latency to be recorded (negative values are recorded as zero)
+	///
+	void record(std::chrono::microseconds latency);
+
+	///
+	/// Clears all recorded latencies
+	///
+	void reset();
+
+	/// @return The number of recorded latencies
+	int64_t count() const { return _count.load(std::memory_order_relaxed); }
+
+	///
+	/// Estimates the latency below which the given share of the recorded latencies lies
+	///
+	/// @param[in] percentile The share in percent (0..100)
+	/// @return The upper bound of the bucket containing the percentile in microseconds, the maximum for the overflow bucket and 0, if nothing was recorded
+	///
+	int64_t percentile(double percentile) const;
+
+	///
+	/// @return Count, mean, maximum, p50/p95/p99 (all latencies in microseconds) and the bucket counts
+	///
+	QJsonObject toJson() const;
+
+private:
+	std::array<std::atomic<int64_t>, BUCKET_COUNT> _buckets;
+	std::atomic<int64_t> _count;
+	std::atomic<int64_t> _sumUs;
+	std::atomic<int64_t> _maxUs;
+};
+
+#endif // LATENCYHISTOGRAM_H
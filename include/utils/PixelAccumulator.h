@@ -0,0 +1,88 @@
+#ifndef PIXELACCUMULATOR_H
+#define PIXELACCUMULATOR_H
+
+// STL includes
+#include <cstdint>
+
+#include <utils/ColorRgb.h>
+
+///
+/// Accumulation of the color channels of packed RGB24 pixel runs, as used to calculate mean colors.
+/// The implementation is selected at runtime (SSE2/AVX2 on x86, NEON on ARM) with a scalar fallback.
+/// All implementations calculate exact integer sums, i.e. they return bit-identical results.
+///
+class PixelAccumulator
+{
+public:
+	enum class Implementation
+	{
+		SCALAR,
+		SSE2,
+		AVX2,
+		NEON
+	};
+
+	/// Sums per color channel
+	struct Sums
+	{
+		uint64_t red {0};
+		uint64_t green {0};
+		uint64_t blue {0};
+	};
+
+	///
+	/// Adds the channel values of a run of pixels to the given sums.
+	///
+	/// @param[in] pixels  The first pixel of the run
+	/// @param[in] length  Number of pixels to be accumulated
+	/// @param[in] stride  Distance between two consecutive pixels to be accumulated
+	/// @param[in,out] sums  The sums the channel values are added to
+	///
+	static void sum(const ColorRgb *pixels, int length, int stride, Sums &sums);
+
+	///
+	/// Adds the squared channel values of a run of pixels to the given sums.
+	///
+	/// @param[in] pixels  The first pixel of the run
+	/// @param[in] length  Number of pixels to be accumulated
+	/// @param[in] stride  Distance between two consecutive pixels to be accumulated
+	/// @param[in,out] sums  The sums the squared channel values are added to
+	///
+	static void sumSquared(const ColorRgb *pixels, int length, int stride, Sums &sums);
+
+	///
+	/// Adds a run of bytes element-wise to 16-bit sums, e.g. to sum up the lines of an image block.
+	/// The caller has to ensure the sums do not overflow (at most 257 runs added).
+	///
+	/// @param[in] bytes   The first byte of the run
+	/// @param[in] length  Number of bytes to be added
+	/// @param[in,out] sums  The sums the bytes are added to (one per byte)
+	///
+	static void addBytes(const uint8_t *bytes, int length, uint16_t *sums);
+
+	///
+	/// @return The implementation currently used
+	///
+	static Implementation implementation();
+
+	///
+	/// Selects the implementation to be used (e.g. to compare implementations in tests).
+	///
+	/// @param[in] implementation  The implementation to be used
+	///
+	/// @return False, if the implementation is not supported by the CPU or build; the current one is kept
+	///
+	static bool setImplementation(Implementation implementation);
+
+	///
+	/// @return True, if the given implementation is supported by the CPU and build
+	///
+	static bool isSupported(Implementation implementation);
+
+	///
+	/// @return The name of the given implementation
+	///
+	static const char *implementationToString(Implementation implementation);
+};
+
+#endif // PIXELACCUMULATOR_H
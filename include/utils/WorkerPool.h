@@ -0,0 +1,50 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+// STL includes
+#include <functional>
+
+#include <QThreadPool>
+
+///
+/// Process-wide pool of worker threads (sized to the number of CPU cores) to parallelise data-parallel loops.
+///
+/// Work is split into chunks which are claimed dynamically by the pool's workers and the calling thread,
+/// so idle threads pick up remaining chunks of busy ones. As the calling thread takes part in the processing,
+/// a loop always completes, even if all workers are occupied by other callers (e.g. other instances).
+///
+class WorkerPool
+{
+public:
+	///
+	/// @return The process-wide worker pool
+	///
+	static WorkerPool& instance();
+
+	///
+	/// @return The number of threads available for processing, including the calling thread
+	///
+	int threadCount() const;
+
+	///
+	/// Runs a function over the index range [0, count) split into chunks and blocks until all chunks are processed.
+	///
+	/// @param[in] count      The number of indices to be processed
+	/// @param[in] chunkSize  The number of indices processed per chunk
+	/// @param[in] function   The function called per chunk with the chunk's index range [begin, end)
+	///
+	void run(int count, int chunkSize, const std::function<void(int begin, int end)>& function);
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+private:
+	WorkerPool();
+	~WorkerPool();
+
+	QThreadPool _pool;
+	/// Number of pool threads helping the calling thread (none on single core systems)
+	int _helperCount;
+};
+
+#endif // WORKERPOOL_H
@@ -0,0 +1,61 @@
+#ifndef YUVTORGB_H
+#define YUVTORGB_H
+
+// STL includes
+#include <cstdint>
+
+#include <utils/ColorRgb.h>
+
+///
+/// Conversion of rows of YUV samples (BT.601, limited range) to packed RGB24 pixels.
+/// The implementation is selected at runtime (SSE2/AVX2 on x86, NEON on ARM) with a scalar fallback.
+/// All implementations use the integer arithmetic of ColorSys::yuv2rgb, i.e. they return bit-identical results.
+///
+class YuvToRgb
+{
+public:
+	enum class Implementation
+	{
+		SCALAR,
+		SSE2,
+		AVX2,
+		NEON
+	};
+
+	///
+	/// Converts a row of samples, one Y, U and V value per output pixel.
+	///
+	/// @param[in] y       The luma samples
+	/// @param[in] u       The blue-difference chroma samples
+	/// @param[in] v       The red-difference chroma samples
+	/// @param[in] length  Number of pixels to be converted
+	/// @param[out] rgb    The converted pixels
+	///
+	static void convert(const uint8_t *y, const uint8_t *u, const uint8_t *v, int length, ColorRgb *rgb);
+
+	///
+	/// @return The implementation currently used
+	///
+	static Implementation implementation();
+
+	///
+	/// Selects the implementation to be used (e.g. to compare implementations in tests).
+	///
+	/// @param[in] implementation  The implementation to be used
+	///
+	/// @return False, if the implementation is not supported by the CPU or build; the current one is kept
+	///
+	static bool setImplementation(Implementation implementation);
+
+	///
+	/// @return True, if the given implementation is supported by the CPU and build
+	///
+	static bool isSupported(Implementation implementation);
+
+	///
+	/// @return The name of the given implementation
+	///
+	static const char *implementationToString(Implementation implementation);
+};
+
+#endif // YUVTORGB_H
@@ -665,6 +665,11 @@ void JsonAPI::handleGetLedSnapshotCommand(const QJsonObject& /*message*/, const
 	}
 }
 
+void JsonAPI::handleGetLatencyStatisticsCommand(const QJsonObject& /*message*/, const JsonApiCommand &cmd)
+{
+	sendSuccessDataReply(hyperion->getLatencyStatistics(), cmd);
+}
+
 void JsonAPI::handleInstanceDataCommand(const QJsonObject &message, const JsonApiCommand &cmd)
 {
 
@@ -676,6 +681,9 @@ void JsonAPI::handleInstanceDataCommand(const QJsonObject &message, const JsonAp
 	case SubCommand::GetLedSnapshot:
 		handleGetLedSnapshotCommand(message, cmd);
 		break;
+	case SubCommand::GetLatencyStatistics:
+		handleGetLatencyStatisticsCommand(message, cmd);
+		break;
 	default:
 	break;
 	}
@@ -6,6 +6,7 @@
 #include <utils/ColorSys.h>
 #include <leddevice/LedDeviceWrapper.h>
 #include <utils/SysInfo.h>
+#include <utils/ImageDataPool.h>
 #include <hyperion/AuthManager.h>
 #include <QCoreApplication>
 #include <QApplication>
@@ -349,6 +350,7 @@ QJsonObject JsonInfo::getGrabbers(const QSharedPointer<Hyperion>& hyperionInstan
 		videoGrabbers["active"] = activeGrabberNames;
 	}
 	videoGrabbers["available"] = getAvailableVideoGrabbers();
+	videoGrabbers["statistics"] = GrabberWrapper::getStatistics(GrabberTypeFilter::VIDEO);
 
 	// AUDIO
 	QJsonObject audioGrabbers;
@@ -638,6 +640,7 @@ QJsonObject JsonInfo::getSystemInfo()
 
 	QCoreApplication* app = QCoreApplication::instance();
 	hyperionInfo["isGuiMode"] = qobject_cast<QApplication*>(app) != nullptr;
+	hyperionInfo["imageBufferPool"] = ImageDataPoolStatistics::get();
 
 	info["hyperion"] = hyperionInfo;
 
@@ -141,6 +141,11 @@ bool BlackBorderProcessor::enabled() const
 	return _enabled;
 }
 
+bool BlackBorderProcessor::isSettled() const
+{
+	return !_enabled || (_inconsistentCnt == 0 && _previousDetectedBorder == _currentBorder);
+}
+
 void BlackBorderProcessor::setEnabled(bool enable)
 {
 	_enabled = enable;
@@ -6,6 +6,7 @@
 #include <string>
 #include <iostream>
 #include <vector>
+#include <algorithm>
 
 #include <QThread>
 #include <QJsonObject>
@@ -14,6 +15,7 @@
 #include <QDir>
 #include <QSize>
 #include <QMap>
+#include <QSocketNotifier>
 
 // Add missing AMD format modifier definitions for downward compatibility
 #ifndef AMD_FMT_MOD_TILE_VER_GFX11
@@ -135,30 +137,17 @@ static PixelFormat GetPixelFormatForDrmFormat(uint32_t format)
     }
 }
 
-// Code from: https://gitlab.freedesktop.org/drm/igt-gpu-tools/-/blob/master/lib/igt_vc4.c#L339
-static size_t vc4_sand_tiled_offset(size_t column_width, size_t column_size, size_t x, size_t y, size_t bpp)
-{
-    size_t offset = 0;
-    size_t cols_x;
-    size_t pix_x;
-
-    /* Offset to the beginning of the relevant column. */
-    cols_x = x / column_width;
-    offset += cols_x * column_size;
-
-    /* Offset to the relevant pixel. */
-    pix_x = x % column_width;
-    offset += (column_width * y + pix_x) * bpp / 8;
-
-    return offset;
-}
-
 // Forward declarations for QDebug operators
 QDebug operator<<(QDebug dbg, const drmModeFB2* fb);
 QDebug operator<<(QDebug dbg, const drmModePlane* plane);
 
 DRMFrameGrabber::DRMFrameGrabber(int deviceIdx, int cropLeft, int cropRight, int cropTop, int cropBottom)
     : Grabber("GRABBER-DRM", cropLeft, cropRight, cropTop, cropBottom), _deviceFd(-1), _crtc(nullptr)
+    , _pixelFormat(PixelFormat::NO_CHANGE)
+    , _crtcIndex(0)
+    , _currentFbId(0)
+    , _vblankNotifier(nullptr)
+    , _isVblankRequested(false)
 {
     _input = deviceIdx;
     _useImageResampler = true;
@@ -210,10 +199,176 @@ bool DRMFrameGrabber::setupScreen()
         freeResources();
         closeDevice();
     }
+    else
+    {
+        setupVblank();
+    }
 
     return success;
 }
 
+void DRMFrameGrabber::setEventDriven(bool enable)
+{
+    if (_eventDriven != enable)
+    {
+        Grabber::setEventDriven(enable);
+        if (_deviceFd >= 0)
+        {
+            setupVblank();
+        }
+    }
+}
+
+bool DRMFrameGrabber::isEventDriven() const
+{
+    return _eventDriven && _isVblankRequested;
+}
+
+void DRMFrameGrabber::setupVblank()
+{
+    // When disabled, a pending event is still consumed, but no further one is requested
+    if (!_eventDriven || _crtc == nullptr)
+    {
+        return;
+    }
+
+    if (_vblankNotifier == nullptr)
+    {
+        _vblankNotifier = new QSocketNotifier(_deviceFd, QSocketNotifier::Read, this);
+        connect(_vblankNotifier, &QSocketNotifier::activated, this, [this]() {
+            drmEventContext eventContext {};
+            eventContext.version = 2;
+            eventContext.vblank_handler = [](int /*fd*/, unsigned int /*sequence*/, unsigned int /*tv_sec*/, unsigned int /*tv_usec*/, void* userData) {
+                static_cast<DRMFrameGrabber*>(userData)->handleVblank();
+            };
+            drmHandleEvent(_deviceFd, &eventContext);
+        });
+    }
+
+    if (_isVblankRequested)
+    {
+        return;
+    }
+
+    if (requestVblank())
+    {
+        Info(_log, "Frames are captured on page flips");
+    }
+    else
+    {
+        Warning(_log, "Vertical blank events are not available (%s), frames are captured at a fixed rate", strerror(errno));
+    }
+}
+
+void DRMFrameGrabber::freeVblank()
+{
+    // A pending event is discarded with the device file descriptor
+    delete _vblankNotifier;
+    _vblankNotifier = nullptr;
+    _isVblankRequested = false;
+}
+
+bool DRMFrameGrabber::requestVblank()
+{
+    drmVBlank vblank {};
+    unsigned int crtcSelection {0};
+    if (_crtcIndex > 1)
+    {
+        crtcSelection = (static_cast<unsigned int>(_crtcIndex) << DRM_VBLANK_HIGH_CRTC_SHIFT) & DRM_VBLANK_HIGH_CRTC_MASK;
+    }
+    else if (_crtcIndex == 1)
+    {
+        crtcSelection = DRM_VBLANK_SECONDARY;
+    }
+
+    vblank.request.type = static_cast<drmVBlankSeqType>(DRM_VBLANK_RELATIVE | DRM_VBLANK_EVENT | crtcSelection);
+    vblank.request.sequence = 1;
+    vblank.request.signal = reinterpret_cast<unsigned long>(this);
+
+    _isVblankRequested = (drmWaitVBlank(_deviceFd, &vblank) == 0);
+    return _isVblankRequested;
+}
+
+void DRMFrameGrabber::handleVblank()
+{
+    _isVblankRequested = false;
+
+    // Compositors show a new frame by flipping the primary plane to another framebuffer, a static screen keeps it
+    auto planeIt = _planes.begin();
+    if (planeIt != _planes.end())
+    {
+        drmModePlanePtr plane = drmModeGetPlane(_deviceFd, planeIt->first);
+        if (plane != nullptr)
+        {
+            const uint32_t fbId = plane->fb_id;
+            drmModeFreePlane(plane);
+
+            if (fbId != 0 && fbId != _currentFbId && updateFramebuffer(fbId))
+            {
+                emit frameAvailable();
+            }
+        }
+    }
+
+    if (_eventDriven && _isEnabled && !requestVblank())
+    {
+        qCDebug(grabber_screen_flow) << "Vertical blank request failed:" << strerror(errno);
+    }
+}
+
+bool DRMFrameGrabber::updateFramebuffer(uint32_t fbId)
+{
+    static constexpr size_t MAX_CACHED_FRAMEBUFFERS = 4;
+
+    if (_framebuffers.find(fbId) == _framebuffers.end())
+    {
+        drmModeFB2Ptr fb = drmModeGetFB2(_deviceFd, fbId);
+        if (fb == nullptr)
+        {
+            return false;
+        }
+        if (fb->handles[0] == 0)
+        {
+            drmModeFreeFB2(fb);
+            return false;
+        }
+
+        // Framebuffers of earlier page flips are usually reused by the compositor, drop them only if there are too many
+        for (auto it = _framebuffers.begin(); it != _framebuffers.end() && _framebuffers.size() >= MAX_CACHED_FRAMEBUFFERS;)
+        {
+            if (it->first == _currentFbId)
+            {
+                ++it;
+                continue;
+            }
+            releaseFramebuffer(it->second);
+            it = _framebuffers.erase(it);
+        }
+        _framebuffers.insert({fbId, fb});
+    }
+
+    _currentFbId = fbId;
+    return true;
+}
+
+void DRMFrameGrabber::releaseFramebuffer(drmModeFB2Ptr framebuffer) const
+{
+    // The GEM handles of a framebuffer are created per request, close them once each
+    for (int i = 0; i < 4; ++i)
+    {
+        const uint32_t handle = framebuffer->handles[i];
+        if (handle == 0 || std::find(framebuffer->handles, framebuffer->handles + i, handle) != framebuffer->handles + i)
+        {
+            continue;
+        }
+
+        drm_gem_close gemClose {};
+        gemClose.handle = handle;
+        drmIoctl(_deviceFd, DRM_IOCTL_GEM_CLOSE, &gemClose);
+    }
+    drmModeFreeFB2(framebuffer);
+}
+
 bool DRMFrameGrabber::setWidthHeight(int width, int height)
 {
     if (Grabber::setWidthHeight(width, height))
@@ -296,289 +451,85 @@ static bool processLinearFramebuffer(const LinearFramebufferParams& params)
     return false;
 }
 
-// --- Broadcom SAND helpers (format-agnostic dispatcher) ---
+// --- Broadcom tiled helpers ---
 
-struct PlaneInfo
+static bool getBroadcomTiledLayout(const drmModeFB2* framebuffer, ImageResampler::TiledLayout& layout, QString& errorString)
 {
-    int bpp;             // bits per pixel on this plane (8, 16, 32)
-    int width;           // plane width in pixels
-    int height;          // plane height in pixels
-    int stride;          // destination packed bytes per line
-    size_t srcBaseOffset; // source base offset (fb->offsets[idx])
-    size_t dstBaseOffset; // destination base offset in packed buffer
-    int fbPlaneIdx;      // FB plane index (0..3)
-};
+    layout = {};
+    layout.planeOffsets[0] = framebuffer->offsets[0];
+    layout.planeOffsets[1] = framebuffer->offsets[1];
 
-static bool getBroadcomSandGeometry(uint64_t modifier, uint32_t& columnWidthBytes, uint32_t& columnHeight, QString& errorString)
-{
-    switch (fourcc_mod_broadcom_mod(modifier))
+    switch (fourcc_mod_broadcom_mod(framebuffer->modifier))
     {
-    case DRM_FORMAT_MOD_BROADCOM_SAND32:  columnWidthBytes = 32;  break;
-    case DRM_FORMAT_MOD_BROADCOM_SAND64:  columnWidthBytes = 64;  break;
-    case DRM_FORMAT_MOD_BROADCOM_SAND128: columnWidthBytes = 128; break;
-    case DRM_FORMAT_MOD_BROADCOM_SAND256: columnWidthBytes = 256; break;
+    case DRM_FORMAT_MOD_BROADCOM_SAND32:  layout.columnWidth = 32;  break;
+    case DRM_FORMAT_MOD_BROADCOM_SAND64:  layout.columnWidth = 64;  break;
+    case DRM_FORMAT_MOD_BROADCOM_SAND128: layout.columnWidth = 128; break;
+    case DRM_FORMAT_MOD_BROADCOM_SAND256: layout.columnWidth = 256; break;
     case DRM_FORMAT_MOD_BROADCOM_VC4_T_TILED:
-        errorString = "Broadcom modifier 'DRM_FORMAT_MOD_BROADCOM_VC4_T_TILED' currently not supported";
-        return false;
+        layout.type = ImageResampler::TiledLayout::Type::VC4_T_TILED;
+        layout.pitch = static_cast<int>(framebuffer->pitches[0]);
+        return true;
     default:
         errorString = "Unknown Broadcom modifier";
         return false;
     }
 
-    columnHeight = fourcc_mod_broadcom_param(modifier);
+    // The parameter of the SAND modifiers is the column height in lines, covering the luma and the chroma plane
+    layout.type = ImageResampler::TiledLayout::Type::BROADCOM_SAND;
+    layout.columnHeight = static_cast<int>(fourcc_mod_broadcom_param(framebuffer->modifier));
     return true;
 }
 
-static bool getPlanesForFormat(PixelFormat fmt,
-                               int w, int h,
-                               uint32_t /*columnWidthBytes*/,
-                               const drmModeFB2* fb,
-                               std::vector<PlaneInfo>& planes,
-                               uint32_t& totalSize,
-                               QString& errorString)
+///
+/// Samples the tiled framebuffer in place, i.e. only the pixels kept by the resampler's decimation are read
+/// and the framebuffer is not converted to a linear copy first.
+///
+static bool processBroadcomTiledFramebuffer(int deviceFd,
+                                            const drmModeFB2* framebuffer,
+                                            int w,
+                                            int h,
+                                            PixelFormat pixelFormat,
+                                            ImageResampler const& imageResampler,
+                                            Logger* log,
+                                            Image<ColorRgb>& image,
+                                            QString& errorString)
 {
-    planes.clear();
-    totalSize = 0;
-
-    switch (fmt)
-    {
-    case PixelFormat::NV12:
-    {
-        // Pack tightly: Y then interleaved UV
-        auto const  y_stride = (uint32_t)w;
-        auto const uv_stride = (uint32_t)w; // interleaved, one byte per pixel on luma grid
-
-        PlaneInfo y{};
-        y.bpp = 8;
-        y.width = w;
-        y.height = h;
-        y.stride = (int)y_stride;
-        y.fbPlaneIdx = 0;
-        y.srcBaseOffset = fb->offsets[y.fbPlaneIdx];
-        y.dstBaseOffset = 0;
-        planes.push_back(y);
-
-        PlaneInfo uv{};
-        uv.bpp = 16; // two 8-bit chroma bytes per 2 luma samples horizontally
-        uv.width = DIV_ROUND_UP(w, 2);
-        uv.height = DIV_ROUND_UP(h, 2);
-        uv.stride = (int)uv_stride;
-        uv.fbPlaneIdx = 1;
-        uv.srcBaseOffset = fb->offsets[uv.fbPlaneIdx];
-        uv.dstBaseOffset = (size_t)w * (size_t)h;
-        planes.push_back(uv);
-
-        totalSize = (uint32_t)((w * h) + (w * h) / 2);
-        return true;
-    }
-
-#ifdef DRM_FORMAT_NV21
-    case PixelFormat::NV21:
+    ImageResampler::TiledLayout layout;
+    if (!getBroadcomTiledLayout(framebuffer, layout, errorString))
     {
-        // Identical plane sizes to NV12; chroma order is VU (handled by resampler)
-        auto const y_stride = (uint32_t)w;
-        auto const uv_stride = (uint32_t)w;
-
-        PlaneInfo y{};
-        y.bpp = 8;
-        y.width = w;
-        y.height = h;
-        y.stride = (int)y_stride;
-        y.fbPlaneIdx = 0;
-        y.srcBaseOffset = fb->offsets[y.fbPlaneIdx];
-        y.dstBaseOffset = 0;
-        planes.push_back(y);
-
-        PlaneInfo vu{};
-        vu.bpp = 16;
-        vu.width = DIV_ROUND_UP(w, 2);
-        vu.height = DIV_ROUND_UP(h, 2);
-        vu.stride = (int)uv_stride;
-        vu.fbPlaneIdx = 1;
-        vu.srcBaseOffset = fb->offsets[vu.fbPlaneIdx];
-        vu.dstBaseOffset = (size_t)w * (size_t)h;
-        planes.push_back(vu);
-
-        totalSize = (uint32_t)((w * h) + (w * h) / 2);
-        return true;
-    }
-#endif
-
-#ifdef DRM_FORMAT_P030
-    case PixelFormat::P030:
-    {
-        // 10-bit semi-planar: Y in 16-bit words, UV packed 2x10b per 2 luma pixels => 32b per pair
-        auto const y_stride = (uint32_t)(w * 2);
-        auto const uv_stride = (uint32_t)(w * 2); // (w/2)*4 bytes == 2*w bytes
-
-        PlaneInfo y{};
-        y.bpp = 16;
-        y.width = w;
-        y.height = h;
-        y.stride = (int)y_stride;
-        y.fbPlaneIdx = 0;
-        y.srcBaseOffset = fb->offsets[y.fbPlaneIdx];
-        y.dstBaseOffset = 0;
-        planes.push_back(y);
-
-        PlaneInfo uv{};
-        uv.bpp = 32;
-        uv.width = DIV_ROUND_UP(w, 2);
-        uv.height = DIV_ROUND_UP(h, 2);
-        uv.stride = (int)uv_stride;
-        uv.fbPlaneIdx = 1;
-        uv.srcBaseOffset = fb->offsets[uv.fbPlaneIdx];
-        uv.dstBaseOffset = (size_t)w * (size_t)h * 2;
-        planes.push_back(uv);
-
-        totalSize = (uint32_t)((size_t)w * (size_t)h * 3); // Y(2*w*h) + UV(w*h)
-        return true;
-    }
-#endif
-
-    default:
-        errorString = QString("Broadcom SAND: unsupported PixelFormat %1")
-                          .arg(QSTRING_CSTR(pixelFormatToString(fmt)));
         return false;
     }
-}
-
-static inline void copyBroadcomSandPlane(const PlaneInfo& p,
-                                         int lumaWidth,
-                                         uint32_t columnWidthBytes,
-                                         uint32_t columnHeight,
-                                         const uint8_t* src,
-                                         uint8_t* dst,
-                                         Logger* log)
-{
-    const uint32_t columnSize = columnWidthBytes * columnHeight;
-    // Keep proportional column width logic relative to luma width
-    const size_t columnWidthInPixels = (size_t)(columnWidthBytes) * (size_t)p.width / std::max(1, lumaWidth);
 
-    for (int i = 0; i < p.height; i++)
+    const size_t size = ImageResampler::tiledImageSize(w, h, layout, pixelFormat);
+    if (size == 0)
     {
-        for (int j = 0; j < p.width; j++)
-        {
-            size_t src_offset = p.srcBaseOffset;
-            size_t dst_offset = p.dstBaseOffset;
-
-            src_offset += vc4_sand_tiled_offset(columnWidthInPixels, columnSize, (size_t)j, (size_t)i, (size_t)p.bpp);
-            dst_offset += (size_t)p.stride * (size_t)i + (size_t)j * (size_t)p.bpp / 8u;
-
-            switch (p.bpp)
-            {
-            case 8:
-                *(dst + dst_offset) = *(src + src_offset);
-                break;
-            case 16:
-                *(uint16_t*)(dst + dst_offset) = *(const uint16_t*)(src + src_offset);
-                break;
-            case 32:
-                *(uint32_t*)(dst + dst_offset) = *(const uint32_t*)(src + src_offset);
-                break;
-            default:
-                Error(log, "Unsupported bpp %d in Broadcom SAND layout", p.bpp);
-                break;
-            }
-        }
+        errorString = QString("Currently unsupported format: %1 with modifier: %2")
+                          .arg(getDrmFormat(framebuffer->pixel_format))
+                          .arg(getDrmModifierName(framebuffer->modifier));
+        return false;
     }
-}
 
-static bool untileBroadcomSandToLinear(int deviceFd,
-                                       const drmModeFB2* fb,
-                                       int w,
-                                       int h,
-                                       PixelFormat fmt,
-                                       const std::vector<PlaneInfo>& planes,
-                                       uint32_t totalSize,
-                                       ImageResampler const& imageResampler,
-                                       Logger* log,
-                                       Image<ColorRgb>& image)
-{
     int fb_dmafd = 0;
-    int ret = drmPrimeHandleToFD(deviceFd, fb->handles[0], O_RDONLY, &fb_dmafd);
+    int ret = drmPrimeHandleToFD(deviceFd, framebuffer->handles[0], O_RDONLY, &fb_dmafd);
     if (ret < 0)
     {
-        Error(log, "drmPrimeHandleToFD failed (broadcom handle=%u): %s", fb->handles[0], strerror(errno));
-        return false;
-    }
-
-    if (totalSize == 0)
-    {
-        Error(log, "Computed framebuffer size is 0 for Broadcom SAND layout");
-        close(fb_dmafd);
-        return false;
-    }
-
-    auto* src_buf = (uint8_t*)mmap(nullptr, totalSize, PROT_READ, MAP_SHARED, fb_dmafd, 0);
-    if (src_buf == MAP_FAILED)
-    {
-        close(fb_dmafd);
+        Error(log, "drmPrimeHandleToFD failed (broadcom handle=%u): %s", framebuffer->handles[0], strerror(errno));
         return false;
     }
 
-    std::vector<uint8_t> dst_buf(totalSize);
-    uint8_t* dst_ptr = dst_buf.data();
-
-    uint32_t columnWidthBytes = 0;
-    uint32_t columnHeight = 0;
-    QString geomErr;
-    if (!getBroadcomSandGeometry(fb->modifier, columnWidthBytes, columnHeight, geomErr))
+    auto* mmapFrameBuffer = (uint8_t*)mmap(nullptr, size, PROT_READ, MAP_SHARED, fb_dmafd, 0);
+    if (mmapFrameBuffer == MAP_FAILED)
     {
-        munmap(src_buf, totalSize);
+        Error(log, "Format: %s failed. Error: %s", QSTRING_CSTR(getDrmFormat(framebuffer->pixel_format)), strerror(errno));
         close(fb_dmafd);
         return false;
     }
 
-    for (const auto& p : planes)
-    {
-        copyBroadcomSandPlane(p, w, columnWidthBytes, columnHeight, src_buf, dst_ptr, log);
-    }
-
-    int lineLength = w;
-#ifdef DRM_FORMAT_P030
-    if (fmt == PixelFormat::P030)
-        lineLength = w * 2;
-#endif
-
-    imageResampler.processImage(dst_ptr, w, h, lineLength, fmt, image);
+    const bool isProcessed = imageResampler.processTiledImage(mmapFrameBuffer, w, h, layout, pixelFormat, image);
 
-    munmap(src_buf, totalSize);
+    munmap(mmapFrameBuffer, size);
     close(fb_dmafd);
-    return true;
-}
-
-static bool processBroadcomSandFramebuffer(int deviceFd,
-                                           const drmModeFB2* framebuffer,
-                                           int w,
-                                           int h,
-                                           PixelFormat pixelFormat,
-                                           ImageResampler const& imageResampler,
-                                           Logger* log,
-                                           Image<ColorRgb>& image,
-                                           QString& errorString)
-{
-    uint32_t columnWidthBytes = 0;
-    uint32_t columnHeight = 0;
-    if (!getBroadcomSandGeometry(framebuffer->modifier, columnWidthBytes, columnHeight, errorString))
-    {
-        return false;
-    }
-
-    std::vector<PlaneInfo> planes;
-    uint32_t totalSize = 0;
-    if (!getPlanesForFormat(pixelFormat, w, h, columnWidthBytes, framebuffer, planes, totalSize, errorString))
-    {
-        return false;
-    }
-
-    if (totalSize == 0)
-    {
-        Error(log, "Computed framebuffer size is 0 for Broadcom SAND layout");
-        return false;
-    }
-
-    return untileBroadcomSandToLinear(deviceFd, framebuffer, w, h, pixelFormat, planes, totalSize, imageResampler, log, image);
+    return isProcessed;
 }
 
 int DRMFrameGrabber::grabFrame(Image<ColorRgb> &image, bool /*forceUpdate*/)
@@ -597,8 +548,17 @@ int DRMFrameGrabber::grabFrame(Image<ColorRgb> &image, bool /*forceUpdate*/)
     bool newImage{false};
     QString errorString;
 
-    // We only need to process the first framebuffer.
-    auto it = _framebuffers.begin();
+    if (_eventDriven && !_isVblankRequested && _vblankNotifier != nullptr && !requestVblank())
+    {
+        qCDebug(grabber_screen_flow) << "Vertical blank request failed:" << strerror(errno);
+    }
+
+    // We only need to process the framebuffer shown by the primary plane.
+    auto it = _framebuffers.find(_currentFbId);
+    if (it == _framebuffers.end())
+    {
+        it = _framebuffers.begin();
+    }
     if (it != _framebuffers.end())
     {
         const auto& [id, framebuffer] = *it;
@@ -636,10 +596,10 @@ int DRMFrameGrabber::grabFrame(Image<ColorRgb> &image, bool /*forceUpdate*/)
                 newImage = true;
             }
         }
-        // Broadcom SAND path
+        // Broadcom SAND and VC4 T-tiled path
         else if ((modifier >> 56ULL) == DRM_FORMAT_MOD_VENDOR_BROADCOM)
         {
-            if (processBroadcomSandFramebuffer(_deviceFd, framebuffer, w, h, _pixelFormat, _imageResampler, _log.data(), image, errorString))
+            if (processBroadcomTiledFramebuffer(_deviceFd, framebuffer, w, h, _pixelFormat, _imageResampler, _log.data(), image, errorString))
             {
                 newImage = true;
             }
@@ -698,6 +658,8 @@ bool DRMFrameGrabber::openDevice()
 
 bool DRMFrameGrabber::closeDevice()
 {
+    freeVblank();
+
     if (_deviceFd < 0)
     {
         return true;
@@ -848,6 +810,7 @@ void DRMFrameGrabber::findActiveCrtc(const drmModeRes* resources)
         _crtc = drmModeGetCrtc(_deviceFd, resources->crtcs[i]);
         if (_crtc && _crtc->mode_valid)
         {
+            _crtcIndex = i;
             return; // Found active CRTC, so we can exit
         }
         drmModeFreeCrtc(_crtc);
@@ -943,6 +906,7 @@ void DRMFrameGrabber::getFramebuffers()
 			continue;
 		}
 		_framebuffers.insert({plane->fb_id, fb});
+		_currentFbId = plane->fb_id;
 	}
 }
 
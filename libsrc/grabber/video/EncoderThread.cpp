@@ -4,7 +4,11 @@
 
 EncoderThread::EncoderThread()
 	: _localData(nullptr)
+	, _frameData(nullptr)
+	, _sequence(0)
 	, _scalingFactorsCount(0)
+	, _scaleDenominator(1)
+	, _resampleDecoded(false)
 	, _doTransform(false)
 	, _imageResampler()
 	, _tjInstance(nullptr)
@@ -18,6 +22,8 @@ EncoderThread::EncoderThread()
 
 EncoderThread::~EncoderThread()
 {
+	releaseFrameData();
+
 #ifdef HAVE_TURBO_JPEG
 	if (_tjInstance)
 		tjDestroy(_tjInstance);
@@ -38,8 +44,10 @@ void EncoderThread::setup(
 		PixelFormat pixelFormat, uint8_t* sharedData,
 		int size, int width, int height, int lineLength,
 		int cropLeft, int cropTop, int cropBottom, int cropRight,
-		VideoMode videoMode, FlipMode flipMode, int pixelDecimation)
+		VideoMode videoMode, FlipMode flipMode, int pixelDecimation, bool boxFilter,
+		quint64 sequence, std::function<void()> releaseData)
 {
+	_sequence = sequence;
 	_lineLength = lineLength;
 	_pixelFormat = pixelFormat;
 	_size = static_cast<unsigned long>(size);
@@ -66,7 +74,38 @@ void EncoderThread::setup(
 		needTransform = false;
 	}
 
+	int cropLeftScaled {_cropLeft};
+	int cropRightScaled {_cropRight};
+	int cropTopScaled {_cropTop};
+	int cropBottomScaled {_cropBottom};
+	int remainingDecimation {_pixelDecimation};
+	FlipMode resamplerFlipMode {_flipMode};
+
 #ifdef HAVE_TURBO_JPEG
+	_scaleDenominator = (_pixelFormat == PixelFormat::MJPEG) ? scaleDenominator(_pixelDecimation) : 1;
+	if (_scaleDenominator > 1)
+	{
+		// The frame is decoded at a reduced scale. Cropping, flipping and the remaining decimation are done by the
+		// resampler on the (small) decoded image, i.e. the lossless transform of the full-size frame is not required.
+		remainingDecimation = qMax(1, (_pixelDecimation + _scaleDenominator / 2) / _scaleDenominator);
+		_resampleDecoded = needTransform || remainingDecimation > 1;
+		needTransform = false;
+		cropLeftScaled /= _scaleDenominator;
+		cropRightScaled /= _scaleDenominator;
+		cropTopScaled /= _scaleDenominator;
+		cropBottomScaled /= _scaleDenominator;
+
+		// Keep the orientation of the transform: the resampler's horizontal flip is the transform's vertical one
+		if (_flipMode == FlipMode::HORIZONTAL)
+		{
+			resamplerFlipMode = FlipMode::VERTICAL;
+		}
+		else if (_flipMode == FlipMode::VERTICAL)
+		{
+			resamplerFlipMode = FlipMode::HORIZONTAL;
+		}
+	}
+
 	if (_doTransform != needTransform )
 	{
 		if (_tjInstance != nullptr)
@@ -79,10 +118,20 @@ void EncoderThread::setup(
 #endif
 
 	_imageResampler.setVideoMode(_videoMode);
-	_imageResampler.setFlipMode(_flipMode);
-	_imageResampler.setCropping(_cropLeft, _cropRight, _cropTop, _cropBottom);
-	_imageResampler.setHorizontalPixelDecimation(_pixelDecimation);
-	_imageResampler.setVerticalPixelDecimation(_pixelDecimation);
+	_imageResampler.setFlipMode(resamplerFlipMode);
+	_imageResampler.setCropping(cropLeftScaled, cropRightScaled, cropTopScaled, cropBottomScaled);
+	_imageResampler.setHorizontalPixelDecimation(remainingDecimation);
+	_imageResampler.setVerticalPixelDecimation(remainingDecimation);
+	_imageResampler.setBoxFilter(boxFilter);
+
+	if (releaseData)
+	{
+		// Decode in place, the owner gets the data back once processed
+		_busy = true;
+		_releaseData = std::move(releaseData);
+		_frameData = sharedData;
+		return;
+	}
 
 #ifdef HAVE_TURBO_JPEG
 	if (_localData != nullptr)
@@ -105,24 +154,36 @@ void EncoderThread::setup(
 	{
 		memcpy(_localData, sharedData, static_cast<size_t>(size));
 	}
+	_frameData = _localData;
+}
+
+void EncoderThread::releaseFrameData()
+{
+	if (_releaseData)
+	{
+		const std::function<void()> releaseData = std::move(_releaseData);
+		_releaseData = nullptr;
+		_frameData = nullptr;
+		releaseData();
+	}
 }
 
 void EncoderThread::process()
 {
 	_busy = true;
+	Image<ColorRgb> image = Image<ColorRgb>();
 	if (_width > 0 && _height > 0)
 	{
 #ifdef HAVE_TURBO_JPEG
 		if (_pixelFormat == PixelFormat::MJPEG)
 		{
-			processImageMjpeg();
+			image = processImageMjpeg();
 		}
 		else
 #endif
 		{
-			Image<ColorRgb> image = Image<ColorRgb>();
 			_imageResampler.processImage(
-				_localData,
+				_frameData,
 				_width,
 				_height,
 				_lineLength,
@@ -133,16 +194,94 @@ void EncoderThread::process()
 #endif
 				image
 			);
-
-			emit newFrame(image);
 		}
 	}
+
+	// The image is decoded, release lent data before handing the image over
+	releaseFrameData();
+	emit newFrame(_sequence, image);
 	_busy = false;
 }
 
 #ifdef HAVE_TURBO_JPEG
-void EncoderThread::processImageMjpeg()
+int EncoderThread::scaleDenominator(int pixelDecimation) const
+{
+	// Only the power-of-two scales are decoded by the fast (SIMD) IDCT variants of libjpeg-turbo
+	for (const int denominator : {8, 4, 2})
+	{
+		if (denominator > pixelDecimation)
+		{
+			continue;
+		}
+
+		for (int i = 0; i < _scalingFactorsCount; i++)
+		{
+			if (_scalingFactors[i].num == 1 && _scalingFactors[i].denom == denominator)
+			{
+				return denominator;
+			}
+		}
+	}
+	return 1;
+}
+
+Image<ColorRgb> EncoderThread::processImageMjpegScaled()
 {
+	if (!_tjInstance)
+	{
+		_tjInstance = tjInitDecompress();
+	}
+
+	int inSubsamp {0};
+	if (tjDecompressHeader2(_tjInstance, _frameData, _size, &_width, &_height, &inSubsamp) < 0)
+	{
+		if (onError("get image details - tjDecompressHeader2"))
+		{
+			return Image<ColorRgb>();
+		}
+	}
+
+	const tjscalingfactor scalingFactor {1, _scaleDenominator};
+	const int width = TJSCALED(_width, scalingFactor);
+	const int height = TJSCALED(_height, scalingFactor);
+
+	// Without further processing, the frame is decoded straight into the output image
+	Image<ColorRgb> image;
+	Image<ColorRgb>& decodedImage = _resampleDecoded ? _decodedImage : image;
+	decodedImage.resize(width, height);
+
+	if (tjDecompress2(_tjInstance, _frameData, _size,
+					  reinterpret_cast<unsigned char*>(decodedImage.memptr()), width, 0, height,
+					  TJPF_RGB, TJFLAG_FASTDCT | TJFLAG_FASTUPSAMPLE)
+		< 0)
+	{
+		if (onError("get final image - tjDecompress2"))
+		{
+			return Image<ColorRgb>();
+		}
+	}
+
+	if (_resampleDecoded)
+	{
+		// The decoded image is owned by the thread and reused, the output image is the only one allocated per frame
+		releaseFrameData();
+		_imageResampler.processImage(reinterpret_cast<const uint8_t*>(_decodedImage.memptr()), width, height,
+									 static_cast<size_t>(width) * sizeof(ColorRgb), PixelFormat::RGB24, image);
+	}
+	else
+	{
+		image.updateFingerprint();
+	}
+	return image;
+}
+
+Image<ColorRgb> EncoderThread::processImageMjpeg()
+{
+	if (_scaleDenominator > 1)
+	{
+		return processImageMjpegScaled();
+	}
+
 	int inSubsamp {0};
 	int inColorspace {0};
 
@@ -154,11 +293,11 @@ void EncoderThread::processImageMjpeg()
 			_xform = new tjtransform();
 		}
 
-		if (tjDecompressHeader3(_tjInstance, _localData, _size, &_width, &_height, &inSubsamp, &inColorspace) < 0)
+		if (tjDecompressHeader3(_tjInstance, _frameData, _size, &_width, &_height, &inSubsamp, &inColorspace) < 0)
 		{
 			if (onError("_doTransform - tjDecompressHeader3"))
 			{
-				return;
+				return Image<ColorRgb>();
 			}
 		}
 
@@ -235,16 +374,22 @@ void EncoderThread::processImageMjpeg()
 		unsigned char *dstBuf = nullptr;  /* Dynamically allocate the JPEG buffer */
 		unsigned long dstSize = 0;
 
-		if(tjTransform(_tjInstance, _localData, _size, 1, &dstBuf, &dstSize, _xform, TJFLAG_FASTDCT | TJFLAG_FASTUPSAMPLE) < 0 )
+		if(tjTransform(_tjInstance, _frameData, _size, 1, &dstBuf, &dstSize, _xform, TJFLAG_FASTDCT | TJFLAG_FASTUPSAMPLE) < 0 )
 		{
 			if (onError("_doTransform - tjTransform"))
 			{
-				return;
+				return Image<ColorRgb>();
 			}
 		}
 
-		tjFree(_localData);
+		// The transformed frame is decoded from an owned buffer
+		releaseFrameData();
+		if (_localData != nullptr)
+		{
+			tjFree(_localData);
+		}
 		_localData = dstBuf;
+		_frameData = _localData;
 		_size = dstSize;
 	}
 	else
@@ -257,66 +402,38 @@ void EncoderThread::processImageMjpeg()
 
 	if (_doTransform)
 	{
-		if (tjDecompressHeader3(_tjInstance, _localData, _size, &_width, &_height,	&inSubsamp, &inColorspace) < 0)
+		if (tjDecompressHeader3(_tjInstance, _frameData, _size, &_width, &_height,	&inSubsamp, &inColorspace) < 0)
 		{
 			if (onError("get image details - tjDecompressHeader3"))
 			{
-				return;
+				return Image<ColorRgb>();
 			}
 		}
 	}
 	else
 	{
-		if (tjDecompressHeader2(_tjInstance, _localData, _size, &_width, &_height, &inSubsamp) < 0)
+		if (tjDecompressHeader2(_tjInstance, _frameData, _size, &_width, &_height, &inSubsamp) < 0)
 		{
 			if (onError("get image details - tjDecompressHeader2"))
 			{
-				return;
-			}
-		}
-	}
-
-	if(_scalingFactors != nullptr && _pixelDecimation > 1)
-	{
-		//Scaling factors will not do map 1:1 to pixel decimation, but do a best match
-		//In case perfect pixel decimation is required, code needs to make use of a interim image.
-
-		bool scaleingFactorFound {false};
-		for (int i = 0; i < _scalingFactorsCount ; i++)
-		{
-			const int tempWidth = TJSCALED(_width, _scalingFactors[i]);
-			const int tempHeight = TJSCALED(_height, _scalingFactors[i]);
-
-			if (tempWidth <= _width/_pixelDecimation && tempHeight <= _height/_pixelDecimation)
-			{
-				_width = tempWidth;
-				_height = tempHeight;
-				scaleingFactorFound = true;
-				break;
+				return Image<ColorRgb>();
 			}
 		}
-
-		if (!scaleingFactorFound)
-		{
-			//Set to smallest scaling factor
-			_width = TJSCALED(_width, _scalingFactors[_scalingFactorsCount-1]);
-			_height = TJSCALED(_height, _scalingFactors[_scalingFactorsCount-1]);
-		}
 	}
 
 	Image<ColorRgb> srcImage(_width, _height);
 
-	if (tjDecompress2(_tjInstance, _localData , _size,
+	if (tjDecompress2(_tjInstance, _frameData , _size,
 					  reinterpret_cast<unsigned char*>(srcImage.memptr()), _width, 0, _height,
 					  TJPF_RGB, TJFLAG_FASTDCT | TJFLAG_FASTUPSAMPLE)
 		< 0)
 	{
 		if (onError("get final image - tjDecompress2"))
 		{
-			return;
+			return Image<ColorRgb>();
 		}
 	}
-	emit newFrame(srcImage);
+	return srcImage;
 }
 #endif
 
@@ -337,3 +454,131 @@ bool EncoderThread::onError(const QString context) const
 return treatAsError;
 }
 #endif
+
+EncoderThreadManager::EncoderThreadManager(QObject *parent)
+	: QObject(parent)
+{
+	_threads = new Thread<EncoderThread>*[_threadCount];
+	for (int i = 0; i < _threadCount; i++)
+	{
+		_threads[i] = new Thread<EncoderThread>(new EncoderThread, this);
+		_threads[i]->setObjectName("Encoder " + QString::number(i));
+	}
+}
+
+EncoderThreadManager::~EncoderThreadManager()
+{
+	if (_threads != nullptr)
+	{
+		for(int i = 0; i < _threadCount; i++)
+		{
+			_threads[i]->deleteLater();
+			_threads[i] = nullptr;
+		}
+
+		delete[] _threads;
+		_threads = nullptr;
+	}
+}
+
+void EncoderThreadManager::start()
+{
+	_framesInFlight = 0;
+	_nextEmitSequence = _nextSequence;
+	_decodedFrames = 0;
+	_droppedFrames = 0;
+	_staleFrames = 0;
+
+	if (_threads != nullptr)
+		for (int i = 0; i < _threadCount; i++)
+			connect(_threads[i]->thread(), &EncoderThread::newFrame, this, &EncoderThreadManager::handleFrame);
+}
+
+void EncoderThreadManager::stop()
+{
+	if (_threads != nullptr)
+		for(int  i = 0; i < _threadCount; i++)
+			disconnect(_threads[i]->thread(), nullptr, nullptr, nullptr);
+}
+
+void EncoderThreadManager::setQueueDepth(int queueDepth)
+{
+	_queueDepth = qMax(queueDepth, 0);
+}
+
+bool EncoderThreadManager::process(
+		PixelFormat pixelFormat, uint8_t* sharedData,
+		int size, int width, int height, int lineLength,
+		int cropLeft, int cropTop, int cropBottom, int cropRight,
+		VideoMode videoMode, FlipMode flipMode, int pixelDecimation, bool boxFilter,
+		std::function<void()> releaseData)
+{
+	const int queueDepth = (_queueDepth > 0) ? qMin(_queueDepth.load(), _threadCount) : _threadCount;
+
+	if (_threads != nullptr && _framesInFlight < queueDepth)
+	{
+		for (int i = 0; i < _threadCount; i++)
+		{
+			if (!_threads[i]->isBusy())
+			{
+				const quint64 sequence = _nextSequence++;
+				++_framesInFlight;
+
+				if (releaseData)
+				{
+					_threads[i]->setup(pixelFormat, sharedData, size, width, height, lineLength, cropLeft, cropTop, cropBottom, cropRight, videoMode, flipMode, pixelDecimation, boxFilter, sequence, std::move(releaseData));
+					_threads[i]->processAsync();
+				}
+				else
+				{
+					_threads[i]->setup(pixelFormat, sharedData, size, width, height, lineLength, cropLeft, cropTop, cropBottom, cropRight, videoMode, flipMode, pixelDecimation, boxFilter, sequence);
+					_threads[i]->process();
+				}
+				return true;
+			}
+		}
+	}
+
+	// Back pressure: the frame is dropped at capture instead of queuing up
+	++_droppedFrames;
+	return false;
+}
+
+void EncoderThreadManager::handleFrame(quint64 sequence, const Image<ColorRgb>& image)
+{
+	if (_framesInFlight > 0)
+	{
+		--_framesInFlight;
+	}
+
+	if (image.isNull())
+	{
+		++_droppedFrames;
+		return;
+	}
+	++_decodedFrames;
+
+	if (sequence < _nextEmitSequence)
+	{
+		// A newer frame has already been emitted, emitting this one would step back in time
+		++_staleFrames;
+		++_droppedFrames;
+		return;
+	}
+
+	_nextEmitSequence = sequence + 1;
+	emit newFrame(image);
+}
+
+QJsonObject EncoderThreadManager::getStatistics() const
+{
+	const int queueDepth = (_queueDepth > 0) ? qMin(_queueDepth.load(), _threadCount) : _threadCount;
+
+	QJsonObject statistics;
+	statistics["decodedFrames"] = static_cast<double>(_decodedFrames.load());
+	statistics["droppedFrames"] = static_cast<double>(_droppedFrames.load());
+	statistics["staleFrames"] = static_cast<double>(_staleFrames.load());
+	statistics["queueDepth"] = queueDepth;
+	statistics["threads"] = _threadCount;
+	return statistics;
+}
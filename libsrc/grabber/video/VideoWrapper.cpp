@@ -76,6 +76,7 @@ void VideoWrapper::handleSettingsUpdate(settings::type type, const QJsonDocument
 
 			// Image size decimation
 			_grabber.setPixelDecimation(obj["sizeDecimation"].toInt(8));
+			_grabber.setBoxFilter(obj["boxFilter"].toBool(false));
 
 			// Flip mode
 			_grabber.setFlipMode(parseFlipMode(obj["flip"].toString("NO_CHANGE")));
@@ -97,6 +98,9 @@ void VideoWrapper::handleSettingsUpdate(settings::type type, const QJsonDocument
 			// Software frame skipping
 			_grabber.setFpsSoftwareDecimation(obj["fpsSoftwareDecimation"].toInt(1));
 
+			// Frames decoded at the same time
+			_grabber.setDecoderQueueDepth(obj["decoderQueueDepth"].toInt(0));
+
 			// Signal detection
 			_grabber.setSignalDetectionEnable(obj["signalDetection"].toBool(true));
 			_grabber.setSignalDetectionOffset(
@@ -81,7 +81,10 @@ bool MFGrabber::prepare()
 			_sourceReaderCB = new SourceReaderCB(this);
 
 		if (!_threadManager)
+		{
 			_threadManager = new EncoderThreadManager(this);
+			_threadManager->setQueueDepth(_decoderQueueDepth);
+		}
 
 		return (_sourceReaderCB != nullptr && _threadManager != nullptr);
 	}
@@ -557,15 +560,7 @@ void MFGrabber::process_image(const void *frameImageBuffer, int size)
 		Error(_log, "Frame too small: %d != %d", size, _frameByteSize);
 	else if (_threadManager != nullptr)
 	{
-		for (int i = 0; i < _threadManager->_threadCount; i++)
-		{
-			if (!_threadManager->_threads[i]->isBusy())
-			{
-				_threadManager->_threads[i]->setup(_pixelFormat, (uint8_t*)frameImageBuffer, size, _width, _height, _lineLength, _cropLeft, _cropTop, _cropBottom, _cropRight, _videoMode, _flipMode, _pixelDecimation);
-				_threadManager->_threads[i]->process();
-				break;
-			}
-		}
+		_threadManager->process(_pixelFormat, (uint8_t*)frameImageBuffer, size, _width, _height, _lineLength, _cropLeft, _cropTop, _cropBottom, _cropRight, _videoMode, _flipMode, _pixelDecimation, _boxFilter);
 	}
 }
 
@@ -652,6 +647,20 @@ bool MFGrabber::setWidthHeight(int width, int height)
 	 return false;
 }
 
+void MFGrabber::setDecoderQueueDepth(int queueDepth)
+{
+	_decoderQueueDepth = queueDepth;
+	if (_threadManager != nullptr)
+	{
+		_threadManager->setQueueDepth(queueDepth);
+	}
+}
+
+QJsonObject MFGrabber::getStatistics() const
+{
+	return (_threadManager != nullptr) ? _threadManager->getStatistics() : QJsonObject();
+}
+
 void MFGrabber::setEncoding(QString enc)
 {
 	if (_pixelFormatConfig != parsePixelFormat(enc))
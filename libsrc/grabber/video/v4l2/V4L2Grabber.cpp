@@ -162,7 +162,10 @@ V4L2Grabber::~V4L2Grabber()
 bool V4L2Grabber::prepare()
 {
 	if (!_threadManager)
+	{
 		_threadManager = new EncoderThreadManager(this);
+		_threadManager->setQueueDepth(_decoderQueueDepth);
+	}
 
 	return (_threadManager != nullptr);
 }
@@ -402,7 +405,7 @@ void V4L2Grabber::init_mmap()
 
 	CLEAR(req);
 
-	req.count = 4;
+	req.count = captureBufferCount();
 	req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
 	req.memory = V4L2_MEMORY_MMAP;
 
@@ -928,6 +931,17 @@ void V4L2Grabber::uninit_device()
 
 		case IO_METHOD_MMAP:
 		{
+			// Encoder threads may still decode from lent buffers
+			const bool isReleased = waitForLentBuffers();
+			++_bufferGeneration;
+
+			if (!isReleased)
+			{
+				// Unmapping would pull the memory from under the encoder threads, the mappings are leaked instead
+				Error(_log, "%d capture buffers are still in use by the encoder threads, %d buffers are not unmapped", _lentBuffers.load(), static_cast<int>(_buffers.size()));
+				break;
+			}
+
 			for (size_t i = 0; i < _buffers.size(); ++i)
 				if (-1 == munmap(_buffers[i].start, _buffers[i].length))
 				{
@@ -1101,9 +1115,10 @@ int V4L2Grabber::read_frame()
 
 				assert(buf.index < _buffers.size());
 
-				rc = process_image(_buffers[buf.index].start, buf.bytesused);
+				// The buffer is lent to an encoder thread and queued again once decoded
+				rc = process_image(_buffers[buf.index].start, buf.bytesused, static_cast<int>(buf.index));
 
-				if (-1 == xioctl(VIDIOC_QBUF, &buf))
+				if (!rc && -1 == xioctl(VIDIOC_QBUF, &buf))
 				{
 					throw_errno_exception("VIDIOC_QBUF");
 					return 0;
@@ -1164,7 +1179,7 @@ int V4L2Grabber::read_frame()
 	return rc ? 1 : 0;
 }
 
-bool V4L2Grabber::process_image(const void *p, int size)
+bool V4L2Grabber::process_image(const void *p, int size, int bufferIndex)
 {
 	int processFrameIndex = _currentFrame++, result = false;
 
@@ -1182,21 +1197,75 @@ bool V4L2Grabber::process_image(const void *p, int size)
 	}
 	else if (_threadManager != nullptr)
 	{
-		for (int i = 0; i < _threadManager->_threadCount; i++)
+		if (bufferIndex >= 0)
 		{
-			if (!_threadManager->_threads[i]->isBusy())
+			// Decode directly from the capture buffer on an encoder thread
+			const int generation = _bufferGeneration;
+			++_lentBuffers;
+			result = _threadManager->process(_pixelFormat, (uint8_t*)p, size, _width, _height, _lineLength, _cropLeft, _cropTop, _cropBottom, _cropRight, _videoMode, _flipMode, _pixelDecimation, _boxFilter,
+				[this, bufferIndex, generation]()
+				{
+					QMetaObject::invokeMethod(this, "requeueBuffer", Qt::QueuedConnection, Q_ARG(int, bufferIndex), Q_ARG(int, generation));
+					--_lentBuffers;
+				});
+
+			if (!result)
 			{
-				_threadManager->_threads[i]->setup(_pixelFormat, (uint8_t*)p, size, _width, _height, _lineLength, _cropLeft, _cropTop, _cropBottom, _cropRight, _videoMode, _flipMode, _pixelDecimation);
-				_threadManager->_threads[i]->process();
-				result = true;
-				break;
+				--_lentBuffers;
 			}
 		}
+		else
+		{
+			result = _threadManager->process(_pixelFormat, (uint8_t*)p, size, _width, _height, _lineLength, _cropLeft, _cropTop, _cropBottom, _cropRight, _videoMode, _flipMode, _pixelDecimation, _boxFilter);
+		}
 	}
 
 	return result;
 }
 
+void V4L2Grabber::requeueBuffer(int index, int generation)
+{
+	if (generation != _bufferGeneration || index < 0 || index >= static_cast<int>(_buffers.size()))
+	{
+		return;
+	}
+
+	struct v4l2_buffer buf;
+
+	CLEAR(buf);
+	buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+	buf.memory = V4L2_MEMORY_MMAP;
+	buf.index = static_cast<__u32>(index);
+
+	if (-1 == xioctl(VIDIOC_QBUF, &buf))
+	{
+		throw_errno_exception("VIDIOC_QBUF");
+	}
+}
+
+unsigned int V4L2Grabber::captureBufferCount() const
+{
+	// Every encoder thread may hold a lent buffer, while the driver keeps filling at least two others
+	const int threadCount = (_threadManager != nullptr) ? _threadManager->_threadCount : DEFAULT_THREAD_COUNT;
+	return static_cast<unsigned int>(qBound(4, threadCount + 2, static_cast<int>(VIDEO_MAX_FRAME)));
+}
+
+bool V4L2Grabber::waitForLentBuffers()
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	while (_lentBuffers.load() > 0)
+	{
+		if (timer.elapsed() > 1000)
+		{
+			return false;
+		}
+		QThread::msleep(1);
+	}
+	return true;
+}
+
 void V4L2Grabber::newThreadFrame(const Image<ColorRgb>& image)
 {
 	if (_standbyActivated)
@@ -1329,6 +1398,20 @@ bool V4L2Grabber::setWidthHeight(int width, int height)
 	 return false;
 }
 
+void V4L2Grabber::setDecoderQueueDepth(int queueDepth)
+{
+	_decoderQueueDepth = queueDepth;
+	if (_threadManager != nullptr)
+	{
+		_threadManager->setQueueDepth(queueDepth);
+	}
+}
+
+QJsonObject V4L2Grabber::getStatistics() const
+{
+	return (_threadManager != nullptr) ? _threadManager->getStatistics() : QJsonObject();
+}
+
 void V4L2Grabber::setEncoding(QString enc)
 {
 	if(_pixelFormatConfig != parsePixelFormat(enc))
@@ -4,6 +4,12 @@
 #include <xcb/randr.h>
 #include <xcb/xcb_event.h>
 
+#ifdef HAVE_X11_XDAMAGE
+#include <X11/extensions/Xdamage.h>
+#endif
+
+#include <QSocketNotifier>
+
 X11Grabber::X11Grabber(int cropLeft, int cropRight, int cropTop, int cropBottom)
 	: Grabber("GRABBER-X11", cropLeft, cropRight, cropTop, cropBottom)
 	, _x11Display(nullptr)
@@ -13,6 +19,10 @@ X11Grabber::X11Grabber(int cropLeft, int cropRight, int cropTop, int cropBottom)
 	, _dstFormat(nullptr)
 	, _srcPicture(None)
 	, _dstPicture(None)
+	, _xRandREventBase(0)
+	, _damage(None)
+	, _xDamageEventBase(0)
+	, _damageNotifier(nullptr)
 	, _screenWidth(0)
 	, _screenHeight(0)
 	, _src_x(cropLeft)
@@ -32,6 +42,7 @@ X11Grabber::~X11Grabber()
 {
 	if (_x11Display != nullptr)
 	{
+		freeDamage();
 		freeResources();
 		XCloseDisplay(_x11Display);
 	}
@@ -181,6 +192,11 @@ bool X11Grabber::setupDisplay()
 		result = (updateScreenDimensions(true) >=0);
 		ErrorIf(!result, _log, "X11 Grabber start failed");
 		setEnabled(result);
+
+		if (result)
+		{
+			setupDamage();
+		}
 	}
 	return result;
 }
@@ -262,9 +278,101 @@ int X11Grabber::grabFrame(Image<ColorRgb> & image, bool forceUpdate)
 
 	_imageResampler.processImage(reinterpret_cast<const uint8_t *>(_xImage->data), _xImage->width, _xImage->height, _xImage->bytes_per_line, PixelFormat::BGR32, image);
 
+	// Events read while waiting for the replies are queued by Xlib, the socket notifier does not signal them
+	if (_damage != None)
+	{
+		processDamageEvents();
+	}
+
 	return 0;
 }
 
+void X11Grabber::setEventDriven(bool enable)
+{
+	if (_eventDriven != enable)
+	{
+		Grabber::setEventDriven(enable);
+		if (_x11Display != nullptr)
+		{
+			setupDamage();
+		}
+	}
+}
+
+bool X11Grabber::isEventDriven() const
+{
+	return _damage != None;
+}
+
+void X11Grabber::setupDamage()
+{
+	freeDamage();
+
+	if (!_eventDriven)
+	{
+		return;
+	}
+
+#ifdef HAVE_X11_XDAMAGE
+	int errorBase {0};
+	if (XDamageQueryExtension(_x11Display, &_xDamageEventBase, &errorBase) == 0)
+	{
+		Warning(_log, "XDamage extension is not available, frames are captured at a fixed rate");
+		return;
+	}
+
+	// A single event is reported when the damage becomes non-empty, the damage is reset when the event is processed
+	_damage = XDamageCreate(_x11Display, _window, XDamageReportNonEmpty);
+	XFlush(_x11Display);
+
+	_damageNotifier = new QSocketNotifier(ConnectionNumber(_x11Display), QSocketNotifier::Read, this);
+	connect(_damageNotifier, &QSocketNotifier::activated, this, [this]() { processDamageEvents(); });
+
+	Info(_log, "Frames are captured on screen damage");
+#else
+	Warning(_log, "Built without XDamage support, frames are captured at a fixed rate");
+#endif
+}
+
+void X11Grabber::freeDamage()
+{
+	delete _damageNotifier;
+	_damageNotifier = nullptr;
+
+#ifdef HAVE_X11_XDAMAGE
+	if (_damage != None)
+	{
+		XDamageDestroy(_x11Display, _damage);
+		XFlush(_x11Display);
+	}
+#endif
+	_damage = None;
+}
+
+void X11Grabber::processDamageEvents()
+{
+#ifdef HAVE_X11_XDAMAGE
+	bool isDamaged {false};
+	while (XPending(_x11Display) > 0)
+	{
+		XEvent event;
+		XNextEvent(_x11Display, &event);
+		if (event.type == _xDamageEventBase + XDamageNotify)
+		{
+			isDamaged = true;
+		}
+	}
+
+	if (isDamaged)
+	{
+		// Reset the damage, i.e. the next change is reported again
+		XDamageSubtract(_x11Display, _damage, None, None);
+		XFlush(_x11Display);
+		emit frameAvailable();
+	}
+#endif
+}
+
 int X11Grabber::updateScreenDimensions(bool force)
 {
 	const Status status = XGetWindowAttributes(_x11Display, _window, &_windowAttr);
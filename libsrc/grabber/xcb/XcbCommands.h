@@ -5,6 +5,10 @@
 #include <xcb/xcb.h>
 #include <xcb/xcb_image.h>
 
+#ifdef HAVE_XCB_DAMAGE
+#include <xcb/damage.h>
+#endif
+
 struct GetImage
 {
 	typedef xcb_get_image_reply_t ResponseType;
@@ -141,3 +145,28 @@ struct FreePixmap
 	static constexpr auto ReplyFunction = xcb_request_check;
 };
 
+#ifdef HAVE_XCB_DAMAGE
+struct DamageQueryVersion
+{
+	typedef xcb_damage_query_version_reply_t ResponseType;
+
+	static constexpr auto RequestFunction = xcb_damage_query_version;
+	static constexpr auto ReplyFunction = xcb_damage_query_version_reply;
+};
+
+struct DamageCreate
+{
+	typedef xcb_void_cookie_t ResponseType;
+
+	static constexpr auto RequestFunction = xcb_damage_create_checked;
+	static constexpr auto ReplyFunction = xcb_request_check;
+};
+
+struct DamageDestroy
+{
+	typedef xcb_void_cookie_t ResponseType;
+
+	static constexpr auto RequestFunction = xcb_damage_destroy_checked;
+	static constexpr auto ReplyFunction = xcb_request_check;
+};
+#endif
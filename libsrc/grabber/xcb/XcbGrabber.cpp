@@ -7,6 +7,7 @@
 #include <xcb/xcb_event.h>
 
 #include <QCoreApplication>
+#include <QSocketNotifier>
 
 #include <memory>
 
@@ -34,6 +35,9 @@ XcbGrabber::XcbGrabber(int cropLeft, int cropRight, int cropTop, int cropBottom)
 	, _isWayland (false)
 	, _shmData{}
 	, _XcbRandREventBase{-1}
+	, _damage{}
+	, _XcbDamageEventBase{-1}
+	, _damageNotifier{}
 {
 	// cropping is performed by XcbRender, XcbShmGetImage or XcbGetImage
 	_useImageResampler = false;
@@ -44,6 +48,7 @@ XcbGrabber::~XcbGrabber()
 {
 	if (_connection != nullptr)
 	{
+		freeDamage();
 		freeResources();
 		xcb_disconnect(_connection);
 	}
@@ -260,6 +265,7 @@ bool XcbGrabber::setupDisplay()
 		}
 
 		setEnabled(true);
+		setupDamage();
 	}
 	return true;
 }
@@ -341,6 +347,12 @@ int XcbGrabber::grabFrame(Image<ColorRgb> & image, bool forceUpdate)
 			_width, _height, _width * 4, PixelFormat::BGR32, image);
 	}
 
+	// Events read while waiting for the replies are queued by XCB, the socket notifier does not signal them
+	if (_damage != 0)
+	{
+		processDamageEvents();
+	}
+
 	return 0;
 }
 
@@ -461,6 +473,99 @@ void XcbGrabber::setCropping(int cropLeft, int cropRight, int cropTop, int cropB
 		updateScreenDimensions(true);
 }
 
+void XcbGrabber::setEventDriven(bool enable)
+{
+	if (_eventDriven != enable)
+	{
+		Grabber::setEventDriven(enable);
+		if (_connection != nullptr)
+		{
+			setupDamage();
+		}
+	}
+}
+
+bool XcbGrabber::isEventDriven() const
+{
+	return _damage != 0;
+}
+
+void XcbGrabber::setupDamage()
+{
+	freeDamage();
+
+	if (!_eventDriven)
+		return;
+
+#ifdef HAVE_XCB_DAMAGE
+	auto damageQueryExtensionReply = xcb_get_extension_data(_connection, &xcb_damage_id);
+	if (damageQueryExtensionReply == nullptr || !damageQueryExtensionReply->present)
+	{
+		Warning(_log, "XCB damage extension is not available, frames are captured at a fixed rate");
+		return;
+	}
+
+	// The version has to be negotiated before any other request of the extension
+	auto damageQueryVersionReply = query<DamageQueryVersion>(_connection, XCB_DAMAGE_MAJOR_VERSION, XCB_DAMAGE_MINOR_VERSION);
+	if (damageQueryVersionReply == nullptr)
+	{
+		Warning(_log, "XCB damage extension version query failed, frames are captured at a fixed rate");
+		return;
+	}
+
+	_XcbDamageEventBase = damageQueryExtensionReply->first_event;
+
+	// A single event is reported when the damage becomes non-empty, the damage is reset when the event is processed
+	_damage = xcb_generate_id(_connection);
+	query<DamageCreate>(_connection, _damage, _screen->root, XCB_DAMAGE_REPORT_LEVEL_NON_EMPTY);
+
+	_damageNotifier = new QSocketNotifier(xcb_get_file_descriptor(_connection), QSocketNotifier::Read, this);
+	connect(_damageNotifier, &QSocketNotifier::activated, this, [this]() { processDamageEvents(); });
+
+	Info(_log, "Frames are captured on screen damage");
+#else
+	Warning(_log, "Built without XCB damage support, frames are captured at a fixed rate");
+#endif
+}
+
+void XcbGrabber::freeDamage()
+{
+	delete _damageNotifier;
+	_damageNotifier = nullptr;
+
+#ifdef HAVE_XCB_DAMAGE
+	if (_damage != 0)
+	{
+		query<DamageDestroy>(_connection, _damage);
+	}
+#endif
+	_damage = 0;
+}
+
+void XcbGrabber::processDamageEvents()
+{
+#ifdef HAVE_XCB_DAMAGE
+	bool isDamaged {false};
+	xcb_generic_event_t * event = nullptr;
+	while ((event = xcb_poll_for_event(_connection)) != nullptr)
+	{
+		if (XCB_EVENT_RESPONSE_TYPE(event) == _XcbDamageEventBase + XCB_DAMAGE_NOTIFY)
+		{
+			isDamaged = true;
+		}
+		free(event);
+	}
+
+	if (isDamaged)
+	{
+		// Reset the damage, i.e. the next change is reported again
+		xcb_damage_subtract(_connection, _damage, XCB_NONE, XCB_NONE);
+		xcb_flush(_connection);
+		emit frameAvailable();
+	}
+#endif
+}
+
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
 bool XcbGrabber::nativeEventFilter(const QByteArray & eventType, void * message, qintptr * /*result*/)
 #else
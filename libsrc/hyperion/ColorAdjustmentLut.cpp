@@ -0,0 +1,292 @@
+#include <hyperion/ColorAdjustmentLut.h>
+
+// STL includes
+#include <algorithm>
+#include <cstdlib>
+
+#include <hyperion/ColorAdjustment.h>
+
+namespace {
+
+constexpr int GRID_SIZE = ColorAdjustmentLut::GRID_SIZE;
+constexpr int CELLS = GRID_SIZE - 1;
+
+/// Fixed point scale of the interpolation weights
+constexpr int WEIGHT_ONE = 256;
+
+///
+/// Maps a channel value to its grid cell and the position within the cell.
+/// The grid points are the integers closest to an even division of [0, 255], so that the
+/// exact adjustment chain (operating on 8-bit values) can be evaluated at them.
+///
+struct GridMapping
+{
+	uint8_t node[GRID_SIZE];
+	uint8_t cell[256];
+	uint16_t weight[256];
+
+	constexpr GridMapping() : node(), cell(), weight()
+	{
+		for (int i = 0; i < GRID_SIZE; ++i)
+		{
+			node[i] = static_cast<uint8_t>((i * UINT8_MAX + CELLS / 2) / CELLS);
+		}
+
+		int i = 0;
+		for (int value = 0; value <= UINT8_MAX; ++value)
+		{
+			while (i < CELLS - 1 && node[i + 1] <= value)
+			{
+				++i;
+			}
+			const int width = node[i + 1] - node[i];
+			cell[value] = static_cast<uint8_t>(i);
+			weight[value] = static_cast<uint16_t>(((value - node[i]) * WEIGHT_ONE + width / 2) / width);
+		}
+	}
+};
+
+constexpr GridMapping GRID;
+
+constexpr int index(int red, int green, int blue)
+{
+	return (red * GRID_SIZE + green) * GRID_SIZE + blue;
+}
+
+} // namespace
+
+ColorAdjustmentLut::ColorAdjustmentLut(ColorAdjustment& adjustment)
+	: _adjustment(adjustment)
+	, _settings()
+	, _isValid(false)
+	, _coversOkhsv(false)
+	, _table(static_cast<size_t>(GRID_SIZE * GRID_SIZE * GRID_SIZE))
+{
+}
+
+bool ColorAdjustmentLut::update()
+{
+	const Settings settings = currentSettings();
+	if (_isValid && settings == _settings)
+	{
+		return false;
+	}
+
+	_settings = settings;
+	_isValid = true;
+
+	if (!_adjustment._okhsvTransform.isIdentity())
+	{
+		build(true);
+		if (verify() <= MAX_ERROR)
+		{
+			return true;
+		}
+	}
+
+	build(false);
+	return true;
+}
+
+void ColorAdjustmentLut::apply(ColorRgb& color) const
+{
+	apply(color.red, color.green, color.blue);
+}
+
+void ColorAdjustmentLut::apply(uint8_t& red, uint8_t& green, uint8_t& blue) const
+{
+	if (!_coversOkhsv)
+	{
+		applyOkhsvGamma(red, green, blue);
+	}
+
+	const ColorRgb color = lookup(red, green, blue);
+	red = color.red;
+	green = color.green;
+	blue = color.blue;
+	_adjustment._rgbTransform.applyBacklight(red, green, blue);
+}
+
+void ColorAdjustmentLut::applyExact(ColorRgb& color)
+{
+	uint8_t red = color.red;
+	uint8_t green = color.green;
+	uint8_t blue = color.blue;
+
+	applyOkhsvGamma(red, green, blue);
+	color = applyChannelAdjustments(red, green, blue);
+	_adjustment._rgbTransform.applyBacklight(color.red, color.green, color.blue);
+}
+
+ColorAdjustmentLut::Settings ColorAdjustmentLut::currentSettings() const
+{
+	const RgbTransform& transform = _adjustment._rgbTransform;
+	Settings settings {
+		transform.getGammaR(), transform.getGammaG(), transform.getGammaB(),
+		static_cast<double>(transform.getBrightness()), static_cast<double>(transform.getBrightnessCompensation()),
+		static_cast<double>(transform.getTemperature()),
+		_adjustment._okhsvTransform.getSaturationGain(), _adjustment._okhsvTransform.getBrightnessGain()
+	};
+
+	const RgbChannelAdjustment* channels[] = {
+		&_adjustment._rgbBlackAdjustment, &_adjustment._rgbRedAdjustment, &_adjustment._rgbGreenAdjustment, &_adjustment._rgbBlueAdjustment,
+		&_adjustment._rgbCyanAdjustment, &_adjustment._rgbMagentaAdjustment, &_adjustment._rgbYellowAdjustment, &_adjustment._rgbWhiteAdjustment
+	};
+	size_t i = 8;
+	for (const RgbChannelAdjustment* channel : channels)
+	{
+		settings[i++] = channel->getAdjustmentR();
+		settings[i++] = channel->getAdjustmentG();
+		settings[i++] = channel->getAdjustmentB();
+	}
+	return settings;
+}
+
+void ColorAdjustmentLut::applyOkhsvGamma(uint8_t& red, uint8_t& green, uint8_t& blue) const
+{
+	if (!_adjustment._okhsvTransform.isIdentity())
+	{
+		_adjustment._okhsvTransform.transform(red, green, blue);
+	}
+
+	_adjustment._rgbTransform.applyGamma(red, green, blue);
+}
+
+ColorRgb ColorAdjustmentLut::applyChannelAdjustments(uint8_t ored, uint8_t ogreen, uint8_t oblue)
+{
+	uint8_t B_RGB = 0;
+	uint8_t B_CMY = 0;
+	uint8_t B_W = 0;
+	_adjustment._rgbTransform.getBrightnessComponents(B_RGB, B_CMY, B_W);
+
+	uint32_t nr_ng = static_cast<uint32_t>((UINT8_MAX - ored) * (UINT8_MAX - ogreen));
+	uint32_t r_ng  = static_cast<uint32_t>(ored * (UINT8_MAX - ogreen));
+	uint32_t nr_g  = static_cast<uint32_t>((UINT8_MAX - ored) * ogreen);
+	uint32_t r_g   = static_cast<uint32_t>(ored * ogreen);
+
+	uint8_t black   = static_cast<uint8_t>(nr_ng * (UINT8_MAX - oblue) / DOUBLE_UINT8_MAX_SQUARED);
+	uint8_t red     = static_cast<uint8_t>(r_ng * (UINT8_MAX - oblue) / DOUBLE_UINT8_MAX_SQUARED);
+	uint8_t green   = static_cast<uint8_t>(nr_g * (UINT8_MAX - oblue) / DOUBLE_UINT8_MAX_SQUARED);
+	uint8_t blue    = static_cast<uint8_t>(nr_ng * (oblue) / DOUBLE_UINT8_MAX_SQUARED);
+	uint8_t cyan    = static_cast<uint8_t>(nr_g * (oblue) / DOUBLE_UINT8_MAX_SQUARED);
+	uint8_t magenta = static_cast<uint8_t>(r_ng * (oblue) / DOUBLE_UINT8_MAX_SQUARED);
+	uint8_t yellow  = static_cast<uint8_t>(r_g * (UINT8_MAX - oblue) / DOUBLE_UINT8_MAX_SQUARED);
+	uint8_t white   = static_cast<uint8_t>(r_g * (oblue) / DOUBLE_UINT8_MAX_SQUARED);
+
+	uint8_t OR, OG, OB;  // Original Colors
+	uint8_t RR, RG, RB;  // Red Adjustments
+	uint8_t GR, GG, GB;  // Green Adjustments
+	uint8_t BR, BG, BB;  // Blue Adjustments
+	uint8_t CR, CG, CB;  // Cyan Adjustments
+	uint8_t MR, MG, MB;  // Magenta Adjustments
+	uint8_t YR, YG, YB;  // Yellow Adjustments
+	uint8_t WR, WG, WB;  // White Adjustments
+
+	_adjustment._rgbBlackAdjustment.apply  (black  , UINT8_MAX, OR, OG, OB);
+	_adjustment._rgbRedAdjustment.apply    (red    , B_RGB, RR, RG, RB);
+	_adjustment._rgbGreenAdjustment.apply  (green  , B_RGB, GR, GG, GB);
+	_adjustment._rgbBlueAdjustment.apply   (blue   , B_RGB, BR, BG, BB);
+	_adjustment._rgbCyanAdjustment.apply   (cyan   , B_CMY, CR, CG, CB);
+	_adjustment._rgbMagentaAdjustment.apply(magenta, B_CMY, MR, MG, MB);
+	_adjustment._rgbYellowAdjustment.apply (yellow , B_CMY, YR, YG, YB);
+	_adjustment._rgbWhiteAdjustment.apply  (white  , B_W  , WR, WG, WB);
+
+	ColorRgb color;
+	color.red   = OR + RR + GR + BR + CR + MR + YR + WR;
+	color.green = OG + RG + GG + BG + CG + MG + YG + WG;
+	color.blue  = OB + RB + GB + BB + CB + MB + YB + WB;
+
+	_adjustment._rgbTransform.applyTemperature(color);
+	return color;
+}
+
+void ColorAdjustmentLut::build(bool coversOkhsv)
+{
+	_coversOkhsv = coversOkhsv;
+
+	for (int r = 0; r < GRID_SIZE; ++r)
+	{
+		for (int g = 0; g < GRID_SIZE; ++g)
+		{
+			for (int b = 0; b < GRID_SIZE; ++b)
+			{
+				uint8_t red = GRID.node[r];
+				uint8_t green = GRID.node[g];
+				uint8_t blue = GRID.node[b];
+				if (coversOkhsv)
+				{
+					applyOkhsvGamma(red, green, blue);
+				}
+				_table[static_cast<size_t>(index(r, g, b))] = applyChannelAdjustments(red, green, blue);
+			}
+		}
+	}
+}
+
+int ColorAdjustmentLut::verify()
+{
+	// The cell centers are the points farthest from the grid
+	int maxError = 0;
+	for (int r = 0; r < CELLS; ++r)
+	{
+		for (int g = 0; g < CELLS; ++g)
+		{
+			for (int b = 0; b < CELLS; ++b)
+			{
+				uint8_t red = static_cast<uint8_t>((GRID.node[r] + GRID.node[r + 1]) / 2);
+				uint8_t green = static_cast<uint8_t>((GRID.node[g] + GRID.node[g + 1]) / 2);
+				uint8_t blue = static_cast<uint8_t>((GRID.node[b] + GRID.node[b + 1]) / 2);
+				const ColorRgb interpolated = lookup(red, green, blue);
+
+				applyOkhsvGamma(red, green, blue);
+				const ColorRgb exact = applyChannelAdjustments(red, green, blue);
+
+				maxError = std::max({ maxError,
+									  std::abs(interpolated.red - exact.red),
+									  std::abs(interpolated.green - exact.green),
+									  std::abs(interpolated.blue - exact.blue) });
+			}
+		}
+	}
+	return maxError;
+}
+
+ColorRgb ColorAdjustmentLut::lookup(uint8_t red, uint8_t green, uint8_t blue) const
+{
+	const int fx = GRID.weight[red];
+	const int fy = GRID.weight[green];
+	const int fz = GRID.weight[blue];
+
+	// Tetrahedral interpolation: the cell is split into six tetrahedra along its main diagonal,
+	// the one containing the point is selected by the order of the positions within the cell
+	const ColorRgb* base = &_table[static_cast<size_t>(index(GRID.cell[red], GRID.cell[green], GRID.cell[blue]))];
+	constexpr int DX = index(1, 0, 0);
+	constexpr int DY = index(0, 1, 0);
+	constexpr int DZ = index(0, 0, 1);
+
+	int w0, w1, w2, w3;
+	int o1, o2;
+	if (fx >= fy)
+	{
+		if (fy >= fz)      { w0 = WEIGHT_ONE - fx; w1 = fx - fy; w2 = fy - fz; w3 = fz; o1 = DX; o2 = DX + DY; }
+		else if (fx >= fz) { w0 = WEIGHT_ONE - fx; w1 = fx - fz; w2 = fz - fy; w3 = fy; o1 = DX; o2 = DX + DZ; }
+		else               { w0 = WEIGHT_ONE - fz; w1 = fz - fx; w2 = fx - fy; w3 = fy; o1 = DZ; o2 = DX + DZ; }
+	}
+	else
+	{
+		if (fz >= fy)      { w0 = WEIGHT_ONE - fz; w1 = fz - fy; w2 = fy - fx; w3 = fx; o1 = DZ; o2 = DY + DZ; }
+		else if (fz >= fx) { w0 = WEIGHT_ONE - fy; w1 = fy - fz; w2 = fz - fx; w3 = fx; o1 = DY; o2 = DY + DZ; }
+		else               { w0 = WEIGHT_ONE - fy; w1 = fy - fx; w2 = fx - fz; w3 = fz; o1 = DY; o2 = DX + DY; }
+	}
+
+	const ColorRgb& c0 = base[0];
+	const ColorRgb& c1 = base[o1];
+	const ColorRgb& c2 = base[o2];
+	const ColorRgb& c3 = base[DX + DY + DZ];
+
+	ColorRgb color;
+	color.red   = static_cast<uint8_t>((w0 * c0.red   + w1 * c1.red   + w2 * c2.red   + w3 * c3.red   + WEIGHT_ONE / 2) / WEIGHT_ONE);
+	color.green = static_cast<uint8_t>((w0 * c0.green + w1 * c1.green + w2 * c2.green + w3 * c3.green + WEIGHT_ONE / 2) / WEIGHT_ONE);
+	color.blue  = static_cast<uint8_t>((w0 * c0.blue  + w1 * c1.blue  + w2 * c2.blue  + w3 * c3.blue  + WEIGHT_ONE / 2) / WEIGHT_ONE);
+	return color;
+}
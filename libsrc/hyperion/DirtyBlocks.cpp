@@ -0,0 +1,152 @@
+#include <hyperion/DirtyBlocks.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace hyperion;
+
+DirtyBlocks::DirtyBlocks()
+	: _width(0)
+	, _height(0)
+	, _columns(0)
+	, _rows(0)
+	, _watched()
+	, _dirty()
+	, _watchedCount(0)
+	, _dirtyCount(0)
+	, _previous()
+{
+}
+
+void DirtyBlocks::setSize(int width, int height)
+{
+	_width = std::max(0, width);
+	_height = std::max(0, height);
+	_columns = (_width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+	_rows = (_height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+	const size_t blockCount = static_cast<size_t>(_columns) * static_cast<size_t>(_rows);
+	_watched.assign(blockCount, 0);
+	_dirty.assign(blockCount, 0);
+	_watchedCount = 0;
+
+	reset();
+}
+
+void DirtyBlocks::watch(int minX, int minY, int maxX, int maxY)
+{
+	minX = std::max(minX, 0);
+	minY = std::max(minY, 0);
+	maxX = std::min(maxX, _width);
+	maxY = std::min(maxY, _height);
+	if (minX >= maxX || minY >= maxY)
+	{
+		return;
+	}
+
+	for (int row = minY / BLOCK_SIZE; row <= (maxY - 1) / BLOCK_SIZE; ++row)
+	{
+		for (int column = minX / BLOCK_SIZE; column <= (maxX - 1) / BLOCK_SIZE; ++column)
+		{
+			uint8_t &watched = _watched[static_cast<size_t>(row) * _columns + column];
+			if (watched == 0)
+			{
+				watched = 1;
+				++_watchedCount;
+			}
+		}
+	}
+}
+
+bool DirtyBlocks::update(const Image<ColorRgb> &image)
+{
+	if (image.width() != _width || image.height() != _height || _watchedCount == 0)
+	{
+		reset();
+		return false;
+	}
+
+	const Image<ColorRgb> &previous = _previous;
+	if (previous.isNull())
+	{
+		_previous = image;
+		return false;
+	}
+
+	// A shallow copy of the previous frame did not change
+	if (image.dataId() == previous.dataId())
+	{
+		std::fill(_dirty.begin(), _dirty.end(), 0);
+		_dirtyCount = 0;
+		return true;
+	}
+
+	const ColorRgb *current = image.memptr();
+	const ColorRgb *last = previous.memptr();
+
+	_dirtyCount = 0;
+	for (int row = 0; row < _rows; ++row)
+	{
+		const int yEnd = std::min((row + 1) * BLOCK_SIZE, _height);
+		for (int column = 0; column < _columns; ++column)
+		{
+			const size_t block = static_cast<size_t>(row) * _columns + column;
+			if (_watched[block] == 0)
+			{
+				continue;
+			}
+
+			const int x = column * BLOCK_SIZE;
+			const size_t bytes = static_cast<size_t>(std::min(BLOCK_SIZE, _width - x)) * sizeof(ColorRgb);
+
+			uint8_t isDirty = 0;
+			for (int y = row * BLOCK_SIZE; y < yEnd; ++y)
+			{
+				const size_t offset = static_cast<size_t>(y) * _width + x;
+				if (std::memcmp(current + offset, last + offset, bytes) != 0)
+				{
+					isDirty = 1;
+					break;
+				}
+			}
+
+			_dirty[block] = isDirty;
+			_dirtyCount += isDirty;
+		}
+	}
+
+	_previous = image;
+	return true;
+}
+
+bool DirtyBlocks::isDirty(int minX, int minY, int maxX, int maxY) const
+{
+	minX = std::max(minX, 0);
+	minY = std::max(minY, 0);
+	maxX = std::min(maxX, _width);
+	maxY = std::min(maxY, _height);
+	if (minX >= maxX || minY >= maxY)
+	{
+		return false;
+	}
+
+	for (int row = minY / BLOCK_SIZE; row <= (maxY - 1) / BLOCK_SIZE; ++row)
+	{
+		const uint8_t *dirty = &_dirty[static_cast<size_t>(row) * _columns];
+		for (int column = minX / BLOCK_SIZE; column <= (maxX - 1) / BLOCK_SIZE; ++column)
+		{
+			if (dirty[column] != 0)
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void DirtyBlocks::reset()
+{
+	_previous = Image<ColorRgb>();
+	std::fill(_dirty.begin(), _dirty.end(), 1);
+	_dirtyCount = _watchedCount;
+}
@@ -28,6 +28,8 @@ Grabber::Grabber(const QString& grabberName, int cropLeft, int cropRight, int cr
 	, _videoMode(VideoMode::VIDEO_2D)
 	, _videoStandard(VideoStandard::NO_CHANGE)
 	, _pixelDecimation(GrabberWrapper::DEFAULT_PIXELDECIMATION)
+	, _boxFilter(false)
+	, _eventDriven(false)
 	, _flipMode(FlipMode::NO_CHANGE)
 	, _width(0)
 	, _height(0)
@@ -101,6 +103,25 @@ bool Grabber::setPixelDecimation(int pixelDecimation)
 	return false;
 }
 
+void Grabber::setBoxFilter(bool enable)
+{
+	if (_boxFilter != enable)
+	{
+		Info(_log,"Set image size decimation to %s", enable ? "average pixels" : "sample pixels");
+		_boxFilter = enable;
+		_imageResampler.setBoxFilter(enable);
+	}
+}
+
+void Grabber::setEventDriven(bool enable)
+{
+	if (_eventDriven != enable)
+	{
+		Info(_log,"Capture frames %s", enable ? "on screen changes" : "at a fixed rate");
+		_eventDriven = enable;
+	}
+}
+
 void Grabber::setFlipMode(FlipMode mode)
 {
 	Info(_log,"Set flipmode to %s", QSTRING_CSTR(flipModeToString(mode)));
@@ -14,10 +14,12 @@
 Q_LOGGING_CATEGORY(grabber_flow, "hyperion.grabber.flow");
 
 GrabberWrapper* GrabberWrapper::instance = nullptr;
+QList<GrabberWrapper*> GrabberWrapper::_wrappers;
 const int GrabberWrapper::DEFAULT_RATE_HZ = 25;
 const int GrabberWrapper::DEFAULT_MIN_GRAB_RATE_HZ = 1;
 const int GrabberWrapper::DEFAULT_MAX_GRAB_RATE_HZ = 30;
 const int GrabberWrapper::DEFAULT_PIXELDECIMATION = 8;
+const int GrabberWrapper::EVENT_FALLBACK_INTERVAL_MS = 1000;
 
 /// Map of Hyperion instances with grabber name that requested screen capture
 QMap<int, QString> GrabberWrapper::GRABBER_SYS_CLIENTS = QMap<int, QString>();
@@ -32,10 +34,12 @@ GrabberWrapper::GrabberWrapper(const QString& grabberName, Grabber * ggrabber, i
 	, _ggrabber(ggrabber)
 	, _grabberName(grabberName)
 	, _timer(nullptr)
+	, _eventTimer(nullptr)
 	, _updateInterval_ms(1000/updateRate_Hz)
 {
 	TRACK_SCOPE();
 	GrabberWrapper::instance = this;
+	_wrappers.append(this);
 
 	_timer.reset(new QTimer());
 
@@ -43,7 +47,13 @@ GrabberWrapper::GrabberWrapper(const QString& grabberName, Grabber * ggrabber, i
 	_timer->setTimerType(Qt::PreciseTimer);
 	_timer->setInterval(_updateInterval_ms);
 
-	connect(_timer.get(), &QTimer::timeout, this, &GrabberWrapper::action);
+	connect(_timer.get(), &QTimer::timeout, this, &GrabberWrapper::triggerAction);
+
+	// Captures scheduled by change events of the grabber
+	_eventTimer.reset(new QTimer());
+	_eventTimer->setTimerType(Qt::PreciseTimer);
+	_eventTimer->setSingleShot(true);
+	connect(_eventTimer.get(), &QTimer::timeout, this, &GrabberWrapper::triggerAction);
 
 	// connect the image forwarding
 	if (_grabberName.startsWith("V4L"))
@@ -68,6 +78,8 @@ GrabberWrapper::~GrabberWrapper()
 {
 	TRACK_SCOPE();
 	_timer->stop();
+	_eventTimer->stop();
+	_wrappers.removeAll(this);
 	GrabberWrapper::instance = nullptr;
 }
 
@@ -101,8 +113,12 @@ bool GrabberWrapper::start()
 	
 	if (!_timer->isActive())
 	{
+		// The grabber is constructed after the wrapper, i.e. its change events can be connected not before now
+		connect(_ggrabber, &Grabber::frameAvailable, this, &GrabberWrapper::handleFrameAvailable, Qt::UniqueConnection);
+
 		// Start the timer with the pre configured interval
 		Info(_log,"%s grabber started", QSTRING_CSTR(getName()));
+		_timer->setInterval(timerInterval());
 		_timer->start();
 	}
 	qCDebug(grabber_flow) << "Grabber" << _grabberName << (_timer->isActive() ? "active" : "inactive") << "now";
@@ -122,6 +138,7 @@ void GrabberWrapper::stop()
 		Info(_log,"%s grabber stopped", QSTRING_CSTR(getName()));
 		_timer->stop();
 	}
+	_eventTimer->stop();
 	qCDebug(grabber_flow) << "Grabber" << _grabberName << "stopped";
 }
 
@@ -132,9 +149,43 @@ bool GrabberWrapper::restart()
 		<< ", and" << (_timer->isActive() ? "active" : "inactive");
 
 	_timer->stop();
+	_eventTimer->stop();
 	return start();
 }
 
+void GrabberWrapper::triggerAction()
+{
+	_eventTimer->stop();
+	_lastAction.start();
+
+	action();
+
+	// Without change events, frames are captured at the update rate. With change events, the timer only ensures that
+	// a frame is captured at least every fallback interval (e.g. for content not reported by the events).
+	const int interval = timerInterval();
+	if (_timer->isActive() && (_ggrabber->isEventDriven() || _timer->interval() != interval))
+	{
+		_timer->start(interval);
+	}
+}
+
+void GrabberWrapper::handleFrameAvailable()
+{
+	// Changes are coalesced until the next capture, which happens at the earliest one update interval after the last one
+	if (!_timer->isActive() || _eventTimer->isActive())
+	{
+		return;
+	}
+
+	const qint64 elapsed = _lastAction.isValid() ? _lastAction.elapsed() : _updateInterval_ms;
+	_eventTimer->start(static_cast<int>(qMax(qint64(0), _updateInterval_ms - elapsed)));
+}
+
+int GrabberWrapper::timerInterval() const
+{
+	return _ggrabber->isEventDriven() ? qMax(EVENT_FALLBACK_INTERVAL_MS, _updateInterval_ms) : _updateInterval_ms;
+}
+
 void GrabberWrapper::handleEvent(Event event)
 {
 	qCDebug(grabber_flow) << "Received event" << event << "for grabber" << _grabberName;
@@ -244,6 +295,42 @@ QStringList GrabberWrapper::availableGrabbers(GrabberTypeFilter type)
 	return grabbers;
 }
 
+GrabberTypeFilter GrabberWrapper::grabberType(const QString& grabberName)
+{
+	if (grabberName.startsWith("V4L"))
+	{
+		return GrabberTypeFilter::VIDEO;
+	}
+
+	if (grabberName.startsWith("Audio"))
+	{
+		return GrabberTypeFilter::AUDIO;
+	}
+
+	return GrabberTypeFilter::SCREEN;
+}
+
+QJsonObject GrabberWrapper::getStatistics(GrabberTypeFilter type)
+{
+	QJsonObject statistics;
+
+	for (const GrabberWrapper* wrapper : std::as_const(_wrappers))
+	{
+		if (type != GrabberTypeFilter::ALL && grabberType(wrapper->_grabberName) != type)
+		{
+			continue;
+		}
+
+		const QJsonObject grabberStatistics = wrapper->_ggrabber->getStatistics();
+		if (!grabberStatistics.isEmpty())
+		{
+			statistics[wrapper->_grabberName] = grabberStatistics;
+		}
+	}
+
+	return statistics;
+}
+
 void GrabberWrapper::setVideoMode(VideoMode mode)
 {
 	if (_ggrabber != nullptr)
@@ -271,7 +358,7 @@ void GrabberWrapper::updateTimer(int interval)
 
 		const bool& timerWasActive = _timer->isActive();
 		_timer->stop();
-		_timer->setInterval(_updateInterval_ms);
+		_timer->setInterval(timerInterval());
 
 		if(timerWasActive)
 		{
@@ -304,6 +391,8 @@ void GrabberWrapper::handleSettingsUpdate(settings::type type, const QJsonDocume
 			_ggrabber->setDisplayIndex(obj["input"].toInt(0));
 			// Set pixel decimation before width/height to allow calculation of proper output dimensions
 			_ggrabber->setPixelDecimation(obj["pixelDecimation"].toInt(DEFAULT_PIXELDECIMATION));
+			_ggrabber->setBoxFilter(obj["boxFilter"].toBool(false));
+			_ggrabber->setEventDriven(obj["eventDriven"].toBool(false));
 
 			// width/height
 			_ggrabber->setWidthHeight(obj["width"].toInt(96), obj["height"].toInt(96));
@@ -106,10 +106,8 @@ void Hyperion::start()
 
 	_settingsManager.reset(new SettingsManager(_instIndex));
 
-	// link settings changed with the current Hyperion instance
-	connect(_settingsManager.get(), &SettingsManager::settingsChanged, this, &Hyperion::settingsChanged);
-	// listen for settings updates of this instance (LEDS & COLOR)
-	connect(_settingsManager.get(), &SettingsManager::settingsChanged, this, &Hyperion::handleSettingsUpdate);
+	// link settings changed with the current Hyperion instance and listen for settings updates of this instance (LEDS & COLOR)
+	connect(_settingsManager.get(), &SettingsManager::settingsChanged, this, &Hyperion::handleSettingsChanged);
 
 	_componentRegister = MAKE_TRACKED_SHARED(ComponentRegister, sharedFromThis());
 	connect(this, &Hyperion::isSetNewComponentState, _componentRegister.get(), &ComponentRegister::setNewComponentState);
@@ -141,6 +139,9 @@ void Hyperion::start()
 	connect(this, &Hyperion::settingsChanged, _deviceSmooth.get(), &LinearColorSmoothing::handleSettingsUpdate);
 	_deviceSmooth->start();
 
+	// smoothing must be fed from the instance's thread, when the output is processed on the dedicated thread
+	connect(this, &Hyperion::smoothingData, this, &Hyperion::handleSmoothingData, Qt::QueuedConnection);
+
 	// initialize LED-devices
 	QJsonObject const ledDeviceSettings = getSetting(settings::DEVICE).object();
 
@@ -178,6 +179,9 @@ void Hyperion::start()
 	connect(GlobalSignals::getInstance(), &GlobalSignals::setGlobalColor, this, &Hyperion::setColor);
 	connect(GlobalSignals::getInstance(), &GlobalSignals::setGlobalImage, this, &Hyperion::setInputImage);
 
+	// start the dedicated output processing thread, if configured
+	updateProcessingThread(getSetting(settings::SMOOTHING).object());
+
 	// if there is no startup / background effect and no sending capture interface we probably want to push once BLACK (as PrioMuxer won't emit a priority change)
 	refreshUpdate();
 
@@ -218,6 +222,9 @@ void Hyperion::stop(const QString name)
 #endif
 
 	_muxer->stop();
+
+	// finish the output processing before its consumers stop
+	_processingThread.reset();
 	_deviceSmooth->stop();
 
 	// Trigger instance stopped when the LedDevice signals it has stopped
@@ -229,12 +236,29 @@ void Hyperion::stop(const QString name)
 	_ledDeviceWrapper->stopDevice();
 }
 
+void Hyperion::handleSettingsChanged(settings::type type, const QJsonDocument& config)
+{
+	{
+		// The image processor and black border detection apply COLOR and BLACKBORDER settings to the output processing state
+		QMutexLocker locker((type == settings::COLOR || type == settings::BLACKBORDER) ? &_processingMutex : nullptr);
+		emit settingsChanged(type, config);
+		if (type == settings::COLOR || type == settings::BLACKBORDER)
+		{
+			invalidateFrameFingerprint();
+		}
+	}
+
+	handleSettingsUpdate(type, config);
+}
+
 void Hyperion::handleSettingsUpdate(settings::type type, const QJsonDocument& config)
 {
 	if (type == settings::COLOR)
 	{
-
-		updateLedColorAdjustment(_layoutLedCount, config.object());
+		{
+			QMutexLocker locker(&_processingMutex);
+			updateLedColorAdjustment(_layoutLedCount, config.object());
+		}
 		refreshUpdate();
 	}
 	else if (type == settings::LEDS)
@@ -244,7 +268,10 @@ void Hyperion::handleSettingsUpdate(settings::type type, const QJsonDocument& co
 		_effectEngine->cacheRunningEffects();
 #endif
 
-		updateLedLayout(config.array());
+		{
+			QMutexLocker locker(&_processingMutex);
+			updateLedLayout(config.array());
+		}
 
 #if defined(ENABLE_EFFECTENGINE)
 		// start cached effects
@@ -259,12 +286,47 @@ void Hyperion::handleSettingsUpdate(settings::type type, const QJsonDocument& co
 
 		// Recreate LED-Device with new configuration
 		_ledDeviceWrapper->createLedDevice(deviceConfig);
+
+		QMutexLocker locker(&_processingMutex);
 		_hwLedCount = _ledDeviceWrapper->getLedCount();
 		_colorOrder = _ledDeviceWrapper->getColorOrder();
 
 		updateLedLayout(getSetting(settings::LEDS).array());
 		_ledBuffer.fill(ColorRgb::BLACK, _hwLedCount);
+		invalidateFrameFingerprint();
+	}
+	else if (type == settings::SMOOTHING)
+	{
+		updateProcessingThread(config.object());
+	}
+}
+
+void Hyperion::updateProcessingThread(const QJsonObject& smoothingConfig)
+{
+	bool const isEnabled = smoothingConfig["processingThread"].toBool(false);
+	int const realtimePriority = smoothingConfig["realtimePriority"].toInt(0);
+	int const cpuAffinity = smoothingConfig["cpuAffinity"].toInt(-1);
+
+	if (!isEnabled)
+	{
+		if (_processingThread)
+		{
+			Debug(_log, "Process output on the instance's thread");
+			_processingThread.reset();
+		}
+		return;
+	}
+
+	if (_processingThread && _processingThread->getRealtimePriority() == realtimePriority && _processingThread->getCpuAffinity() == cpuAffinity)
+	{
+		return;
 	}
+
+	_processingThread.reset();
+
+	Debug(_log, "Process output on a dedicated thread (real-time priority: %d, CPU affinity: %d)", realtimePriority, cpuAffinity);
+	_processingThread.reset(new ProcessingThread([this](ProcessingThread::Frame& frame) { processFrame(frame); }, realtimePriority, cpuAffinity, _log));
+	_processingThread->start();
 }
 
 void Hyperion::updateLedColorAdjustment(int ledCount, const QJsonObject& colors)
@@ -283,11 +345,13 @@ void Hyperion::updateLedLayout(const QJsonArray& ledLayout)
 	_layoutLedCount = static_cast<int>(_ledString.leds().size());
 	_layoutGridSize = hyperion::getLedLayoutGridSize(ledLayout);
 
-	_ledStringColorOrder.clear();
+	QVector<ColorOrder> colorOrders;
+	colorOrders.reserve(_ledString.leds().size());
 	for (const Led& led : _ledString.leds())
 	{
-		_ledStringColorOrder.push_back(led.colorOrder);
+		colorOrders.push_back(led.colorOrder);
 	}
+	_ledStringColorOrder = LedColorPlanes::ColorOrderMap(colorOrders);
 
 	updateLedColorAdjustment(_layoutLedCount, getSetting(settings::COLOR).object());
 
@@ -627,7 +691,11 @@ void Hyperion::setLedMappingType(int mappingType)
 {
 	if (mappingType != _imageProcessor->getUserLedMappingType())
 	{
-		_imageProcessor->setLedMappingType(mappingType);
+		{
+			QMutexLocker locker(&_processingMutex);
+			_imageProcessor->setLedMappingType(mappingType);
+			invalidateFrameFingerprint();
+		}
 		emit imageToLedsMappingChanged(mappingType);
 	}
 }
@@ -654,6 +722,8 @@ QString Hyperion::getActiveDeviceType() const
 
 void Hyperion::handleVisibleComponentChanged(hyperion::Components comp)
 {
+	QMutexLocker locker(&_processingMutex);
+
 	if (!_imageProcessor.isNull())
 	{
 		_imageProcessor->setBlackbarDetectDisable(comp == hyperion::COMP_EFFECT);
@@ -663,6 +733,7 @@ void Hyperion::handleVisibleComponentChanged(hyperion::Components comp)
 	{
 		_raw2ledAdjustment->setBacklightEnabled(comp != hyperion::COMP_COLOR && comp != hyperion::COMP_EFFECT);
 	}
+	invalidateFrameFingerprint();
 }
 void Hyperion::handleSourceAvailability(int priority)
 {
@@ -701,56 +772,23 @@ void Hyperion::handleSourceAvailability(int priority)
 	}
 }
 
-void Hyperion::applyBlacklist(QVector<ColorRgb>& ledColors)
+void Hyperion::applyBlacklist(LedColorPlanes& ledColors)
 {
 	if (_ledString.hasBlackListedLeds())
 	{
-		for (const auto& id : _ledString.blacklistedLedIds())
-		{
-			if (id < ledColors.size())
-			{
-				ledColors[id] = ColorRgb::BLACK;
-			}
-		}
+		ledColors.setBlack(_ledString.blacklistedLedIds());
 	}
 }
 
-void Hyperion::applyColorOrder(QVector<ColorRgb>& ledColors) const
+void Hyperion::applyColorOrder(LedColorPlanes& ledColors) const
 {
 	assert(ledColors.size() >= _ledStringColorOrder.size());
 
 	// Only apply color order for LEDs defined by layout
-	for (auto i = 0; i < _ledStringColorOrder.size(); ++i)
-	{
-		auto& color = ledColors[i];
-		// correct the color byte order
-		switch (_ledStringColorOrder.at(i))
-		{
-		case ColorOrder::ORDER_RGB:
-			// leave as it is
-			break;
-		case ColorOrder::ORDER_BGR:
-			std::swap(color.red, color.blue);
-			break;
-		case ColorOrder::ORDER_RBG:
-			std::swap(color.green, color.blue);
-			break;
-		case ColorOrder::ORDER_GRB:
-			std::swap(color.red, color.green);
-			break;
-		case ColorOrder::ORDER_GBR:
-			std::swap(color.red, color.green);
-			std::swap(color.green, color.blue);
-			break;
-		case ColorOrder::ORDER_BRG:
-			std::swap(color.red, color.blue);
-			std::swap(color.green, color.blue);
-			break;
-		}
-	}
+	ledColors.applyColorOrder(_ledStringColorOrder);
 }
 
-void Hyperion::writeToLeds()
+bool Hyperion::writeToLeds()
 {
 	if (_ledDeviceWrapper->isOn())
 	{
@@ -758,16 +796,26 @@ void Hyperion::writeToLeds()
 		if (!_deviceSmooth->enabled())
 		{
 				emit ledDeviceData(_ledBuffer);
+				return true;
 		}
 		else
 		{
 			// device is enabled, feed smoothing in pause mode to maintain a smooth transition back to smooth mode
 			if (!_deviceSmooth->pause())
 			{
-				_deviceSmooth->updateLedValues(_ledBuffer);
+				if (QThread::currentThread() == thread())
+				{
+					_deviceSmooth->updateLedValues(_ledBuffer);
+				}
+				else
+				{
+					emit smoothingData(_ledBuffer);
+				}
+				return true;
 			}
 		}
 	}
+	return false;
 }
 
 void Hyperion::refreshUpdate() const
@@ -785,6 +833,7 @@ void Hyperion::update()
 	// If an update processing is NOT already scheduled, schedule one.
 	if (!_isUpdatePending.exchange(true))
 	{
+		_updateRequested = std::chrono::steady_clock::now();
 		QTimer::singleShot(0, this, &Hyperion::handleUpdate);
 	}
 	else
@@ -797,6 +846,10 @@ void Hyperion::update()
 
 void Hyperion::handleForceUpdate()
 {
+	{
+		QMutexLocker locker(&_processingMutex);
+		invalidateFrameFingerprint();
+	}
 	_isUpdateQueued.store(true);
 	update();
 }
@@ -817,45 +870,108 @@ void Hyperion::processUpdate()
 	// Obtain the current priority channel
 	const PriorityMuxer::InputInfo& priorityInfo = _muxer->getInputInfo(_muxer->getCurrentPriority());
 
-	// copy image & process OR copy ledColors from muxer
-	const Image<ColorRgb>& image = priorityInfo.image;
+	// The muxer is owned by the instance's thread, the processing works on a snapshot of its current input
+	ProcessingThread::Frame frame { priorityInfo.image, priorityInfo.image.isNull() ? priorityInfo.ledColors : QVector<ColorRgb>(), _updateRequested };
 
+	if (!frame.image.isNull())
+	{
+		emit currentImage(frame.image);  // Emit the image signal at the controlled rate
+	}
+	else if (frame.ledColors.empty())
+	{
+		TRACK_SCOPE_SUBCOMPONENT_CATEGORY(instance_update) << "Empty image and no LED colors provided - skip update";
+		return;
+	}
+
+	if (_processingThread)
+	{
+		// Only the latest input is processed, if the processing thread is still busy
+		if (!_processingThread->post(std::move(frame)))
+		{
+			_imagesSkipped++;
+		}
+	}
+	else
+	{
+		processFrame(frame);
+	}
+}
+
+void Hyperion::processFrame(ProcessingThread::Frame& frame)
+{
+	QMutexLocker locker(&_processingMutex);
+
+	_queueLatency.record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - frame.requested));
+
+	const Image<ColorRgb>& image = frame.image;
 	QVector<ColorRgb> ledColors;
 
 	if (!image.isNull())
 	{
+		// An unchanged frame results in the LED colors already handed to the LED device and smoothing, which keep refreshing them
+		const quint64 fingerprint = image.fingerprint();
+		if (fingerprint == _lastFingerprint && _isLastFrameDelivered && _ledDeviceWrapper->isOn() && _imageProcessor->isSettled())
+		{
+			TRACK_SCOPE_SUBCOMPONENT_CATEGORY(instance_update) << "Image with id" << image.id() << "is unchanged - skip update";
+			_imagesUnchanged++;
+			return;
+		}
+		_lastFingerprint = fingerprint;
+
 		TRACK_SCOPE_SUBCOMPONENT_CATEGORY(instance_update) << "Process update using image with id" << image.id() << "and resolution" << image.width() << "x" << image.height();
-		emit currentImage(image);  // Emit the image signal at the controlled rate
 		ledColors = _imageProcessor->process(image);
 	}
 	else
 	{
-		ledColors = priorityInfo.ledColors;
-		if (ledColors.empty())
-		{		
-			TRACK_SCOPE_SUBCOMPONENT_CATEGORY(instance_update) << "Empty image and no LED colors provided - skip update";
-			return;
-		}
+		invalidateFrameFingerprint();
+		ledColors = std::move(frame.ledColors);
 	}
 
 	emit rawLedColors(ledColors);
-	applyBlacklist(ledColors);
+
+	// The output stages operate on whole color planes
+	_ledPlanes.assign(ledColors);
+	applyBlacklist(_ledPlanes);
 
 	// Start transformations
-	_raw2ledAdjustment->applyAdjustment(ledColors);
+	_raw2ledAdjustment->applyAdjustment(_ledPlanes);
+
+	applyColorOrder(_ledPlanes);
+
+	// Copy elements to _ledBuffer up to the size of _ledBuffer
+	_ledPlanes.copyTo(_ledBuffer);
+
+	_isLastFrameDelivered = writeToLeds();
+
+	_totalLatency.record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - frame.requested));
+}
 
-	applyColorOrder(ledColors);
+void Hyperion::handleSmoothingData(const QVector<ColorRgb>& ledColors)
+{
+	if (!_deviceSmooth->pause())
+	{
+		_deviceSmooth->updateLedValues(ledColors);
+	}
+}
 
-	// Copy elements from ledColors to _ledBuffer up to the size of _ledBuffer
-	std::copy_n(ledColors.begin(), std::min<qsizetype>(_ledBuffer.size(), ledColors.size()), _ledBuffer.begin());
+QJsonObject Hyperion::getLatencyStatistics() const
+{
+	QJsonObject statistics;
+	statistics["queue"] = _queueLatency.toJson();
+	statistics["total"] = _totalLatency.toJson();
+	return statistics;
+}
 
-	writeToLeds();
+void Hyperion::invalidateFrameFingerprint()
+{
+	_lastFingerprint = 0;
 }
 
 void Hyperion::resetImagesProcessedStatistics()
 {
 	_totalImagesProcessed.store(0);
 	_imagesSkipped.store(0);
+	_imagesUnchanged.store(0);
 	if (_statisticsTimer)
 	{
 		_statisticsTimer->start();
@@ -866,6 +982,7 @@ void Hyperion::reportImagesProcessedStatistics()
 {
 	int total = _totalImagesProcessed.exchange(0);
 	int skipped = _imagesSkipped.exchange(0);
+	int unchanged = _imagesUnchanged.exchange(0);
 
 	if (total > 0)
 	{
@@ -875,6 +992,11 @@ void Hyperion::reportImagesProcessedStatistics()
 			Debug(_log, "Processed %d images in the last %d seconds. Images processed per second: %.2f", total, static_cast<int>(interval_s), total / interval_s);
 		}
 
+		if (unchanged > 0)
+		{
+			Debug(_log, "Skipped %d of %d images (%.2f %%) as unchanged, the LED output was kept", unchanged, total, (double)unchanged / total * 100.0);
+		}
+
 		double percentage = (double)skipped / total * 100.0;
 		if (percentage > DEFAULT_SKIPPEDUPDATES_LOWERBOUND)
 		{
@@ -882,4 +1004,25 @@ void Hyperion::reportImagesProcessedStatistics()
 			Warning(_log, "Skipped %d of %d images (%.2f %%) in the last %d seconds. Actual images processed per second: %.2f", skipped, total, percentage, static_cast<int>(interval_s), actual_updates_ps);
 		}
 	}
+
+	if (_totalLatency.count() > 0)
+	{
+		Debug(_log, "Output latency (update request to LED-device): p50 %.2f ms, p95 %.2f ms, p99 %.2f ms",
+			  _totalLatency.percentile(50) / 1000.0, _totalLatency.percentile(95) / 1000.0, _totalLatency.percentile(99) / 1000.0);
+	}
+	_queueLatency.reset();
+	_totalLatency.reset();
+
+	hyperion::ImageToLedsMap::KMeansStatistics kmeans;
+	{
+		// Counted while processing frames
+		QMutexLocker locker(&_processingMutex);
+		kmeans = _imageProcessor->takeKMeansStatistics();
+	}
+	if (kmeans.frames > 0 && kmeans.areas > 0)
+	{
+		const double durationPerFrame_ms = std::chrono::duration<double, std::milli>(kmeans.duration).count() / static_cast<double>(kmeans.frames);
+		Debug(_log, "Dominant color (advanced): %llu frames, %.2f iterations per LED area, %.3f ms per frame",
+			  static_cast<unsigned long long>(kmeans.frames), static_cast<double>(kmeans.iterations) / static_cast<double>(kmeans.areas), durationPerFrame_ms);
+	}
 }
@@ -1,5 +1,7 @@
 #include <hyperion/ImageProcessor.h>
 
+#include <QCryptographicHash>
+#include <QDataStream>
 #include <QSharedPointer>
 #include <QRgb>
 #include <QLoggingCategory>
@@ -35,6 +37,11 @@ void ImageProcessor::registerProcessingUnit(
 								  << "pixel factor:" << _reducedPixelSetFactorFactor << "accuracy level:" << _accuracyLevel
 								  << "#LEDs:" << _ledString.leds().size();
 
+	if (_imageToLedColors)
+	{
+		_kmeansStatistics += _imageToLedColors->takeKMeansStatistics();
+	}
+
 	if (width > 0 && height > 0)
 	{
 		_imageToLedColors = MAKE_TRACKED_SHARED(ImageToLedsMap,
@@ -53,6 +60,21 @@ void ImageProcessor::registerProcessingUnit(
 		qCDebug(imageProcessor_track) << "Invalid size, resetting ImageToLedsMap.";
 		_imageToLedColors = MAKE_TRACKED_SHARED(ImageToLedsMap, _log, 0, 0, 0, 0, _ledString.leds());
 	}
+
+	_mappingKey = mappingKey(width, height, horizontalBorder, verticalBorder, _reducedPixelSetFactorFactor, _accuracyLevel, _ledString.leds());
+}
+
+QByteArray ImageProcessor::mappingKey(int width, int height, int horizontalBorder, int verticalBorder,
+									  int reducedPixelSetFactorFactor, int accuracyLevel, const QVector<Led>& leds)
+{
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	QDataStream stream(&hash, QIODevice::WriteOnly);
+	stream << width << height << horizontalBorder << verticalBorder << reducedPixelSetFactorFactor << accuracyLevel;
+	for (const Led& led : leds)
+	{
+		stream << led.minX_frac << led.maxX_frac << led.minY_frac << led.maxY_frac << led.isBlacklisted;
+	}
+	return hash.result().toHex();
 }
 
 // global transform method
@@ -86,6 +108,10 @@ int ImageProcessor::mappingTypeToInt(const QString& mappingType)
 	{
 		return 6;
 	}
+	else if (mappingType == "multicolor_mean_integral" )
+	{
+		return 7;
+	}
 	return 0;
 }
 // global transform method
@@ -115,6 +141,9 @@ QString ImageProcessor::mappingTypeToStr(int mappingType)
 	case 6:
 		typeText = "unicolor_dominant_advanced";
 		break;
+	case 7:
+		typeText = "multicolor_mean_integral";
+		break;
 	default:
 		typeText = "multicolor_mean";
 		break;
@@ -134,6 +163,7 @@ ImageProcessor::ImageProcessor(const LedString& ledString, const QSharedPointer<
 	, _hardMappingType(-1)
 	, _accuracyLevel(0)
 	, _reducedPixelSetFactorFactor(1)
+	, _kmeansStatistics()
 	, _hyperionWeak(hyperionInstance)
 {
 	QString subComponent{ "__" };
@@ -225,6 +255,22 @@ bool ImageProcessor::blackBorderDetectorEnabled() const
 	return _borderProcessor->enabled();
 }
 
+bool ImageProcessor::isSettled() const
+{
+	// The dominant color advanced mappings refine the clusters of the same image, until they converged
+	if ((_mappingType == 5 || _mappingType == 6) && !_imageToLedColors.isNull() && !_imageToLedColors->isKMeansConverged())
+	{
+		return false;
+	}
+
+	if (!_borderProcessor->enabled())
+	{
+		// A border still applied is reset with the next image
+		return _imageToLedColors.isNull() || (_imageToLedColors->horizontalBorder() == 0 && _imageToLedColors->verticalBorder() == 0);
+	}
+	return _borderProcessor->isSettled();
+}
+
 void ImageProcessor::setReducedPixelSetFactorFactor(int count)
 {
 
@@ -253,6 +299,11 @@ void ImageProcessor::setAccuracyLevel(int level)
 	if (!_imageToLedColors.isNull())
 	{
 		_imageToLedColors->setAccuracyLevel(_accuracyLevel);
+
+		// The dominant color mappings depend on the accuracy, instances of another accuracy must not share the LED colors
+		_mappingKey = mappingKey(_imageToLedColors->width(), _imageToLedColors->height(),
+								 _imageToLedColors->horizontalBorder(), _imageToLedColors->verticalBorder(),
+								 _reducedPixelSetFactorFactor, _accuracyLevel, _ledString.leds());
 	}
 }
 
@@ -296,6 +347,17 @@ void ImageProcessor::setHardLedMappingType(int mapType)
 	}
 }
 
+ImageToLedsMap::KMeansStatistics ImageProcessor::takeKMeansStatistics()
+{
+	ImageToLedsMap::KMeansStatistics statistics = _kmeansStatistics;
+	_kmeansStatistics = ImageToLedsMap::KMeansStatistics();
+	if (_imageToLedColors)
+	{
+		statistics += _imageToLedColors->takeKMeansStatistics();
+	}
+	return statistics;
+}
+
 bool ImageProcessor::getScanParameters(size_t led, double &hscanBegin, double &hscanEnd, double &vscanBegin, double &vscanEnd) const
 {
 	qCDebug(imageProcessor_track) << "Get scan parameters for LED" << led;
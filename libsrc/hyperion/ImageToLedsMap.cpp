@@ -5,6 +5,15 @@ Q_LOGGING_CATEGORY(imageToLedsMap_calc, "hyperion.imageToLedsMap.calc");
 
 using namespace hyperion;
 
+namespace {
+	// Range of bits per color channel used for the dominant color histogram
+	const int MIN_HISTOGRAM_BITS = 4;
+	const int MAX_HISTOGRAM_BITS = 6;
+
+	// Pixels per area evaluated during k-means at accuracy level 0, doubled per level
+	const int KMEANS_SAMPLE_LIMIT_BASE = 256;
+}
+
 ImageToLedsMap::ImageToLedsMap(
 		QSharedPointer<Logger> log,
 		int width,
@@ -21,7 +30,17 @@ ImageToLedsMap::ImageToLedsMap(
 	, _verticalBorder(verticalBorder)
 	, _nextPixelCount(reducedPixelSetFactor)
 	, _clusterCount()
+	, _kmeansSampleLimit()
+	, _histogramBits()
 	, _colorsMap()
+	, _totalPixelCount(0)
+	, _dirtyBlocks()
+	, _previousColors()
+	, _previousColorSource(ColorSource::None)
+	, _kmeansStates()
+	, _kmeansUniState()
+	, _kmeansStatistics()
+	, _isKMeansConverged(true)
 {
 	TRACK_SCOPE();
 
@@ -35,6 +54,7 @@ ImageToLedsMap::ImageToLedsMap(
 
 	// Reserve enough space in the map for the leds
 	_colorsMap.reserve(leds.size());
+	_dirtyBlocks.setSize(_width, _height);
 
 	const int xOffset      = _verticalBorder;
 	const int actualWidth  = _width  - 2 * _verticalBorder;
@@ -50,7 +70,7 @@ ImageToLedsMap::ImageToLedsMap(
 		// skip leds without area
 		if ((led.maxX_frac-led.minX_frac) < 1e-6 || (led.maxY_frac-led.minY_frac) < 1e-6)
 		{
-			_colorsMap.append(QVector<int>());
+			_colorsMap.append(LedArea());
 			continue;
 		}
 
@@ -72,7 +92,7 @@ ImageToLedsMap::ImageToLedsMap(
 			maxY_idx++;
 		}
 
-		// Add all the indices in the above defined rectangle to the indices for this led
+		// Add a run per row of the above defined rectangle to the area for this led
 		const int maxYLedCount = qMin(maxY_idx, yOffset+actualHeight);
 		const int maxXLedCount = qMin(maxX_idx, xOffset+actualWidth);
 
@@ -87,30 +107,43 @@ ImageToLedsMap::ImageToLedsMap(
 			ledsWithForcedSkippedPixels.append(ledCounter);
 		}
 
-		QVector<int> ledColors;
-		ledColors.reserve(totalSize);
-		for (int y = minY_idx; y < maxYLedCount; y += _nextPixelCount)
+		LedArea ledArea;
+		ledArea.minX = minX_idx;
+		ledArea.minY = minY_idx;
+		ledArea.maxX = maxXLedCount;
+		ledArea.maxY = maxYLedCount;
+
+		const int runLength = (maxXLedCount > minX_idx) ? (maxXLedCount - minX_idx + _nextPixelCount - 1) / _nextPixelCount : 0;
+		if (runLength > 0)
 		{
-			for (int x = minX_idx; x < maxXLedCount; x += _nextPixelCount)
+			ledArea.runs.reserve((realYLedCount + _nextPixelCount - 1) / _nextPixelCount);
+			for (int y = minY_idx; y < maxYLedCount; y += _nextPixelCount)
 			{
-				ledColors.append( y * actualWidth + x);
+				ledArea.runs.append({ y * _width + minX_idx, runLength, _nextPixelCount });
+				ledArea.pixelCount += runLength;
 			}
 		}
 
-		_colorsMap.append(ledColors);
-		qCDebug(imageToLedsMap_track) << "-> LED/light [" << ledCounter << "] pixels:" << totalSize << ", Skipping every" << _nextPixelCount << "pixels =>" << _colorsMap.last().size() << "pixels mapped";	
+		_colorsMap.append(ledArea);
+		if (!ledArea.isEmpty())
+		{
+			_dirtyBlocks.watch(ledArea.minX, ledArea.minY, ledArea.maxX, ledArea.maxY);
+		}
+		qCDebug(imageToLedsMap_track) << "-> LED/light [" << ledCounter << "] pixels:" << totalSize << ", Skipping every" << _nextPixelCount << "pixels =>" << ledArea.pixelCount << "pixels mapped in" << ledArea.runs.size() << "runs";
 
-		totalCount += ledColors.size();
+		totalCount += ledArea.pixelCount;
 
 		ledCounter++;
 	}
 
+	_totalPixelCount = static_cast<qint64>(totalCount);
+
 	WarningIf(!ledsWithForcedSkippedPixels.isEmpty(), _log,
 			  "[%d] LED mapping area(s) have a huge number of pixels to be processed. "
 			  "Every %d pixels will be skipped to improve performance. Enable reduced processing to hide this warning.",
 			  ledsWithForcedSkippedPixels.size(), _nextPixelCount);
 
-	qCDebug(imageToLedsMap_track) << "LED areas:" << leds.size() << ", #indicies:" << totalCount
+	qCDebug(imageToLedsMap_track) << "LED areas:" << leds.size() << ", #pixels:" << totalCount
 					 			 << ", H-border:" << horizontalBorder << ", V-border:" << verticalBorder
 								  << ", Reduced pixel factor:" << reducedPixelSetFactor << ", Accuracy:" << accuracyLevel
 								  << ", Image size:" << width << "x" << height;
@@ -131,6 +164,29 @@ int ImageToLedsMap::height() const
 	return _height;
 }
 
+void ImageToLedsMap::getMeanLedColor(const IntegralImage& integralImage, QVector<ColorRgb>& ledColors) const
+{
+	qCDebug(imageToLedsMap_calc) << "Get Mean Color for integral image sized" << integralImage.width() << "x" << integralImage.height() << "and #ledColors" << ledColors.size();
+	if (_colorsMap.size() != ledColors.size())
+	{
+		Debug(_log, "Get Mean Color (integral) failed. colorsMap.size != ledColors.size -> %d != %d", _colorsMap.size(), ledColors.size());
+		return;
+	}
+
+	if (integralImage.width() != _width || integralImage.height() != _height)
+	{
+		Debug(_log, "Get Mean Color (integral) failed. Integral image size %dx%d does not match %dx%d", integralImage.width(), integralImage.height(), _width, _height);
+		return;
+	}
+
+	// Four lookups per LED, independent of the area's size
+	auto led = ledColors.begin();
+	for (auto area = _colorsMap.begin(); area != _colorsMap.end(); ++area, ++led)
+	{
+		*led = area->isEmpty() ? ColorRgb::BLACK : integralImage.meanColor(area->minX, area->minY, area->maxX, area->maxY);
+	}
+}
+
 void ImageToLedsMap::setAccuracyLevel (int accuracyLevel)
 {
 	if (accuracyLevel > 4 )
@@ -140,6 +196,29 @@ void ImageToLedsMap::setAccuracyLevel (int accuracyLevel)
 	}
 	//Set cluster number for dominant color advanced
 	_clusterCount  = accuracyLevel + 1;
+	//Limit the pixels evaluated per area for dominant color advanced, all pixels are evaluated at the highest level
+	_kmeansSampleLimit = (accuracyLevel < 4) ? (KMEANS_SAMPLE_LIMIT_BASE << qMax(0, accuracyLevel)) : 0;
+
+	//Set quantization for dominant color, i.e. 4 (level 0-1), 5 (level 2) or 6 (level 3-4) bits per channel
+	_histogramBits = qBound(MIN_HISTOGRAM_BITS, accuracyLevel + 3, MAX_HISTOGRAM_BITS);
+
+	//The colors of the previous frame were determined with the former accuracy
+	_previousColorSource = ColorSource::None;
 
 }
 
+
+ImageToLedsMap::KMeansStatistics ImageToLedsMap::takeKMeansStatistics()
+{
+	KMeansStatistics statistics = _kmeansStatistics;
+	_kmeansStatistics = KMeansStatistics();
+	return statistics;
+}
+
+void ImageToLedsMap::updateKMeansStatistics(int areas, int iterations, std::chrono::nanoseconds duration) const
+{
+	++_kmeansStatistics.frames;
+	_kmeansStatistics.areas += static_cast<quint64>(areas);
+	_kmeansStatistics.iterations += static_cast<quint64>(iterations);
+	_kmeansStatistics.duration += duration;
+}
@@ -0,0 +1,49 @@
+#include <hyperion/IntegralImage.h>
+
+using namespace hyperion;
+
+IntegralImage::IntegralImage()
+	: _width(0)
+	, _height(0)
+	, _sums()
+{
+}
+
+void IntegralImage::resize(int width, int height)
+{
+	if (width == _width && height == _height)
+	{
+		return;
+	}
+
+	_width = width;
+	_height = height;
+	_sums.assign(static_cast<size_t>(_width + 1) * static_cast<size_t>(_height + 1), ChannelSums{0, 0, 0});
+}
+
+ColorRgb IntegralImage::meanColor(int minX, int minY, int maxX, int maxY) const
+{
+	if (minX >= maxX || minY >= maxY || maxX > _width || maxY > _height || minX < 0 || minY < 0)
+	{
+		return ColorRgb::BLACK;
+	}
+
+	const size_t stride = static_cast<size_t>(_width) + 1;
+	const ChannelSums &topLeft = _sums[static_cast<size_t>(minY) * stride + minX];
+	const ChannelSums &topRight = _sums[static_cast<size_t>(minY) * stride + maxX];
+	const ChannelSums &bottomLeft = _sums[static_cast<size_t>(maxY) * stride + minX];
+	const ChannelSums &bottomRight = _sums[static_cast<size_t>(maxY) * stride + maxX];
+
+	const auto pixelNum = static_cast<uint32_t>((maxX - minX) * (maxY - minY));
+
+	// Unsigned arithmetic, intermediate wrap-arounds cancel out
+	const uint32_t sumRed = bottomRight.red - bottomLeft.red - topRight.red + topLeft.red;
+	const uint32_t sumGreen = bottomRight.green - bottomLeft.green - topRight.green + topLeft.green;
+	const uint32_t sumBlue = bottomRight.blue - bottomLeft.blue - topRight.blue + topLeft.blue;
+
+	return {
+		static_cast<uint8_t>(sumRed / pixelNum),
+		static_cast<uint8_t>(sumGreen / pixelNum),
+		static_cast<uint8_t>(sumBlue / pixelNum)
+	};
+}
@@ -0,0 +1,257 @@
+#include <hyperion/LedColorPlanes.h>
+
+// STL includes
+#include <algorithm>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LEDCOLORPLANES_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define LEDCOLORPLANES_NEON
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+/// Source channel per output channel of a color order
+std::array<int, 3> sourceChannels(ColorOrder order)
+{
+	using Channel = LedColorPlanes::Channel;
+
+	switch (order)
+	{
+	case ColorOrder::ORDER_RBG:
+		return {{ Channel::RED, Channel::BLUE, Channel::GREEN }};
+	case ColorOrder::ORDER_GRB:
+		return {{ Channel::GREEN, Channel::RED, Channel::BLUE }};
+	case ColorOrder::ORDER_BRG:
+		return {{ Channel::BLUE, Channel::RED, Channel::GREEN }};
+	case ColorOrder::ORDER_GBR:
+		return {{ Channel::GREEN, Channel::BLUE, Channel::RED }};
+	case ColorOrder::ORDER_BGR:
+		return {{ Channel::BLUE, Channel::GREEN, Channel::RED }};
+	case ColorOrder::ORDER_RGB:
+	default:
+		return {{ Channel::RED, Channel::GREEN, Channel::BLUE }};
+	}
+}
+
+///
+/// Selects per LED one of the source planes: out = (red & maskRed) | (green & maskGreen) | (blue & maskBlue)
+///
+void selectChannel(const std::array<const uint8_t*, 3>& sources, const std::array<const uint8_t*, 3>& masks, uint8_t* out, int count)
+{
+	int i = 0;
+
+#if defined(LEDCOLORPLANES_SSE2)
+	for (; i + 16 <= count; i += 16)
+	{
+		const __m128i red = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(sources[0] + i)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks[0] + i)));
+		const __m128i green = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(sources[1] + i)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks[1] + i)));
+		const __m128i blue = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(sources[2] + i)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks[2] + i)));
+		_mm_store_si128(reinterpret_cast<__m128i*>(out + i), _mm_or_si128(_mm_or_si128(red, green), blue));
+	}
+#elif defined(LEDCOLORPLANES_NEON)
+	for (; i + 16 <= count; i += 16)
+	{
+		const uint8x16_t red = vandq_u8(vld1q_u8(sources[0] + i), vld1q_u8(masks[0] + i));
+		const uint8x16_t green = vandq_u8(vld1q_u8(sources[1] + i), vld1q_u8(masks[1] + i));
+		const uint8x16_t blue = vandq_u8(vld1q_u8(sources[2] + i), vld1q_u8(masks[2] + i));
+		vst1q_u8(out + i, vorrq_u8(vorrq_u8(red, green), blue));
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		out[i] = static_cast<uint8_t>((sources[0][i] & masks[0][i]) | (sources[1][i] & masks[1][i]) | (sources[2][i] & masks[2][i]));
+	}
+}
+
+} // namespace
+
+LedColorPlanes::ColorOrderMap::ColorOrderMap(const QVector<ColorOrder>& colorOrders)
+	: _size(static_cast<int>(colorOrders.size()))
+{
+	if (colorOrders.isEmpty())
+	{
+		return;
+	}
+
+	_isUniform = std::all_of(colorOrders.begin(), colorOrders.end(), [&colorOrders](ColorOrder order) {
+		return order == colorOrders.first();
+	});
+
+	if (_isUniform)
+	{
+		_uniformSource = sourceChannels(colorOrders.first());
+		return;
+	}
+
+	for (auto& outputMasks : _masks)
+	{
+		for (std::vector<uint8_t>& mask : outputMasks)
+		{
+			mask.assign(static_cast<size_t>(_size), 0);
+		}
+	}
+
+	for (int i = 0; i < _size; ++i)
+	{
+		const std::array<int, 3> source = sourceChannels(colorOrders.at(i));
+		for (int output = 0; output < 3; ++output)
+		{
+			_masks[output][source[output]][i] = UINT8_MAX;
+		}
+	}
+}
+
+LedColorPlanes::LedColorPlanes()
+	: _size(0)
+	, _stride(0)
+	, _planes{{ nullptr, nullptr, nullptr }}
+	, _scratch{{ nullptr, nullptr, nullptr }}
+{
+	resize(0);
+}
+
+void LedColorPlanes::resize(int size)
+{
+	_size = size;
+
+	const int stride = std::max(ALIGNMENT, (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT);
+	if (stride == _stride)
+	{
+		return;
+	}
+	_stride = stride;
+
+	_buffer.assign(static_cast<size_t>(6 * _stride + ALIGNMENT), 0);
+	uint8_t* base = _buffer.data();
+	base += (ALIGNMENT - reinterpret_cast<uintptr_t>(base) % ALIGNMENT) % ALIGNMENT;
+
+	for (int channel = 0; channel < 3; ++channel)
+	{
+		_planes[channel] = base + channel * _stride;
+		_scratch[channel] = base + (3 + channel) * _stride;
+	}
+}
+
+void LedColorPlanes::assign(const QVector<ColorRgb>& colors)
+{
+	resize(static_cast<int>(colors.size()));
+
+	const uint8_t* source = reinterpret_cast<const uint8_t*>(colors.constData());
+	uint8_t* red = _planes[RED];
+	uint8_t* green = _planes[GREEN];
+	uint8_t* blue = _planes[BLUE];
+
+	int i = 0;
+#if defined(LEDCOLORPLANES_NEON)
+	for (; i + 16 <= _size; i += 16)
+	{
+		const uint8x16x3_t rgb = vld3q_u8(source + 3 * i);
+		vst1q_u8(red + i, rgb.val[0]);
+		vst1q_u8(green + i, rgb.val[1]);
+		vst1q_u8(blue + i, rgb.val[2]);
+	}
+#endif
+	for (; i < _size; ++i)
+	{
+		red[i] = source[3 * i];
+		green[i] = source[3 * i + 1];
+		blue[i] = source[3 * i + 2];
+	}
+}
+
+void LedColorPlanes::copyTo(QVector<ColorRgb>& colors) const
+{
+	const int count = std::min(_size, static_cast<int>(colors.size()));
+	if (count <= 0)
+	{
+		return;
+	}
+
+	uint8_t* target = reinterpret_cast<uint8_t*>(colors.data());
+	const uint8_t* red = _planes[RED];
+	const uint8_t* green = _planes[GREEN];
+	const uint8_t* blue = _planes[BLUE];
+
+	int i = 0;
+#if defined(LEDCOLORPLANES_NEON)
+	for (; i + 16 <= count; i += 16)
+	{
+		uint8x16x3_t rgb;
+		rgb.val[0] = vld1q_u8(red + i);
+		rgb.val[1] = vld1q_u8(green + i);
+		rgb.val[2] = vld1q_u8(blue + i);
+		vst3q_u8(target + 3 * i, rgb);
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		target[3 * i] = red[i];
+		target[3 * i + 1] = green[i];
+		target[3 * i + 2] = blue[i];
+	}
+}
+
+void LedColorPlanes::setBlack(const QVector<int>& ids)
+{
+	for (const int id : ids)
+	{
+		if (id >= 0 && id < _size)
+		{
+			_planes[RED][id] = 0;
+			_planes[GREEN][id] = 0;
+			_planes[BLUE][id] = 0;
+		}
+	}
+}
+
+void LedColorPlanes::applyColorOrder(const ColorOrderMap& map)
+{
+	const int count = std::min(_size, map._size);
+	if (count <= 0)
+	{
+		return;
+	}
+
+	if (map._isUniform)
+	{
+		const std::array<int, 3>& source = map._uniformSource;
+		if (source[RED] == RED && source[GREEN] == GREEN && source[BLUE] == BLUE)
+		{
+			return;
+		}
+
+		// Exchanging the planes reorders all LEDs at once
+		const std::array<uint8_t*, 3> planes = _planes;
+		for (int output = 0; output < 3; ++output)
+		{
+			_planes[output] = planes[source[output]];
+		}
+
+		// LEDs beyond the map keep their order
+		for (int i = count; i < _size; ++i)
+		{
+			const uint8_t original[3] = { planes[RED][i], planes[GREEN][i], planes[BLUE][i] };
+			for (int output = 0; output < 3; ++output)
+			{
+				_planes[output][i] = original[output];
+			}
+		}
+		return;
+	}
+
+	const std::array<const uint8_t*, 3> sources {{ _planes[RED], _planes[GREEN], _planes[BLUE] }};
+	for (int output = 0; output < 3; ++output)
+	{
+		const std::array<const uint8_t*, 3> masks {{ map._masks[output][RED].data(), map._masks[output][GREEN].data(), map._masks[output][BLUE].data() }};
+		selectChannel(sources, masks, _scratch[output], count);
+		std::copy(_planes[output] + count, _planes[output] + _size, _scratch[output] + count);
+	}
+	std::swap(_planes, _scratch);
+}
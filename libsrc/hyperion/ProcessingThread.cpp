@@ -0,0 +1,117 @@
+#include <hyperion/ProcessingThread.h>
+
+// STL includes
+#include <cstring>
+#include <memory>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+ProcessingThread::ProcessingThread(std::function<void(Frame&)> process, int realtimePriority, int cpuAffinity, QSharedPointer<Logger> log)
+	: QThread()
+	, _process(std::move(process))
+	, _realtimePriority(realtimePriority)
+	, _cpuAffinity(cpuAffinity)
+	, _log(std::move(log))
+	, _mailbox(nullptr)
+	, _isStopping(false)
+{
+	setObjectName("OutputProcessing");
+}
+
+ProcessingThread::~ProcessingThread()
+{
+	stop();
+}
+
+bool ProcessingThread::post(Frame&& frame)
+{
+	Frame* const previous = _mailbox.exchange(new Frame(std::move(frame)), std::memory_order_acq_rel);
+	if (previous != nullptr)
+	{
+		// The thread has not picked up the previous frame yet and will process the new one instead
+		delete previous;
+		return false;
+	}
+
+	_frameAvailable.release();
+	return true;
+}
+
+void ProcessingThread::stop()
+{
+	if (_isStopping.exchange(true))
+	{
+		return;
+	}
+
+	_frameAvailable.release();
+	wait();
+
+	delete _mailbox.exchange(nullptr, std::memory_order_acq_rel);
+}
+
+void ProcessingThread::run()
+{
+	applySchedulingPolicy();
+
+	while (true)
+	{
+		_frameAvailable.acquire();
+		if (_isStopping.load())
+		{
+			break;
+		}
+
+		const std::unique_ptr<Frame> frame(_mailbox.exchange(nullptr, std::memory_order_acq_rel));
+		if (frame)
+		{
+			_process(*frame);
+		}
+	}
+}
+
+void ProcessingThread::applySchedulingPolicy()
+{
+#if defined(__linux__)
+	if (_realtimePriority > 0)
+	{
+		sched_param parameter {};
+		parameter.sched_priority = qBound(sched_get_priority_min(SCHED_FIFO), _realtimePriority, sched_get_priority_max(SCHED_FIFO));
+
+		const int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &parameter);
+		if (error != 0)
+		{
+			Warning(_log, "Cannot run output processing with real-time priority %d: %s", parameter.sched_priority, strerror(error));
+		}
+		else
+		{
+			Debug(_log, "Output processing runs with real-time priority %d", parameter.sched_priority);
+		}
+	}
+
+	if (_cpuAffinity >= 0)
+	{
+		cpu_set_t cpus;
+		CPU_ZERO(&cpus);
+		CPU_SET(_cpuAffinity, &cpus);
+
+		const int error = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+		if (error != 0)
+		{
+			Warning(_log, "Cannot pin output processing to CPU %d: %s", _cpuAffinity, strerror(error));
+		}
+		else
+		{
+			Debug(_log, "Output processing is pinned to CPU %d", _cpuAffinity);
+		}
+	}
+#else
+	if (_realtimePriority > 0 || _cpuAffinity >= 0)
+	{
+		Warning(_log, "Real-time priority and CPU affinity of the output processing are only supported on Linux");
+	}
+#endif
+}
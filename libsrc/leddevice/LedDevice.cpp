@@ -3,6 +3,7 @@
 #include <sstream>
 #include <iomanip>
 #include <chrono>
+#include <cstring>
 
 #include <QResource>
 #include <QStringList>
@@ -34,10 +35,14 @@ namespace {
 	const char CONFIG_AUTOSTART[] = "autoStart";
 	const char CONFIG_LATCH_TIME[] = "latchTime";
 	const char CONFIG_REWRITE_TIME[] = "rewriteTime";
+	const char CONFIG_PARTIAL_UPDATE[] = "partialUpdate";
+	const char CONFIG_FULL_REFRESH_TIME[] = "fullRefreshTime";
 
 	const int DEFAULT_LED_COUNT{ 1 };
 	const char DEFAULT_COLOR_ORDER[]{ "RGB" };
 	const bool DEFAULT_IS_AUTOSTART{ true };
+	const bool DEFAULT_IS_PARTIAL_UPDATE{ false };
+	constexpr std::chrono::milliseconds DEFAULT_FULL_REFRESH_TIME{ 1000 };
 
 	const char CONFIG_ENABLE_ATTEMPTS[] = "enableAttempts";
 	const char CONFIG_ENABLE_ATTEMPTS_INTERVALL[] = "enableAttemptsInterval";
@@ -65,13 +70,17 @@ LedDevice::LedDevice(const QJsonObject& deviceConfig, QObject* parent)
 	, _isOn(false)
 	, _isDeviceInError(false)
 	, _isDeviceRecoverable(false)
-	, _lastWriteTime(QDateTime::currentDateTime())
+	, _lastWriteTime(std::chrono::steady_clock::now())
 	, _enableAttemptsTimer(nullptr)
 	, _enableAttemptTimerInterval(DEFAULT_ENABLE_ATTEMPTS_INTERVAL)
 	, _enableAttempts(0)
 	, _maxEnableAttempts(DEFAULT_MAX_ENABLE_ATTEMPTS)
 	, _isRefreshEnabled(false)
 	, _isAutoStart(true)
+	, _isPartialUpdate(DEFAULT_IS_PARTIAL_UPDATE)
+	, _fullRefreshTime_ms(static_cast<int>(DEFAULT_FULL_REFRESH_TIME.count()))
+	, _isFullUpdate(true)
+	, _lastFullUpdateTime(std::chrono::steady_clock::now())
 {
 	_activeDeviceType = deviceConfig["type"].toString("UNSPECIFIED").toLower();
 	TRACK_SCOPE_SUBCOMPONENT() << _activeDeviceType;	
@@ -122,6 +131,7 @@ void LedDevice::stop()
 	this->disable();
 	waitForPendingSwitchOff();
 	this->stopRefreshTimer();
+	this->stopLatchTimer();
 	Info(_log, "Stopped LedDevice '%s'", QSTRING_CSTR(_activeDeviceType));
 	emit isStopped();
 }
@@ -149,6 +159,7 @@ void LedDevice::setInError(const QString& errorMsg, bool isRecoverable)
 	_isDeviceReady = false;
 	_isEnabled = false;
 	this->stopRefreshTimer();
+	this->stopLatchTimer();
 
 	if (isRecoverable)
 	{
@@ -246,6 +257,8 @@ bool LedDevice::init(const QJsonObject& deviceConfig)
 	setColorOrder(deviceConfig[CONFIG_COLOR_ORDER].toString(DEFAULT_COLOR_ORDER));
 	setLatchTime(deviceConfig[CONFIG_LATCH_TIME].toInt(_latchTime_ms));
 	setRewriteTime(deviceConfig[CONFIG_REWRITE_TIME].toInt(_refreshTimerInterval_ms));
+	setPartialUpdate(deviceConfig[CONFIG_PARTIAL_UPDATE].toBool(DEFAULT_IS_PARTIAL_UPDATE),
+					 deviceConfig[CONFIG_FULL_REFRESH_TIME].toInt(static_cast<int>(DEFAULT_FULL_REFRESH_TIME.count())));
 	setAutoStart(deviceConfig[CONFIG_AUTOSTART].toBool(DEFAULT_IS_AUTOSTART));
 	setEnableAttempts(deviceConfig[CONFIG_ENABLE_ATTEMPTS].toInt(DEFAULT_MAX_ENABLE_ATTEMPTS),
 	std::chrono::seconds(deviceConfig[CONFIG_ENABLE_ATTEMPTS_INTERVALL].toInt(DEFAULT_ENABLE_ATTEMPTS_INTERVAL.count()))
@@ -372,15 +385,30 @@ int LedDevice::writeLedUpdate(const QVector<ColorRgb>& ledValues)
 		return -1;
 	}
 
-	qint64 const elapsedTimeMs = _lastWriteTime.msecsTo(QDateTime::currentDateTime());
+	auto const now = std::chrono::steady_clock::now();
+	auto const elapsedTime = now - _lastWriteTime;
 	trackDevice(leddevice_write, "Writing LED values to") << QString("Time since last write: %1 ms, Latch time: %2 ms, number of LEDs: %3")
-									.arg(elapsedTimeMs)
+									.arg(std::chrono::duration<double, std::milli>(elapsedTime).count(), 0, 'f', 3)
 									.arg(_latchTime_ms)
 									.arg(ledValues.size());
 
-	if (_latchTime_ms > 0 && elapsedTimeMs < _latchTime_ms)
+	std::chrono::milliseconds const latchTime{ _latchTime_ms };
+	if (_latchTime_ms > 0 && elapsedTime < latchTime)
 	{
-		// Skip write as elapsedTime < latchTime
+		// Defer the write to the end of the latch time, the newest update is written then
+		if (_latchTimer.isNull())
+		{
+			_latchTimer.reset(new QTimer());
+			_latchTimer->setTimerType(Qt::PreciseTimer);
+			_latchTimer->setSingleShot(true);
+			connect(_latchTimer.get(), &QTimer::timeout, this, &LedDevice::processDeferredLedUpdate);
+		}
+
+		if (!_latchTimer->isActive())
+		{
+			_latchTimer->start(std::chrono::ceil<std::chrono::milliseconds>(latchTime - elapsedTime));
+		}
+
 		if (_isRefreshEnabled)
 		{
 			//Stop timer to allow for next non-refresh update
@@ -388,9 +416,33 @@ int LedDevice::writeLedUpdate(const QVector<ColorRgb>& ledValues)
 		}
 		return 0;
 	}
+	this->stopLatchTimer();
+
+	// With partial updates, parts unchanged since the last update written may be skipped, unless a full refresh is due
+	_isFullUpdate = !_isPartialUpdate
+					|| _writtenLedValues.size() != ledValues.size()
+					|| now - _lastFullUpdateTime >= std::chrono::milliseconds(_fullRefreshTime_ms);
 
 	int const result = write(ledValues);
-	_lastWriteTime = QDateTime::currentDateTime();
+	_lastWriteTime = std::chrono::steady_clock::now();
+
+	if (_isPartialUpdate)
+	{
+		if (result >= 0)
+		{
+			_writtenLedValues = ledValues;
+			if (_isFullUpdate)
+			{
+				_lastFullUpdateTime = _lastWriteTime;
+			}
+		}
+		else
+		{
+			// The state of the LEDs is unknown, write all LEDs next time
+			_writtenLedValues.clear();
+		}
+	}
+	_isFullUpdate = true;
 
 	// if device requires refreshing, save Led-Values and restart the timer
 	if (_isRefreshEnabled && _isEnabled)
@@ -402,6 +454,25 @@ int LedDevice::writeLedUpdate(const QVector<ColorRgb>& ledValues)
 	return result;
 }
 
+void LedDevice::processDeferredLedUpdate()
+{
+	trackDevice(leddevice_write, "Write deferred LED values") << (_isLedUpdatePending.load() ? ", but skipping as an LED update is pending." : "will be executed.");
+
+	// A pending update writes the newest LED values itself
+	if (!_isLedUpdatePending.exchange(true))
+	{
+		processLedUpdate();
+	}
+}
+
+void LedDevice::stopLatchTimer()
+{
+	if (!_latchTimer.isNull())
+	{
+		_latchTimer->stop();
+	}
+}
+
 int LedDevice::rewriteLEDs()
 {
 	trackDevice(leddevice_write, "Rewriting LED values") << (_isLedUpdatePending.load() ? ", but skipping update as an LED update is pending." : "will be executed.");
@@ -431,6 +502,7 @@ int LedDevice::rewriteLEDs()
 	{
 		trackDevice(leddevice_write, "Rewriting LED values");
 		success = write(_lastLedValues);
+		_lastWriteTime = std::chrono::steady_clock::now();
 		_isLedUpdatePending.store(false);		
 	}
 
@@ -457,9 +529,30 @@ int LedDevice::writeColor(const ColorRgb& color, int numberOfWrites)
 		_lastLedValues = QVector<ColorRgb>(_ledCount, color);
 		rc = write(_lastLedValues);
 	}
+
+	// Not a reference for partial updates, e.g. devices might ignore a color written while being switched off
+	_writtenLedValues.clear();
+
 	return rc;
 }
 
+bool LedDevice::isLedRangeChanged(const QVector<ColorRgb>& ledValues, int firstLed, int count) const
+{
+	if (_isFullUpdate)
+	{
+		return true;
+	}
+
+	firstLed = qMax(firstLed, 0);
+	const int lastLed = qMin(firstLed + count, static_cast<int>(ledValues.size()));
+	if (lastLed > _writtenLedValues.size())
+	{
+		return true;
+	}
+
+	return lastLed > firstLed && memcmp(ledValues.constData() + firstLed, _writtenLedValues.constData() + firstLed, static_cast<size_t>(lastLed - firstLed) * sizeof(ColorRgb)) != 0;
+}
+
 void LedDevice::waitForPendingSwitchOff() const
 {
 	trackDevice(leddevice_flow, "Waiting for pending Switch OFF") << (_isSwitchOffInProgress.load() ? "is in progress" : "is not in required");
@@ -557,6 +650,7 @@ bool LedDevice::switchOn()
 			{
 				Info(_log, "Device %s is ON", QSTRING_CSTR(_activeDeviceType));
 				_isOn = true;
+				_writtenLedValues.clear();
 			}
 			else
 			{
@@ -597,6 +691,7 @@ bool LedDevice::switchOff()
 
 	// Disable device to ensure no standard LED updates are written/processed
 	_isOn = false;
+	this->stopLatchTimer();
 
 	if (_isDeviceReady)
 	{
@@ -791,6 +886,18 @@ void LedDevice::setRewriteTime(int rewriteTime_ms)
 	}
 }
 
+void LedDevice::setPartialUpdate(bool isPartialUpdate, int fullRefreshTime_ms)
+{
+	_isPartialUpdate = isPartialUpdate;
+	_fullRefreshTime_ms = qMax(fullRefreshTime_ms, 0);
+	_writtenLedValues.clear();
+
+	if (_isPartialUpdate)
+	{
+		Debug(_log, "Partial updates enabled, full refresh interval = %dms", _fullRefreshTime_ms);
+	}
+}
+
 void LedDevice::setEnableAttempts(int maxEnableRetries, std::chrono::seconds enableRetryTimerInterval)
 {
 	stopEnableAttemptsTimer();
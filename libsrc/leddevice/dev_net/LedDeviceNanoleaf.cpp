@@ -807,14 +807,21 @@ int LedDeviceNanoleaf::write(const QVector<ColorRgb>& ledValues)
 
 	int i = 0;
 
-	// Set number of panels
-	qToBigEndian<quint16>(static_cast<quint16>(_panelLedCount), udpbuffer.data() + i);
+	// Number of panels is set, once the panels to be sent are known
 	i += 2;
+	int panelsToSend = 0;
 
 	ColorRgb color;
 
 	for (int panelCounter = 0; panelCounter < _panelLedCount; ++panelCounter)
 	{
+		// Skip panels not changed, panels not configured are set with full updates only
+		if (panelCounter < this->getLedCount() ? !isLedRangeChanged(ledValues, panelCounter, 1) : !isFullUpdate())
+		{
+			continue;
+		}
+		++panelsToSend;
+
 		// Set panelID
 		int panelID = _panelIds[panelCounter];
 		qToBigEndian<quint16>(static_cast<quint16>(panelID), udpbuffer.data() + i);
@@ -850,6 +857,15 @@ int LedDeviceNanoleaf::write(const QVector<ColorRgb>& ledValues)
 		qCDebug(leddevice_write) << QString("[%1] Color: {%2,%3,%4}").arg(panelCounter).arg(color.red).arg(color.green).arg(color.blue);
 	}
 
+	if (panelsToSend == 0)
+	{
+		return retVal;
+	}
+
+	// Set number of panels
+	qToBigEndian<quint16>(static_cast<quint16>(panelsToSend), udpbuffer.data());
+	udpbuffer.resize(i);
+
 	qCDebug(leddevice_write) << QString("UDP-Address [%1], UDP-Port [%2], udpBufferSize[%3], Bytes to send [%4]").arg(_hostName).arg(_port).arg(udpBufferSize).arg(i);
 	qCDebug(leddevice_write) << QString("packet: [%1]").arg(toHex(udpbuffer, 64));
 
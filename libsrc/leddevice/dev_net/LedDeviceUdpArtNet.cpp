@@ -118,6 +118,8 @@ int LedDeviceUdpArtNet::write(const QVector<ColorRgb> &ledValues)
 	}
 
 	int dmxIdx = 0; // offset into the current dmx packet
+	int ledIdx = 0; // the current LED
+	int packetFirstLed = 0; // the first LED of the current dmx packet
 
 	memset(artnet_packet.raw, 0, sizeof(artnet_packet.raw));
 
@@ -126,17 +128,18 @@ int LedDeviceUdpArtNet::write(const QVector<ColorRgb> &ledValues)
 		// Check if this LED would overflow the DMX packet
 		if (dmxIdx + _artnet_channelsPerFixture > DMX_MAX)
 		{
-			// Send current packet before continuing
-			prepare(thisUniverse, _artnet_seq, dmxIdx);
-
-			if (writeBytes(18 + dmxIdx, artnet_packet.raw) < 0)
+			// Queue current packet before continuing
+			// Skip universes without changed LEDs
+			if (isLedRangeChanged(ledValues, packetFirstLed, ledIdx - packetFirstLed))
 			{
-				retVal = -1;
+				prepare(thisUniverse, _artnet_seq, dmxIdx);
+				queueBytes(18 + dmxIdx, artnet_packet.raw);
 			}
 
 			memset(artnet_packet.raw, 0, sizeof(artnet_packet.raw));
 			thisUniverse++;
 			dmxIdx = 0;
+			packetFirstLed = ledIdx;
 		}
 
 		if (_whiteAlgorithm == RGBW::WhiteAlgorithm::WHITE_OFF)
@@ -156,17 +159,20 @@ int LedDeviceUdpArtNet::write(const QVector<ColorRgb> &ledValues)
 
 		// Skip extra channels if fixture needs more than RGB/RGBW
 		dmxIdx += (_artnet_channelsPerFixture - _ledChannelsPerFixture);
+		++ledIdx;
 	}
 
-	// Send the last packet if there's any data
-	if (dmxIdx > 0)
+	// Queue the last packet if there's any data
+	if (dmxIdx > 0 && isLedRangeChanged(ledValues, packetFirstLed, ledIdx - packetFirstLed))
 	{
 		prepare(thisUniverse, _artnet_seq, dmxIdx);
+		queueBytes(18 + dmxIdx, artnet_packet.raw);
+	}
 
-		if (writeBytes(18 + dmxIdx, artnet_packet.raw) < 0)
-		{
-			retVal = -1;
-		}
+	// All universes of the frame are sent at once
+	if (flushPackets() < 0)
+	{
+		retVal = -1;
 	}
 
 	return retVal;
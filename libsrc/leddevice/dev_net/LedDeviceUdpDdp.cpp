@@ -188,17 +188,26 @@ int LedDeviceUdpDdp::write(const QVector<ColorRgb> &ledValues)
 {
 	int rc {0};
 
+	// Nothing to be sent, if no LED changed
+	if (!isLedRangeChanged(ledValues, 0, static_cast<int>(ledValues.size())))
+	{
+		return rc;
+	}
+
 	int channelCount;
+	int channelsPerLed;
 	const char* dataPtr = nullptr;
 
 	if (_whiteAlgorithm == RGBW::WhiteAlgorithm::WHITE_OFF)
 	{
+		channelsPerLed = sizeof(ColorRgb);
 		channelCount = _ledRGBCount; // 1 channel for every R,G,B value
 		dataPtr =reinterpret_cast<const char*>(ledValues.data());
 	}
 	else
 	{
 		channelCount = _ledRGBWCount; // 1 channel for every R,G,B,W value
+		channelsPerLed = sizeof(ColorRgbw);
 
 		QVector<ColorRgbw> rgbwLedValues;
 		rgbwLedValues.resize(_ledCount);
@@ -221,6 +230,13 @@ int LedDeviceUdpDdp::write(const QVector<ColorRgb> &ledValues)
 		const bool isLastPacket = (currentPacket == packetCount - 1);
 		const int packetSize = isLastPacket ? (channelCount - channel) : DDP::CHANNELS_PER_PACKET;
 
+		// Skip packets without changed LEDs, the last packet is always sent as its PUSH flag makes the receiver display the data
+		if (!isLastPacket && !isLedRangeChanged(ledValues, channel / channelsPerLed, (channel + packetSize - 1) / channelsPerLed - channel / channelsPerLed + 1))
+		{
+			channel += packetSize;
+			continue;
+		}
+
 		/*0*/_ddpData[0] = DDP::flags1::VER1 | (isLastPacket ? DDP::flags1::PUSH : 0);
 		/*1*/_ddpData[1] = static_cast<char>(_packageSequenceNumber++ & 0x0F);
 		/*4*/qToBigEndian<quint32>(static_cast<quint32>(channel), _ddpData.data() + 4);
@@ -229,14 +245,14 @@ int LedDeviceUdpDdp::write(const QVector<ColorRgb> &ledValues)
 		_ddpData.replace(DDP::HEADER_LEN, packetSize, dataPtr + channel, packetSize);
 		_ddpData.resize(DDP::HEADER_LEN + packetSize);
 
-		rc = writeBytes(_ddpData);
+		queueBytes(_ddpData);
 
-		if (rc != 0)
-		{
-			break;
-		}
 		channel += packetSize;
 	}
+
+	// The last packet carries the PUSH flag, all packets of the frame are sent at once
+	rc = flushPackets();
+
 	return rc;
 }
 
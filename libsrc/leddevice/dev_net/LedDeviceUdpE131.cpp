@@ -180,6 +180,8 @@ int LedDeviceUdpE131::write(const QVector<ColorRgb> &ledValues)
 
 	_e131_seq++;
 
+	const int channelsPerLed = (_whiteAlgorithm == RGBW::WhiteAlgorithm::WHITE_OFF) ? 3 : 4;
+
 	for (auto rawIdx = 0; rawIdx < _dmxChannelCount; rawIdx++)
 	{
 		if (rawIdx % _e131_dmx_max == 0) // start of new packet
@@ -196,14 +198,27 @@ int LedDeviceUdpE131::write(const QVector<ColorRgb> &ledValues)
 		// is this the last byte of last packet || last byte of other packets
 		if ((rawIdx == _dmxChannelCount - 1) || (rawIdx % _e131_dmx_max == _e131_dmx_max - 1))
 		{
+			// Skip universes without changed LEDs, a LED might span two universes
+			const int firstChannel = rawIdx - rawIdx % _e131_dmx_max;
+			if (!isLedRangeChanged(ledValues, firstChannel / channelsPerLed, (rawIdx / channelsPerLed) - (firstChannel / channelsPerLed) + 1))
+			{
+				continue;
+			}
+
 			qCDebug(leddevice_write) << QString("send packet: rawidx %1 dmxchannelcount %2 universe: %3, packetsz %4")
 											.arg(rawIdx)
 											.arg(_dmxChannelCount)
 											.arg(_e131_universe + rawIdx / _e131_dmx_max)
 											.arg(thisChannelCount);
-			retVal &= writeBytes(E131_DMP_DATA + 1 + thisChannelCount, _e131_packet.raw);
+			queueBytes(E131_DMP_DATA + 1 + thisChannelCount, _e131_packet.raw);
 		}
 	}
 
+	// All universes of the frame are sent at once
+	if (flushPackets() < 0)
+	{
+		retVal = -1;
+	}
+
 	return retVal;
 }
@@ -7,6 +7,10 @@
 #include <exception>
 // Linux includes
 #include <fcntl.h>
+#ifdef __linux__
+#include <cerrno>
+#include <netinet/in.h>
+#endif
 
 
 #include <QStringList>
@@ -19,6 +23,13 @@ ProviderUdp::ProviderUdp(const QJsonObject& deviceConfig)
 	: LedDevice(deviceConfig)
 	  , _port(-1)
 	  , _udpSocket(nullptr)
+	  , _packetCount(0)
+#ifdef __linux__
+	  , _batchAddress()
+	  , _batchAddressLength(0)
+#endif
+	  , _packetsSent(0)
+	  , _sendCalls(0)
 {
 	_latchTime_ms = 0;
 }
@@ -62,9 +73,64 @@ int ProviderUdp::open()
 		}
 	}
 
+	setupBatchAddress();
+
 	return 0;
 }
 
+void ProviderUdp::setupBatchAddress()
+{
+#ifdef __linux__
+	_batchAddress = {};
+	_batchAddressLength = 0;
+
+	if (_udpSocket->state() != QAbstractSocket::BoundState)
+	{
+		return;
+	}
+
+	// A socket bound to QHostAddress::Any is dual-stack, i.e. IPv4 targets are addressed as IPv4-mapped IPv6 addresses
+	sockaddr_storage local {};
+	socklen_t localLength = sizeof(local);
+	if (getsockname(static_cast<int>(_udpSocket->socketDescriptor()), reinterpret_cast<sockaddr*>(&local), &localLength) != 0)
+	{
+		return;
+	}
+
+	bool isIPv4 {false};
+	const quint32 ipv4 = _ipAddress.toIPv4Address(&isIPv4);
+
+	if (local.ss_family == AF_INET && isIPv4)
+	{
+		auto* address = reinterpret_cast<sockaddr_in*>(&_batchAddress);
+		address->sin_family = AF_INET;
+		address->sin_port = htons(static_cast<uint16_t>(_port));
+		address->sin_addr.s_addr = htonl(ipv4);
+		_batchAddressLength = sizeof(sockaddr_in);
+	}
+	else if (local.ss_family == AF_INET6)
+	{
+		// Named scopes (e.g. fe80::1%eth0) are left to the socket engine
+		bool isNumericScope {true};
+		const uint32_t scopeId = isIPv4 || _ipAddress.scopeId().isEmpty() ? 0 : _ipAddress.scopeId().toUInt(&isNumericScope);
+		if (!isNumericScope)
+		{
+			return;
+		}
+
+		// IPv4 addresses are returned IPv4-mapped
+		const Q_IPV6ADDR ipv6 = _ipAddress.toIPv6Address();
+
+		auto* address = reinterpret_cast<sockaddr_in6*>(&_batchAddress);
+		address->sin6_family = AF_INET6;
+		address->sin6_port = htons(static_cast<uint16_t>(_port));
+		memcpy(&address->sin6_addr, &ipv6, sizeof(address->sin6_addr));
+		address->sin6_scope_id = scopeId;
+		_batchAddressLength = sizeof(sockaddr_in6);
+	}
+#endif
+}
+
 int ProviderUdp::close()
 {
 	_isDeviceReady = false;
@@ -79,12 +145,21 @@ int ProviderUdp::close()
 			// Everything is OK -> device is closed
 		}
 	}
+
+	if (_sendCalls > 0)
+	{
+		Debug(_log, "Sent %llu packets with %llu system calls", static_cast<unsigned long long>(_packetsSent), static_cast<unsigned long long>(_sendCalls));
+	}
+	_packetCount = 0;
+
 	return 0;
 }
  
 int ProviderUdp::writeBytes(const unsigned size, const uint8_t* data)
 {
 	int rc = 0;
+	++_packetsSent;
+	++_sendCalls;
 	qint64 bytesWritten = _udpSocket->writeDatagram(reinterpret_cast<const char*>(data), size, _ipAddress, static_cast<quint16>(_port));
 
 	if (bytesWritten == -1 || bytesWritten != size)
@@ -98,6 +173,8 @@ int ProviderUdp::writeBytes(const unsigned size, const uint8_t* data)
 int ProviderUdp::writeBytes(const QByteArray& bytes)
 {
 	int rc = 0;
+	++_packetsSent;
+	++_sendCalls;
 	qint64 bytesWritten = _udpSocket->writeDatagram(bytes,_ipAddress, static_cast<quint16>(_port));
 
 	if (bytesWritten == -1 || bytesWritten != bytes.size())
@@ -107,3 +184,104 @@ int ProviderUdp::writeBytes(const QByteArray& bytes)
 	}
 	return  rc;
 }
+
+void ProviderUdp::queueBytes(const unsigned size, const uint8_t* data)
+{
+	if (_packetCount == _packets.size())
+	{
+		_packets.append(QByteArray());
+	}
+
+	// Resizing keeps the capacity of the buffer
+	QByteArray& packet = _packets[_packetCount++];
+	packet.resize(static_cast<int>(size));
+	memcpy(packet.data(), data, size);
+}
+
+void ProviderUdp::queueBytes(const QByteArray& bytes)
+{
+	queueBytes(static_cast<unsigned>(bytes.size()), reinterpret_cast<const uint8_t*>(bytes.constData()));
+}
+
+int ProviderUdp::flushPackets()
+{
+	int rc = 0;
+	int sent = 0;
+
+#ifdef __linux__
+	if (_batchAddressLength > 0 && _packetCount > 1)
+	{
+		const int socket = static_cast<int>(_udpSocket->socketDescriptor());
+
+		if (_messages.size() < static_cast<size_t>(_packetCount))
+		{
+			_vectors.resize(static_cast<size_t>(_packetCount));
+			_messages.resize(static_cast<size_t>(_packetCount));
+		}
+
+		for (int i = 0; i < _packetCount; ++i)
+		{
+			_vectors[i].iov_base = _packets[i].data();
+			_vectors[i].iov_len = static_cast<size_t>(_packets[i].size());
+
+			msghdr& header = _messages[i].msg_hdr;
+			header = {};
+			header.msg_name = &_batchAddress;
+			header.msg_namelen = _batchAddressLength;
+			header.msg_iov = &_vectors[i];
+			header.msg_iovlen = 1;
+		}
+
+		// The kernel may send a part of the messages only, continue with the remaining ones
+		while (sent < _packetCount)
+		{
+			const int count = sendmmsg(socket, _messages.data() + sent, static_cast<unsigned int>(_packetCount - sent), 0);
+			++_sendCalls;
+			if (count <= 0)
+			{
+				if (count < 0 && errno == ENOSYS)
+				{
+					// Not provided by the kernel, send the packets one by one from now on
+					_batchAddressLength = 0;
+				}
+				else
+				{
+					Warning(_log, "%s", QSTRING_CSTR(QString("(%1:%2) Write Error: %3").arg(_ipAddress.toString()).arg(_port).arg(strerror(errno))));
+					rc = -1;
+				}
+				break;
+			}
+			sent += count;
+			_packetsSent += static_cast<quint64>(count);
+		}
+	}
+
+	if (rc == 0 && sent < _packetCount)
+	{
+		rc = writeQueued(sent);
+	}
+#else
+	rc = writeQueued(sent);
+#endif
+
+	qCDebug(leddevice_write) << QString("Flushed %1 packets, %2 packets with %3 system calls in total")
+								   .arg(_packetCount)
+								   .arg(_packetsSent)
+								   .arg(_sendCalls);
+
+	_packetCount = 0;
+	return rc;
+}
+
+int ProviderUdp::writeQueued(int first)
+{
+	int rc = 0;
+	for (int i = first; i < _packetCount; ++i)
+	{
+		if (writeBytes(_packets[i]) < 0)
+		{
+			rc = -1;
+		}
+	}
+	return rc;
+}
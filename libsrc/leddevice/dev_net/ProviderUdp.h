@@ -1,6 +1,9 @@
 #ifndef PROVIDERUDP_H
 #define PROVIDERUDP_H
 
+// STL includes
+#include <vector>
+
 // LedDevice includes
 #include <leddevice/LedDevice.h>
 
@@ -8,6 +11,14 @@
 #include <QHostAddress>
 #include <QUdpSocket>
 #include <QScopedPointer>
+#include <QVector>
+#include <QByteArray>
+
+// Linux includes
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
 
 // Hyperion includes
 #include <utils/Logger.h>
@@ -61,15 +72,69 @@ protected:
 	///
 	int writeBytes(const QByteArray& bytes);
 
+	///
+	/// @brief Queues the given bytes as one packet to be sent with the next flushPackets().
+	/// The packet is copied, i.e. the data may be reused for the next packet.
+	///
+	/// @param[in] size The length of the data
+	/// @param[in] data The data
+	///
+	void queueBytes(const unsigned size, const uint8_t* data);
+
+	///
+	/// @brief Queues the given bytes as one packet to be sent with the next flushPackets().
+	///
+	/// @param[in] data The data
+	///
+	void queueBytes(const QByteArray& bytes);
+
+	///
+	/// @brief Sends all queued packets to the UDP-device, with a single system call where supported (sendmmsg on Linux)
+	///
+	/// @return Zero on success, else negative
+	///
+	int flushPackets();
+
 	///
 	QString _hostName;
 	int _port;
 
 	QScopedPointer<QUdpSocket> _udpSocket;
 
-private:	
+private:
+
+	///
+	/// @brief Resolves the target address in the address family of the bound socket for sending packets in batches
+	///
+	void setupBatchAddress();
+
+	///
+	/// @brief Sends the queued packets one by one via the socket
+	///
+	/// @param[in] first The first packet to be sent
+	///
+	/// @return Zero on success, else negative
+	///
+	int writeQueued(int first);
 
 	QHostAddress _ipAddress;
+
+	/// Packets queued, the buffers are kept for the next frames
+	QVector<QByteArray> _packets;
+	int _packetCount;
+
+#ifdef __linux__
+	/// Target address for sendmmsg, length 0 if not available
+	sockaddr_storage _batchAddress;
+	socklen_t _batchAddressLength;
+	/// Message headers of the queued packets, kept for the next frames
+	std::vector<iovec> _vectors;
+	std::vector<mmsghdr> _messages;
+#endif
+
+	/// Packets sent and the system calls used to send them
+	quint64 _packetsSent;
+	quint64 _sendCalls;
 };
 
 #endif // PROVIDERUDP_H
@@ -104,7 +104,7 @@ int LedDeviceFile::write(const QVector<ColorRgb> & ledValues)
 	if ( _printTimeStamp )
 	{
 		QDateTime now = QDateTime::currentDateTime();
-		qint64 elapsedTimeMs = _lastWriteTime.msecsTo(now);
+		qint64 elapsedTimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _lastWriteTime).count();
 
 		#if (QT_VERSION >= QT_VERSION_CHECK(5, 8, 0))
 			out << now.toString(Qt::ISODateWithMs) << " | +" << QString("%1").arg( elapsedTimeMs,4);
@@ -13,6 +13,8 @@ LedDeviceDMX::LedDeviceDMX(const QJsonObject &deviceConfig)
 	, _dmxLedCount(0)
 	, _dmxChannelCount(0)
 {
+	// The break preceding a frame has to be followed by its data, i.e. frames are not kept pending
+	_isWriteBlocking = true;
 }
 
 LedDevice* LedDeviceDMX::construct(const QJsonObject &deviceConfig)
@@ -10,12 +10,14 @@
 #include <QDir>
 
 #include <chrono>
+#include <cstring>
 
 // Constants
 namespace {
 	constexpr std::chrono::milliseconds WRITE_TIMEOUT{ 1000 };	// device write timeout in ms
 	constexpr std::chrono::milliseconds OPEN_TIMEOUT{ 5000 };		// device open timeout in ms
 	const int MAX_WRITE_TIMEOUTS = 5;	// Maximum number of allowed timeouts
+	constexpr std::chrono::seconds WRITE_TIMEOUTS_PERIOD{ 60 };	// Period the maximum number of timeouts applies to
 	const int NUM_POWEROFF_WRITE_BLACK = 5;	// Number of write "BLACK" during powering off
 
 	constexpr std::chrono::milliseconds DEFAULT_IDENTIFY_TIME{ 500 };
@@ -29,9 +31,18 @@ ProviderRs232::ProviderRs232(const QJsonObject &deviceConfig)
 	: LedDevice(deviceConfig)
 	  , _rs232Port(this)
 	  ,_baudRate_Hz(1000000)
+	  ,_isWriteBlocking(false)
 	  ,_isAutoDeviceName(false)
 	  ,_delayAfterConnect_ms(0)
 	  ,_frameDropCounter(0)
+	  ,_bytesInFlight(0)
+	  ,_isFramePending(false)
+	  ,_framesWritten(0)
+	  ,_bytesWritten(0)
+	  ,_framesReplaced(0)
+	  ,_queueLatencySum(0)
+	  ,_queueLatencyMax(0)
+	  ,_framesQueued(0)
 {
 }
 
@@ -83,6 +94,16 @@ int ProviderRs232::open()
 
 	connect(&_rs232Port, &QSerialPort::readyRead, this, &ProviderRs232::readFeedback);
 
+	if (_writeTimeoutTimer.isNull())
+	{
+		_writeTimeoutTimer.reset(new QTimer());
+		_writeTimeoutTimer->setSingleShot(true);
+		_writeTimeoutTimer->setInterval(WRITE_TIMEOUT);
+		connect(_writeTimeoutTimer.data(), &QTimer::timeout, this, &ProviderRs232::onWriteTimeout);
+	}
+	resetWriter();
+	connect(&_rs232Port, &QSerialPort::bytesWritten, this, &ProviderRs232::onBytesWritten, Qt::UniqueConnection);
+
 	// Everything is OK, device is ready
 	_isDeviceReady = true;
 
@@ -99,12 +120,24 @@ int ProviderRs232::close()
 		return 0;
 	}
 
+	flushFrames();
+
 	if ( _rs232Port.flush() )
 	{
 		Debug(_log,"Flush was successful");
 	}
 
 	disconnect(&_rs232Port, &QSerialPort::readyRead, this, &ProviderRs232::readFeedback);
+	disconnect(&_rs232Port, &QSerialPort::bytesWritten, this, &ProviderRs232::onBytesWritten);
+
+	if (_framesWritten > 0)
+	{
+		const qint64 averageLatency = (_framesQueued > 0) ? static_cast<qint64>(_queueLatencySum.count() / static_cast<qint64>(_framesQueued)) : 0;
+		Debug(_log, "Frames written: %llu (%llu bytes), replaced by newer frames: %llu, queue latency avg/max: %lld/%lld us",
+			  static_cast<unsigned long long>(_framesWritten), static_cast<unsigned long long>(_bytesWritten), static_cast<unsigned long long>(_framesReplaced),
+			  static_cast<long long>(averageLatency), static_cast<long long>(_queueLatencyMax.count()));
+	}
+	resetWriter();
 
 	Debug(_log,"Close UART: %s", QSTRING_CSTR(_deviceName) );
 	_rs232Port.close();
@@ -200,6 +233,10 @@ bool ProviderRs232::tryOpen(int delayAfterConnect_ms)
 void ProviderRs232::setInError(const QString& errorMsg, bool isRecoverable)
 {
 	_rs232Port.clearError();
+
+	// Frames in flight or pending are not waited for
+	_bytesInFlight = 0;
+	_isFramePending = false;
 	this->close();
 
 	LedDevice::setInError( errorMsg, isRecoverable );
@@ -207,8 +244,6 @@ void ProviderRs232::setInError(const QString& errorMsg, bool isRecoverable)
 
 int ProviderRs232::writeBytes(const qint64 size, const uint8_t *data)
 {
-	int rc = 0;
-	
 	if (!_rs232Port.isOpen())
 	{
 		Debug(_log, "!_rs232Port.isOpen()");
@@ -219,6 +254,130 @@ int ProviderRs232::writeBytes(const qint64 size, const uint8_t *data)
 		}
 	}
 
+	if (_isWriteBlocking || _writeTimeoutTimer.isNull())
+	{
+		return writeBytesBlocking(size, data);
+	}
+
+	if (_bytesInFlight > 0)
+	{
+		// Latest wins, a frame still pending is replaced
+		if (_isFramePending)
+		{
+			++_framesReplaced;
+		}
+
+		// Resizing keeps the capacity of the buffer
+		_pendingFrame.resize(static_cast<int>(size));
+		memcpy(_pendingFrame.data(), data, static_cast<size_t>(size));
+		_isFramePending = true;
+		_pendingSince = std::chrono::steady_clock::now();
+		return 0;
+	}
+
+	return writeFrame(size, reinterpret_cast<const char*>(data));
+}
+
+int ProviderRs232::writeFrame(const qint64 size, const char *data)
+{
+	qint64 bytesWritten = _rs232Port.write(data, size);
+	if (bytesWritten == -1 || bytesWritten != size)
+	{
+		this->setInError( QString ("Rs232 SerialPortError: %1").arg(_rs232Port.errorString()) );
+		return -1;
+	}
+
+	_bytesInFlight = size;
+	_writeTimeoutTimer->start();
+
+	return 0;
+}
+
+void ProviderRs232::onBytesWritten(qint64 bytes)
+{
+	_bytesWritten += static_cast<quint64>(bytes);
+
+	// Nothing tracked, e.g. written blocking
+	if (_bytesInFlight <= 0)
+	{
+		return;
+	}
+
+	_bytesInFlight -= bytes;
+	if (_bytesInFlight > 0)
+	{
+		return;
+	}
+
+	_bytesInFlight = 0;
+	_writeTimeoutTimer->stop();
+	++_framesWritten;
+
+	if (_isFramePending)
+	{
+		_isFramePending = false;
+
+		const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _pendingSince);
+		_queueLatencySum += latency;
+		_queueLatencyMax = std::max(_queueLatencyMax, latency);
+		++_framesQueued;
+
+		writeFrame(_pendingFrame.size(), _pendingFrame.constData());
+	}
+}
+
+void ProviderRs232::onWriteTimeout()
+{
+	if (_bytesInFlight <= 0)
+	{
+		return;
+	}
+
+	if (_rs232Port.error() == QSerialPort::NoError || _rs232Port.error() == QSerialPort::TimeoutError)
+	{
+		Debug(_log, "Timeout after %dms: %d frames already dropped, Rs232 SerialPortError [%d]: %s", WRITE_TIMEOUT.count(), _frameDropCounter, _rs232Port.error(), QSTRING_CSTR(_rs232Port.errorString()));
+
+		if ( countWriteTimeout() )
+		{
+			handleWriteError( QString ("Timeout writing data to %1").arg(_deviceName) );
+			return;
+		}
+
+		//give it another try with the newest frame
+		_rs232Port.clearError();
+		_rs232Port.clear(QSerialPort::Output);
+		_bytesInFlight = 0;
+
+		if (_isFramePending)
+		{
+			_isFramePending = false;
+			writeFrame(_pendingFrame.size(), _pendingFrame.constData());
+		}
+	}
+	else
+	{
+		handleWriteError( QString ("Error writing data to %1, Error: %2").arg(_deviceName).arg(_rs232Port.error()) );
+	}
+}
+
+bool ProviderRs232::countWriteTimeout()
+{
+	// Check, if the number of timeouts within the period is greater than defined
+	const auto now = std::chrono::steady_clock::now();
+	if (_frameDropCounter == 0 || now - _frameDropPeriodStart > WRITE_TIMEOUTS_PERIOD)
+	{
+		_frameDropCounter = 0;
+		_frameDropPeriodStart = now;
+	}
+
+	++_frameDropCounter;
+	return _frameDropCounter > MAX_WRITE_TIMEOUTS;
+}
+
+int ProviderRs232::writeBytesBlocking(const qint64 size, const uint8_t *data)
+{
+	int rc = 0;
+
 	qint64 bytesWritten = _rs232Port.write(reinterpret_cast<const char*>(data), size);
 	if (bytesWritten == -1 || bytesWritten != size)
 	{
@@ -232,13 +391,9 @@ int ProviderRs232::writeBytes(const qint64 size, const uint8_t *data)
 		{
 			Debug(_log, "Timeout after %dms: %d frames already dropped, Rs232 SerialPortError [%d]: %s", WRITE_TIMEOUT.count(), _frameDropCounter, _rs232Port.error(), QSTRING_CSTR(_rs232Port.errorString()));
 
-			++_frameDropCounter;
-
-			// Check,if number of timeouts in a given time frame is greater than defined
-			// TODO: ProviderRs232::writeBytes - Add time frame to check for timeouts that devices does not close after absolute number of timeouts
-			if ( _frameDropCounter > MAX_WRITE_TIMEOUTS )
+			if ( countWriteTimeout() )
 			{
-				this->setInError( QString ("Timeout writing data to %1").arg(_deviceName) );
+				handleWriteError( QString ("Timeout writing data to %1").arg(_deviceName) );
 				rc = -1;
 			}
 			else
@@ -249,20 +404,65 @@ int ProviderRs232::writeBytes(const qint64 size, const uint8_t *data)
 		}
 		else
 		{
-			this->setInError( QString ("Error writing data to %1, Error: %2").arg(_deviceName).arg(_rs232Port.error()));
+			handleWriteError( QString ("Error writing data to %1, Error: %2").arg(_deviceName).arg(_rs232Port.error()));
 			rc = -1;
 		}
 	}
-
-	if (rc == -1)
+	else
 	{
-		Info(_log, "Try restarting the device %s after error occured...", QSTRING_CSTR(_activeDeviceType));
-		emit enable();
+		++_framesWritten;
 	}
 
 	return rc;
 }
 
+void ProviderRs232::handleWriteError(const QString& errorMsg)
+{
+	this->setInError( errorMsg );
+
+	Info(_log, "Try restarting the device %s after error occured...", QSTRING_CSTR(_activeDeviceType));
+	emit enable();
+}
+
+void ProviderRs232::flushFrames()
+{
+	if (_isFramePending && _rs232Port.isOpen())
+	{
+		// Wait for the frame in flight, the pending frame follows
+		if (_bytesInFlight > 0)
+		{
+			_rs232Port.waitForBytesWritten(WRITE_TIMEOUT.count());
+		}
+		if (_isFramePending && _bytesInFlight <= 0)
+		{
+			_isFramePending = false;
+			writeFrame(_pendingFrame.size(), _pendingFrame.constData());
+		}
+	}
+
+	if (_bytesInFlight > 0 && _rs232Port.isOpen())
+	{
+		_rs232Port.waitForBytesWritten(WRITE_TIMEOUT.count());
+	}
+}
+
+void ProviderRs232::resetWriter()
+{
+	if (!_writeTimeoutTimer.isNull())
+	{
+		_writeTimeoutTimer->stop();
+	}
+
+	_bytesInFlight = 0;
+	_isFramePending = false;
+	_framesWritten = 0;
+	_bytesWritten = 0;
+	_framesReplaced = 0;
+	_queueLatencySum = std::chrono::microseconds::zero();
+	_queueLatencyMax = std::chrono::microseconds::zero();
+	_framesQueued = 0;
+}
+
 void ProviderRs232::readFeedback()
 {
 	QByteArray readData = _rs232Port.readAll();
@@ -4,8 +4,12 @@
 // LedDevice includes
 #include <leddevice/LedDevice.h>
 
+// STL includes
+#include <chrono>
+
 // qt includes
 #include <QSerialPort>
+#include <QByteArray>
 
 ///
 /// The ProviderRs232 implements an abstract base-class for LedDevices using a RS232-device.
@@ -94,6 +98,10 @@ protected:
 	///
 	/// @brief Write the given bytes to the RS232-device
 	///
+	/// The write does not wait for the transmission. At most one frame is handed to the serial port at a time,
+	/// a frame written while another one is still transmitted is kept pending and replaced by any newer frame
+	/// (latest wins). The pending frame is written as soon as the transmission of the previous one finished.
+	///
 	/// @param[in[ size The length of the data
 	/// @param[in] data The data
 	/// @return Zero on success, else negative
@@ -108,6 +116,8 @@ protected:
 	QSerialPort _rs232Port;
 	/// The used baud-rate of the output device
 	qint32 _baudRate_Hz;
+	/// Wait for the transmission of every frame, i.e. no frame is kept pending (e.g. for a break signalled ahead of each frame)
+	bool _isWriteBlocking;
 
 protected slots:
 
@@ -124,8 +134,64 @@ protected slots:
 	///
 	virtual void readFeedback();
 
+private slots:
+
+	///
+	/// @brief Track the transmission of the frame in flight and write the pending frame once it is transmitted
+	///
+	/// @param[in] bytes The number of bytes written to the device
+	///
+	void onBytesWritten(qint64 bytes);
+
+	///
+	/// @brief Handle a frame not being transmitted in time
+	///
+	void onWriteTimeout();
+
 private:
 
+	///
+	/// @brief Hand a frame to the serial port and track it as being in flight
+	///
+	/// @param[in] size The length of the data
+	/// @param[in] data The data
+	/// @return Zero on success, else negative
+	///
+	int writeFrame(const qint64 size, const char *data);
+
+	///
+	/// @brief Write the given bytes to the RS232-device and wait for the transmission
+	///
+	/// @param[in] size The length of the data
+	/// @param[in] data The data
+	/// @return Zero on success, else negative
+	///
+	int writeBytesBlocking(const qint64 size, const uint8_t *data);
+
+	///
+	/// @brief Handle a failed write, i.e. try restarting the device
+	///
+	/// @param[in] errorMsg The error message to be logged
+	///
+	void handleWriteError(const QString& errorMsg);
+
+	///
+	/// @brief Count a frame dropped, as its write timed out
+	///
+	/// @return True, if more timeouts than allowed occurred within the period
+	///
+	bool countWriteTimeout();
+
+	///
+	/// @brief Write a pending frame and wait for all frames to be transmitted (e.g. for the final "Black" before closing)
+	///
+	void flushFrames();
+
+	///
+	/// @brief Reset the writer's state and counters
+	///
+	void resetWriter();
+
 	///
 	/// @brief Try to open device if not opened
 	///
@@ -139,8 +205,28 @@ private:
 	/// Sleep after the connect before continuing
 	int _delayAfterConnect_ms;
 
-	/// Frames dropped, as write failed
+	/// Frames dropped, as write failed, since the start of the period
 	int _frameDropCounter;
+	std::chrono::steady_clock::time_point _frameDropPeriodStart;
+
+	/// Bytes of the frame in flight not yet transmitted
+	qint64 _bytesInFlight;
+	/// The newest frame written while another one was in flight
+	QByteArray _pendingFrame;
+	bool _isFramePending;
+	/// Time, the pending frame was written
+	std::chrono::steady_clock::time_point _pendingSince;
+	/// Detects frames not transmitted in time
+	QScopedPointer<QTimer> _writeTimeoutTimer;
+
+	/// Frames and bytes transmitted, frames replaced by newer ones before being transmitted
+	quint64 _framesWritten;
+	quint64 _bytesWritten;
+	quint64 _framesReplaced;
+	/// Time pending frames waited to be handed to the serial port
+	std::chrono::microseconds _queueLatencySum;
+	std::chrono::microseconds _queueLatencyMax;
+	quint64 _framesQueued;
 };
 
 #endif // PROVIDERRS232_H
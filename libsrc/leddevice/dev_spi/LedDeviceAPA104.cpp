@@ -38,12 +38,6 @@ LedDeviceAPA104::LedDeviceAPA104(const QJsonObject &deviceConfig)
 	: ProviderSpi(deviceConfig)
 	, SPI_BYTES_PER_COLOUR(4)
 	, SPI_FRAME_END_LATCH_BYTES(8)
-	, bitpair_to_byte {
-		0b10001000,
-		0b10001110,
-		0b11101000,
-		0b11101110,
-	}
 {
 }
 
@@ -72,28 +66,14 @@ bool LedDeviceAPA104::init(const QJsonObject &deviceConfig)
 
 int LedDeviceAPA104::write(const QVector<ColorRgb> &ledValues)
 {
-	unsigned spi_ptr = 0;
-	const int SPI_BYTES_PER_LED = sizeof(ColorRgb) * SPI_BYTES_PER_COLOUR;
+	uint8_t* spi_ptr = _ledBuffer.data();
 
 	for (const ColorRgb& color : ledValues)
 	{
-		uint32_t colorBits = ((unsigned int)color.red << 16)
-			| ((unsigned int)color.green << 8)
-			| color.blue;
-
-		for (int j=SPI_BYTES_PER_LED - 1; j>=0; j--)
-		{
-			_ledBuffer[spi_ptr+j] = bitpair_to_byte[ colorBits & 0x3 ];
-			colorBits >>= 2;
-		}
-		spi_ptr += SPI_BYTES_PER_LED;
+		spi_ptr = SpiBitEncoderSk6822::encode(color, spi_ptr);
 	}
 
-	for (int j=0; j < SPI_FRAME_END_LATCH_BYTES; j++)
-	{
-		_ledBuffer[spi_ptr] = 0;
-		spi_ptr++;
-	}
+	memset(spi_ptr, 0, SPI_FRAME_END_LATCH_BYTES);
 
 	return writeBytes(_ledBuffer.size(), _ledBuffer.data());
 }
@@ -3,6 +3,7 @@
 
 // hyperion includes
 #include "ProviderSpi.h"
+#include "SpiBitEncoder.h"
 
 ///
 /// Implementation of the LedDevice interface for writing to APA104 led device via spi.
@@ -45,8 +46,6 @@ private:
 
 	const int SPI_BYTES_PER_COLOUR;
 	const int SPI_FRAME_END_LATCH_BYTES;
-
-	uint8_t bitpair_to_byte[4];
 };
 
 #endif // LEDEVICEAPA104_H
@@ -4,12 +4,6 @@ LedDeviceSk6812SPI::LedDeviceSk6812SPI(const QJsonObject &deviceConfig)
 	: ProviderSpi(deviceConfig)
 	  , _whiteAlgorithm(RGBW::WhiteAlgorithm::INVALID)
 	  , SPI_BYTES_PER_COLOUR(4)
-	  , bitpair_to_byte {
-		  0b10001000,
-		  0b10001100,
-		  0b11001000,
-		  0b11001100,
-		  }
 {
 }
 
@@ -50,32 +44,15 @@ bool LedDeviceSk6812SPI::init(const QJsonObject &deviceConfig)
 
 int LedDeviceSk6812SPI::write(const QVector<ColorRgb> &ledValues)
 {
-	unsigned spi_ptr = 0;
-	const int SPI_BYTES_PER_LED = sizeof(ColorRgbw) * SPI_BYTES_PER_COLOUR;
+	uint8_t* spi_ptr = _ledBuffer.data();
 
 	for (const ColorRgb& color : ledValues)
 	{
 		RGBW::Rgb_to_Rgbw(color, &_temp_rgbw, _whiteAlgorithm);
-		uint32_t colorBits = 
-			((uint32_t)_temp_rgbw.red << 24) +
-			((uint32_t)_temp_rgbw.green << 16) +
-			((uint32_t)_temp_rgbw.blue << 8) +
-			_temp_rgbw.white;
-
-		for (int j=SPI_BYTES_PER_LED - 1; j>=0; j--)
-		{
-			_ledBuffer[spi_ptr+j] = bitpair_to_byte[ colorBits & 0x3 ];
-			colorBits >>= 2;
-		}
-		spi_ptr += SPI_BYTES_PER_LED;
+		spi_ptr = SpiBitEncoderWs2812::encode(_temp_rgbw, spi_ptr);
 	}
 
-	_ledBuffer[spi_ptr] = 0;
-	++spi_ptr;
-	_ledBuffer[spi_ptr] = 0;
-	++spi_ptr;
-	_ledBuffer[spi_ptr] = 0;
-	++spi_ptr;
+	memset(spi_ptr, 0, 3);
 
 	return writeBytes(_ledBuffer.size(), _ledBuffer.data());
 }
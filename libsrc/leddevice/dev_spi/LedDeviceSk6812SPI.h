@@ -3,6 +3,7 @@
 
 // hyperion includes
 #include "ProviderSpi.h"
+#include "SpiBitEncoder.h"
 
 ///
 /// Implementation of the LedDevice interface for writing to Sk6801 LED-device via SPI.
@@ -46,7 +47,6 @@ private:
 	RGBW::WhiteAlgorithm _whiteAlgorithm;
 
 	const int SPI_BYTES_PER_COLOUR;
-	uint8_t bitpair_to_byte[4];
 
 	ColorRgbw _temp_rgbw;
 };
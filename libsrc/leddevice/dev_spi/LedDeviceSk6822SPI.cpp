@@ -41,12 +41,6 @@ LedDeviceSk6822SPI::LedDeviceSk6822SPI(const QJsonObject &deviceConfig)
 	  , SPI_BYTES_PER_COLOUR(4)
 	  , SPI_BYTES_WAIT_TIME(3)
 	  , SPI_FRAME_END_LATCH_BYTES(13)
-	  , bitpair_to_byte {
-		  0b10001000,
-		  0b10001110,
-		  0b11101000,
-		  0b11101110,
-		  }
 {
 }
 
@@ -74,21 +68,11 @@ bool LedDeviceSk6822SPI::init(const QJsonObject &deviceConfig)
 
 int LedDeviceSk6822SPI::write(const QVector<ColorRgb> &ledValues)
 {
-	unsigned spi_ptr = 0;
-	const int SPI_BYTES_PER_LED = sizeof(ColorRgb) * SPI_BYTES_PER_COLOUR;
+	uint8_t* spi_ptr = _ledBuffer.data();
 
 	for (const ColorRgb& color : ledValues)
 	{
-		uint32_t colorBits = ((unsigned int)color.red << 16)
-							 | ((unsigned int)color.green << 8)
-							 | color.blue;
-
-		for (int j=SPI_BYTES_PER_LED - 1; j>=0; j--)
-		{
-			_ledBuffer[spi_ptr+j] = bitpair_to_byte[ colorBits & 0x3 ];
-			colorBits >>= 2;
-		}
-		spi_ptr += SPI_BYTES_PER_LED;
+		spi_ptr = SpiBitEncoderSk6822::encode(color, spi_ptr);
 		spi_ptr += SPI_BYTES_WAIT_TIME;	// the wait between led time is all zeros
 	}
 
@@ -3,6 +3,7 @@
 
 // hyperion includes
 #include "ProviderSpi.h"
+#include "SpiBitEncoder.h"
 
 ///
 /// Implementation of the LedDevice interface for writing to Sk6822 LED-device via SPI.
@@ -46,8 +47,6 @@ private:
 	const int SPI_BYTES_PER_COLOUR;
 	const int SPI_BYTES_WAIT_TIME;
 	const int SPI_FRAME_END_LATCH_BYTES;
-
-	uint8_t bitpair_to_byte[4];
 };
 
 #endif // LEDEVICESK6822SPI_H
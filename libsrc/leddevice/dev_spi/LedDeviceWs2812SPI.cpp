@@ -38,12 +38,6 @@ LedDeviceWs2812SPI::LedDeviceWs2812SPI(const QJsonObject &deviceConfig)
 	: ProviderSpi(deviceConfig)
 	  , SPI_BYTES_PER_COLOUR(4)
 	  , SPI_FRAME_END_LATCH_BYTES(116)
-	  , bitpair_to_byte {
-		  0b10001000,
-		  0b10001100,
-		  0b11001000,
-		  0b11001100,
-		  }
 {
 }
 
@@ -71,28 +65,14 @@ bool LedDeviceWs2812SPI::init(const QJsonObject &deviceConfig)
 
 int LedDeviceWs2812SPI::write(const QVector<ColorRgb> &ledValues)
 {
-	unsigned spi_ptr = 0;
-	const int SPI_BYTES_PER_LED = sizeof(ColorRgb) * SPI_BYTES_PER_COLOUR;
+	uint8_t* spi_ptr = _ledBuffer.data();
 
 	for (const ColorRgb& color : ledValues)
 	{
-		uint32_t colorBits = ((unsigned int)color.red << 16)
-							 | ((unsigned int)color.green << 8)
-							 | color.blue;
-
-		for (int j=SPI_BYTES_PER_LED - 1; j>=0; j--)
-		{
-			_ledBuffer[spi_ptr+j] = bitpair_to_byte[ colorBits & 0x3 ];
-			colorBits >>= 2;
-		}
-		spi_ptr += SPI_BYTES_PER_LED;
+		spi_ptr = SpiBitEncoderWs2812::encode(color, spi_ptr);
 	}
 
-	for (int j=0; j < SPI_FRAME_END_LATCH_BYTES; j++)
-	{
-		_ledBuffer[spi_ptr] = 0;
-		++spi_ptr;
-	}
+	memset(spi_ptr, 0, SPI_FRAME_END_LATCH_BYTES);
 
 	return writeBytes(_ledBuffer.size(), _ledBuffer.data());
 }
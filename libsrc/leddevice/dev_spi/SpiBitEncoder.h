@@ -0,0 +1,94 @@
+#ifndef SPIBITENCODER_H
+#define SPIBITENCODER_H
+
+// STL includes
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+// Utility includes
+#include <utils/ColorRgb.h>
+#include <utils/ColorRgbw.h>
+
+///
+/// Encoder of color values into the SPI bit patterns of single-wire LEDs (e.g. WS2812, SK6812, SK6822, APA104).
+///
+/// Every data bit is sent as four SPI bits, i.e. a pair of data bits as one SPI byte and a color channel as four SPI bytes,
+/// most significant bit first. The SPI bytes of all 256 channel values are resolved at compile time.
+///
+/// @tparam ZERO_ZERO  SPI byte of the data bits 00
+/// @tparam ZERO_ONE   SPI byte of the data bits 01
+/// @tparam ONE_ZERO   SPI byte of the data bits 10
+/// @tparam ONE_ONE    SPI byte of the data bits 11
+///
+template <uint8_t ZERO_ZERO, uint8_t ZERO_ONE, uint8_t ONE_ZERO, uint8_t ONE_ONE>
+class SpiBitEncoder
+{
+public:
+	/// SPI bytes per color channel
+	static constexpr int BYTES_PER_COLOUR = 4;
+
+	///
+	/// @brief Encodes the channels of a LED in the order red, green, blue
+	///
+	/// @param[in] color The color of the LED
+	/// @param[out] spi Buffer of at least 3 * BYTES_PER_COLOUR bytes
+	/// @return The position following the LED's bytes
+	///
+	static uint8_t* encode(const ColorRgb& color, uint8_t* spi)
+	{
+		// Assembled in registers, stored at once
+		uint8_t led[3 * BYTES_PER_COLOUR];
+		memcpy(led, PATTERNS[color.red].data(), BYTES_PER_COLOUR);
+		memcpy(led + BYTES_PER_COLOUR, PATTERNS[color.green].data(), BYTES_PER_COLOUR);
+		memcpy(led + 2 * BYTES_PER_COLOUR, PATTERNS[color.blue].data(), BYTES_PER_COLOUR);
+		memcpy(spi, led, sizeof(led));
+		return spi + sizeof(led);
+	}
+
+	///
+	/// @brief Encodes the channels of a LED in the order red, green, blue, white
+	///
+	/// @param[in] color The color of the LED
+	/// @param[out] spi Buffer of at least 4 * BYTES_PER_COLOUR bytes
+	/// @return The position following the LED's bytes
+	///
+	static uint8_t* encode(const ColorRgbw& color, uint8_t* spi)
+	{
+		uint8_t led[4 * BYTES_PER_COLOUR];
+		memcpy(led, PATTERNS[color.red].data(), BYTES_PER_COLOUR);
+		memcpy(led + BYTES_PER_COLOUR, PATTERNS[color.green].data(), BYTES_PER_COLOUR);
+		memcpy(led + 2 * BYTES_PER_COLOUR, PATTERNS[color.blue].data(), BYTES_PER_COLOUR);
+		memcpy(led + 3 * BYTES_PER_COLOUR, PATTERNS[color.white].data(), BYTES_PER_COLOUR);
+		memcpy(spi, led, sizeof(led));
+		return spi + sizeof(led);
+	}
+
+private:
+	using Pattern = std::array<uint8_t, BYTES_PER_COLOUR>;
+
+	static constexpr std::array<Pattern, 256> createPatterns()
+	{
+		constexpr uint8_t BITPAIR_TO_BYTE[4] = { ZERO_ZERO, ZERO_ONE, ONE_ZERO, ONE_ONE };
+
+		std::array<Pattern, 256> patterns {};
+		for (int value = 0; value < 256; ++value)
+		{
+			for (int i = 0; i < BYTES_PER_COLOUR; ++i)
+			{
+				patterns[value][i] = BITPAIR_TO_BYTE[(value >> (6 - 2 * i)) & 0x3];
+			}
+		}
+		return patterns;
+	}
+
+	static constexpr std::array<Pattern, 256> PATTERNS = createPatterns();
+};
+
+/// WS2812 and SK6812: 0 is sent as 1000, 1 as 1100
+using SpiBitEncoderWs2812 = SpiBitEncoder<0b10001000, 0b10001100, 0b11001000, 0b11001100>;
+
+/// SK6822 and APA104: 0 is sent as 1000, 1 as 1110
+using SpiBitEncoderSk6822 = SpiBitEncoder<0b10001000, 0b10001110, 0b11101000, 0b11101110>;
+
+#endif // SPIBITENCODER_H
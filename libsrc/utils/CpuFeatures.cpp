@@ -0,0 +1,76 @@
+#include <utils/CpuFeatures.h>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace CpuFeatures {
+
+namespace {
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+bool detectAvx2()
+{
+	int info[4] {};
+	__cpuid(info, 0);
+	if (info[0] < 7)
+	{
+		return false;
+	}
+
+	// AVX requires OSXSAVE and the OS to save the YMM registers
+	__cpuid(info, 1);
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	const bool avx = (info[2] & (1 << 28)) != 0;
+	if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+	{
+		return false;
+	}
+
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+}
+#endif
+
+} // namespace
+
+bool hasSse2()
+{
+#if defined(__x86_64__) || defined(_M_X64)
+	return true;
+#elif defined(__i386__) && (defined(__GNUC__) || defined(__clang__))
+	static const bool sse2 = __builtin_cpu_supports("sse2");
+	return sse2;
+#elif defined(_M_IX86)
+	int info[4] {};
+	__cpuid(info, 1);
+	return (info[3] & (1 << 26)) != 0;
+#else
+	return false;
+#endif
+}
+
+bool hasAvx2()
+{
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+	static const bool avx2 = __builtin_cpu_supports("avx2");
+	return avx2;
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	static const bool avx2 = detectAvx2();
+	return avx2;
+#else
+	return false;
+#endif
+}
+
+bool hasNeon()
+{
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+	return true;
+#else
+	return false;
+#endif
+}
+
+} // namespace CpuFeatures
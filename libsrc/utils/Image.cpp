@@ -219,6 +219,25 @@ quint64 Image<Pixel_T>::id() const
 	return _instanceId;
 }
 
+template <typename Pixel_T>
+quint64 Image<Pixel_T>::dataId() const
+{
+	const ImageData<pixel_type>* d_ptr = _d_ptr.constData();
+	return (d_ptr != nullptr) ? d_ptr->_instanceId : 0;
+}
+
+template <typename Pixel_T>
+quint64 Image<Pixel_T>::fingerprint() const
+{
+	return _d_ptr->fingerprint();
+}
+
+template <typename Pixel_T>
+void Image<Pixel_T>::updateFingerprint()
+{
+	_d_ptr->updateFingerprint();
+}
+
 template <typename Pixel_T>
 QImage Image<Pixel_T>::toQImage() const
 {
@@ -0,0 +1,42 @@
+#include <utils/ImageAnalysisCache.h>
+
+#include <QMutexLocker>
+
+// STL includes
+#include <algorithm>
+#include <iterator>
+
+ImageAnalysisCache& ImageAnalysisCache::getInstance()
+{
+	static ImageAnalysisCache cache;
+	return cache;
+}
+
+std::shared_future<ImageAnalysisCache::Result> ImageAnalysisCache::acquire(const Image<ColorRgb>& image, const QByteArray& key, std::shared_ptr<std::promise<Result>>& promise)
+{
+	const quint64 dataId = image.dataId();
+
+	QMutexLocker locker(&_mutex);
+
+	auto entry = std::find_if(_entries.begin(), _entries.end(), [dataId](const Entry& cached) { return cached.dataId == dataId; });
+	if (entry == _entries.end())
+	{
+		if (_entries.size() >= MAX_FRAMES)
+		{
+			_entries.pop_front();
+		}
+		_entries.push_back({ dataId, image, {} });
+		entry = std::prev(_entries.end());
+	}
+
+	const auto result = entry->results.constFind(key);
+	if (result != entry->results.constEnd())
+	{
+		return result.value();
+	}
+
+	promise = std::make_shared<std::promise<Result>>();
+	std::shared_future<Result> future = promise->get_future().share();
+	entry->results.insert(key, future);
+	return future;
+}
@@ -1,4 +1,5 @@
 #include <utils/ImageData.h>
+#include <utils/ImageDataPool.h>
 
 #include <utils/ColorBgr.h>
 #include <utils/ColorRgb.h>
@@ -15,13 +16,91 @@ Q_LOGGING_CATEGORY(image_track, "hyperion.image.track");
 // The static instance counter needs to be defined in a .cpp file.
 QAtomicInteger<quint64> ImageDataCounter::_imageData_instance_counter(0);
 
+namespace {
+
+constexpr quint64 PRIME_1 = 0x9E3779B185EBCA87ULL;
+constexpr quint64 PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr quint64 PRIME_3 = 0x165667B19E3779F9ULL;
+
+inline quint64 rotateLeft(quint64 value, int bits)
+{
+	return (value << bits) | (value >> (64 - bits));
+}
+
+inline quint64 readWord(const uint8_t* data)
+{
+	quint64 word;
+	std::memcpy(&word, data, sizeof(word));
+	return word;
+}
+
+inline quint64 mixRound(quint64 lane, quint64 word)
+{
+	return rotateLeft(lane + word * PRIME_2, 31) * PRIME_1;
+}
+
+///
+/// 64-bit hash following the structure of xxHash64: four independent lanes over 32 byte blocks, followed by the tail
+/// and a final avalanche. Not suitable against malicious input, but fast enough to hash every captured frame.
+///
+quint64 hashBytes(const uint8_t* data, size_t size, quint64 seed)
+{
+	size_t offset = 0;
+	quint64 hash;
+
+	if (size >= 32)
+	{
+		quint64 lane1 = seed + PRIME_1 + PRIME_2;
+		quint64 lane2 = seed + PRIME_2;
+		quint64 lane3 = seed;
+		quint64 lane4 = seed - PRIME_1;
+
+		for (; offset + 32 <= size; offset += 32)
+		{
+			lane1 = mixRound(lane1, readWord(data + offset));
+			lane2 = mixRound(lane2, readWord(data + offset + 8));
+			lane3 = mixRound(lane3, readWord(data + offset + 16));
+			lane4 = mixRound(lane4, readWord(data + offset + 24));
+		}
+
+		hash = rotateLeft(lane1, 1) + rotateLeft(lane2, 7) + rotateLeft(lane3, 12) + rotateLeft(lane4, 18);
+	}
+	else
+	{
+		hash = seed + PRIME_3;
+	}
+
+	hash += size;
+
+	for (; offset + 8 <= size; offset += 8)
+	{
+		hash = rotateLeft(hash ^ mixRound(0, readWord(data + offset)), 27) * PRIME_1 + PRIME_3;
+	}
+	for (; offset < size; ++offset)
+	{
+		hash = rotateLeft(hash ^ (data[offset] * PRIME_3), 11) * PRIME_1;
+	}
+
+	hash ^= hash >> 33;
+	hash *= PRIME_2;
+	hash ^= hash >> 29;
+	hash *= PRIME_3;
+	hash ^= hash >> 32;
+
+	return hash;
+}
+
+} // namespace
+
 template <typename Pixel_T>
 ImageData<Pixel_T>::ImageData(int width, int height, const pixel_type background) :
 	_width(width),
 	_height(height),
-	_pixels(static_cast<size_t>(width) * static_cast<size_t>(height), background),
+	_pixels(ImageDataPool<Pixel_T>::getInstance().acquire(width, height)),
+	_fingerprint(0),
 	_instanceId(++_imageData_instance_counter)
 {
+	std::fill(_pixels.begin(), _pixels.end(), background);
 	qCDebug(image_create).noquote() << QString("|ImageData| CREATE: Creating new ImageData [%1] of size %2x%3").arg(_instanceId).arg(width).arg(height);
 }
 
@@ -29,9 +108,11 @@ template <typename Pixel_T>
 ImageData<Pixel_T>::ImageData(const ImageData& other) :
 	_width(other._width),
 	_height(other._height),
-	_pixels(other._pixels),
+	_pixels(ImageDataPool<Pixel_T>::getInstance().acquire(other._width, other._height)),
+	_fingerprint(other._fingerprint),
 	_instanceId(++_imageData_instance_counter)
 {
+	std::copy(other._pixels.begin(), other._pixels.end(), _pixels.begin());
 	qCDebug(image_copy).noquote() << QString("|ImageData| COPY (DEEP): New ImageData [%1] created as a deep copy of [%2].").arg(_instanceId).arg(other._instanceId);
 }
 
@@ -39,6 +120,9 @@ template <typename Pixel_T>
 ImageData<Pixel_T>::~ImageData()
 {
 	qCDebug(image_destroy).noquote() << QString("|ImageData| DESTROY: Destroying ImageData [%1]").arg(_instanceId);
+
+	// The last handle is gone, the pixels are recycled for the next image of the same size
+	ImageDataPool<Pixel_T>::getInstance().release(_width, _height, std::move(_pixels));
 }
 
 template <typename Pixel_T>
@@ -55,6 +139,7 @@ void ImageData<Pixel_T>::swap(ImageData& src) noexcept
 	swap(this->_width, src._width);
 	swap(this->_height, src._height);
 	swap(this->_pixels, src._pixels);
+	swap(this->_fingerprint, src._fingerprint);
 	swap(this->_instanceId, src._instanceId);
 }
 
@@ -63,10 +148,12 @@ ImageData<Pixel_T>::ImageData(ImageData&& src) noexcept
 : _width(src._width)
 , _height(src._height)
 , _pixels(std::move(src._pixels))
+, _fingerprint(src._fingerprint)
 , _instanceId(src._instanceId)
 {
 	src._width = 0;
 	src._height = 0;
+	src._fingerprint = 0;
 	src._instanceId = 0;
 }
 
@@ -112,6 +199,7 @@ const typename ImageData<Pixel_T>::pixel_type& ImageData<Pixel_T>::operator()(in
 template <typename Pixel_T>
 typename ImageData<Pixel_T>::pixel_type& ImageData<Pixel_T>::operator()(int x, int y)
 {
+	_fingerprint = 0;
 	return _pixels[y * _width + x];
 }
 
@@ -123,7 +211,11 @@ void ImageData<Pixel_T>::resize(int width, int height)
 		return;
 	}
 
-	_pixels.resize(static_cast<size_t>(width) * static_cast<size_t>(height));
+	// The pixels of the previous size are recycled, the pixels of the new size are taken from the pool
+	ImageDataPool<Pixel_T>& pool = ImageDataPool<Pixel_T>::getInstance();
+	pool.release(_width, _height, std::move(_pixels));
+	_pixels = pool.acquire(width, height);
+	_fingerprint = 0;
 
 	_width = width;
 	_height = height;
@@ -132,6 +224,8 @@ void ImageData<Pixel_T>::resize(int width, int height)
 template <typename Pixel_T>
 typename ImageData<Pixel_T>::pixel_type* ImageData<Pixel_T>::memptr()
 {
+	// The caller may modify the pixels
+	_fingerprint = 0;
 	return _pixels.data();
 }
 
@@ -175,6 +269,7 @@ void ImageData<Pixel_T>::clear(const pixel_type background)
 {
 	// Fill the entire existing pixel buffer with the default-constructed pixel value
 	std::fill(_pixels.begin(), _pixels.end(), background);
+	_fingerprint = 0;
 }
 
 template <typename Pixel_T>
@@ -183,6 +278,28 @@ void ImageData<Pixel_T>::reset()
 	resize(0, 0);
 }
 
+template <typename Pixel_T>
+quint64 ImageData<Pixel_T>::fingerprint() const
+{
+	if (_fingerprint != 0)
+	{
+		return _fingerprint;
+	}
+
+	const quint64 seed = (static_cast<quint64>(static_cast<quint32>(_width)) << 32) | static_cast<quint32>(_height);
+	const quint64 hash = hashBytes(reinterpret_cast<const uint8_t*>(_pixels.data()), static_cast<size_t>(size()), seed);
+
+	// 0 marks a fingerprint not computed
+	return (hash != 0) ? hash : 1;
+}
+
+template <typename Pixel_T>
+void ImageData<Pixel_T>::updateFingerprint()
+{
+	_fingerprint = 0;
+	_fingerprint = fingerprint();
+}
+
 template <typename Pixel_T>
 int ImageData<Pixel_T>::toIndex(int x, int y) const
 {
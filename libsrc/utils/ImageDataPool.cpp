@@ -0,0 +1,136 @@
+#include <utils/ImageDataPool.h>
+
+#include <QMutexLocker>
+
+#include <utils/ColorBgr.h>
+#include <utils/ColorRgb.h>
+#include <utils/ColorRgba.h>
+
+std::atomic<quint64> ImageDataPoolStatistics::_hits {0};
+std::atomic<quint64> ImageDataPoolStatistics::_misses {0};
+std::atomic<qint64> ImageDataPoolStatistics::_buffersHeld {0};
+std::atomic<qint64> ImageDataPoolStatistics::_bytesHeld {0};
+
+QJsonObject ImageDataPoolStatistics::get()
+{
+	QJsonObject statistics;
+	statistics["hits"] = static_cast<double>(_hits.load());
+	statistics["misses"] = static_cast<double>(_misses.load());
+	statistics["buffers"] = static_cast<double>(_buffersHeld.load());
+	statistics["bytes"] = static_cast<double>(_bytesHeld.load());
+	return statistics;
+}
+
+template <typename Pixel_T>
+ImageDataPool<Pixel_T>& ImageDataPool<Pixel_T>::getInstance()
+{
+	// Never destroyed, images may be released during static destruction
+	static ImageDataPool* const instance = new ImageDataPool();
+	return *instance;
+}
+
+template <typename Pixel_T>
+quint64 ImageDataPool<Pixel_T>::key(int width, int height)
+{
+	return (static_cast<quint64>(static_cast<quint32>(width)) << 32) | static_cast<quint32>(height);
+}
+
+template <typename Pixel_T>
+qint64 ImageDataPool<Pixel_T>::bytes(const std::vector<Pixel_T>& pixels)
+{
+	return static_cast<qint64>(pixels.capacity() * sizeof(Pixel_T));
+}
+
+template <typename Pixel_T>
+std::vector<Pixel_T> ImageDataPool<Pixel_T>::acquire(int width, int height)
+{
+	const size_t size = static_cast<size_t>(width) * static_cast<size_t>(height);
+	if (size == 0)
+	{
+		return {};
+	}
+
+	{
+		QMutexLocker locker(&_mutex);
+		auto it = _buffers.find(key(width, height));
+		if (it != _buffers.end() && !it->empty())
+		{
+			std::vector<Pixel_T> pixels = std::move(it->back());
+			it->pop_back();
+
+			const qint64 pixelBytes = bytes(pixels);
+			_bytes -= pixelBytes;
+			--_buffersHeld;
+			_bytesHeld -= pixelBytes;
+			++_hits;
+			return pixels;
+		}
+	}
+
+	++_misses;
+	return std::vector<Pixel_T>(size);
+}
+
+template <typename Pixel_T>
+void ImageDataPool<Pixel_T>::release(int width, int height, std::vector<Pixel_T>&& pixels)
+{
+	if (pixels.empty() || pixels.size() != static_cast<size_t>(width) * static_cast<size_t>(height))
+	{
+		return;
+	}
+
+	const qint64 pixelBytes = bytes(pixels);
+	if (pixelBytes > MAX_BYTES)
+	{
+		return;
+	}
+
+	// Freed outside the lock
+	std::vector<std::vector<Pixel_T>> evicted;
+	{
+		QMutexLocker locker(&_mutex);
+		const quint64 pixelKey = key(width, height);
+
+		const auto current = _buffers.constFind(pixelKey);
+		if (current != _buffers.cend() && static_cast<int>(current->size()) >= MAX_BUFFERS_PER_SIZE)
+		{
+			return;
+		}
+
+		// Buffers of other sizes are no longer in use, if the size has changed
+		for (auto it = _buffers.begin(); it != _buffers.end() && _bytes + pixelBytes > MAX_BYTES;)
+		{
+			if (it.key() == pixelKey)
+			{
+				++it;
+				continue;
+			}
+
+			for (std::vector<Pixel_T>& buffer : it.value())
+			{
+				const qint64 bufferBytes = bytes(buffer);
+				_bytes -= bufferBytes;
+				--_buffersHeld;
+				_bytesHeld -= bufferBytes;
+				evicted.push_back(std::move(buffer));
+			}
+			it = _buffers.erase(it);
+		}
+
+		if (_bytes + pixelBytes > MAX_BYTES)
+		{
+			return;
+		}
+
+		// The size is only added, once a buffer is kept for it
+		_buffers[pixelKey].push_back(std::move(pixels));
+		_bytes += pixelBytes;
+		++_buffersHeld;
+		_bytesHeld += pixelBytes;
+	}
+}
+
+// Explicit template instantiations
+template class ImageDataPool<ColorRgb>;
+template class ImageDataPool<ColorBgr>;
+template class ImageDataPool<ColorRgba>;
@@ -1,7 +1,91 @@
 #include "utils/ImageResampler.h"
-#include <utils/ColorSys.h>
+#include <utils/YuvToRgb.h>
+#include <utils/PixelAccumulator.h>
 #include <utils/Logger.h>
 
+// STL includes
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// Lines of a block summed up in 16 bits (257 * 255 < 2^16)
+constexpr int MAX_BOX_FILTER_LINES = 257;
+
+// VC4 T-tiled layout at 32 bits per pixel: 4 KiB tiles of 32x32 pixels, 1 KiB sub-tiles of 16x16 pixels, 64 byte micro-tiles of 4x4 pixels
+constexpr size_t VC4_TILE_WIDTH = 32;
+constexpr size_t VC4_TILE_HEIGHT = 32;
+constexpr size_t VC4_TILE_BYTES = 4096;
+constexpr size_t VC4_TILE_LINE_BYTES = VC4_TILE_BYTES / VC4_TILE_HEIGHT;
+constexpr size_t VC4_SUBTILE_WIDTH = 16;
+constexpr size_t VC4_SUBTILE_HEIGHT = 16;
+constexpr size_t VC4_SUBTILE_BYTES = 1024;
+constexpr size_t VC4_MICROTILE_WIDTH = 4;
+constexpr size_t VC4_MICROTILE_HEIGHT = 4;
+constexpr size_t VC4_MICROTILE_BYTES = 64;
+
+///
+/// The decimated columns of a row with the flip mode resolved
+///
+struct Columns
+{
+	int count;
+	/// Destination of the first sampled column and step to the next one
+	int xDestStart;
+	int xDestStep;
+	/// First sampled source column and step to the next one
+	int xSourceStart;
+	int xSourceStep;
+
+	///
+	/// Calls the function for every sampled column with its destination and source index
+	///
+	template <typename Function_T>
+	inline void forEach(Function_T function) const
+	{
+		for (int i = 0, xDest = xDestStart, xSource = xSourceStart; i < count; ++i, xDest += xDestStep, xSource += xSourceStep)
+		{
+			function(xDest, xSource);
+		}
+	}
+};
+
+bool isYuv(PixelFormat pixelFormat)
+{
+	switch (pixelFormat)
+	{
+		case PixelFormat::UYVY:
+		case PixelFormat::YUYV:
+		case PixelFormat::NV12:
+		case PixelFormat::NV21:
+		case PixelFormat::I420:
+		case PixelFormat::I422:
+			return true;
+		default:
+			return false;
+	}
+}
+
+inline uint8_t average(uint32_t sum, uint32_t count)
+{
+	return static_cast<uint8_t>((sum + (count >> 1)) / count);
+}
+
+///
+/// Adds the bytes [begin, end) of a line to the sums of the same bytes, clipped to [0, size)
+///
+inline void addLine(const uint8_t * line, int begin, int end, int size, uint16_t * sums)
+{
+	begin = std::max(begin, 0);
+	end = std::min(end, size);
+	if (end > begin)
+	{
+		PixelAccumulator::addBytes(line + begin, end - begin, sums + begin);
+	}
+}
+
+} // namespace
+
 ImageResampler::ImageResampler()
 	: _horizontalDecimation(8)
 	, _verticalDecimation(8)
@@ -11,6 +95,7 @@ ImageResampler::ImageResampler()
 	, _cropBottom(0)
 	, _videoMode(VideoMode::VIDEO_2D)
 	, _flipMode(FlipMode::NO_CHANGE)
+	, _boxFilter(false)
 {
 }
 
@@ -22,258 +107,538 @@ void ImageResampler::setCropping(int cropLeft, int cropRight, int cropTop, int c
 	_cropBottom = cropBottom;
 }
 
-void ImageResampler::processImage(const uint8_t * data, int width, int height, size_t lineLength, PixelFormat pixelFormat, Image<ColorRgb> &outputImage) const
+ImageResampler::Geometry ImageResampler::geometry(int width, int height) const
 {
-	int cropLeft = _cropLeft;
-	int cropRight  = _cropRight;
-	int cropTop = _cropTop;
-	int cropBottom = _cropBottom;
+	Geometry geometry { _cropLeft, _cropRight, _cropTop, _cropBottom, 0, 0, false, false };
 
 	// handle 3D mode
 	switch (_videoMode)
 	{
 	case VideoMode::VIDEO_3DSBS:
-		cropRight =  (width >> 1) + (cropRight >> 1);
-		cropLeft = cropLeft >> 1;
+		geometry.cropRight =  (width >> 1) + (geometry.cropRight >> 1);
+		geometry.cropLeft = geometry.cropLeft >> 1;
 		break;
 	case VideoMode::VIDEO_3DTAB:
-		cropBottom = (height >> 1) + (cropBottom >> 1);
-		cropTop = cropTop >> 1;
+		geometry.cropBottom = (height >> 1) + (geometry.cropBottom >> 1);
+		geometry.cropTop = geometry.cropTop >> 1;
 		break;
 	default:
 		break;
 	}
 
 	// calculate the output size
-	int outputWidth = (width - cropLeft - cropRight - (_horizontalDecimation >> 1) + _horizontalDecimation - 1) / _horizontalDecimation;
-	int outputHeight = (height - cropTop - cropBottom - (_verticalDecimation >> 1) + _verticalDecimation - 1) / _verticalDecimation;
+	geometry.outputWidth = (width - geometry.cropLeft - geometry.cropRight - (_horizontalDecimation >> 1) + _horizontalDecimation - 1) / _horizontalDecimation;
+	geometry.outputHeight = (height - geometry.cropTop - geometry.cropBottom - (_verticalDecimation >> 1) + _verticalDecimation - 1) / _verticalDecimation;
 
-	outputImage.resize(outputWidth, outputHeight);
+	// Resolve the flip mode once: HORIZONTAL mirrors the rows, VERTICAL mirrors the columns
+	geometry.mirrorRows = (_flipMode == FlipMode::HORIZONTAL || _flipMode == FlipMode::BOTH);
+	geometry.mirrorColumns = (_flipMode == FlipMode::VERTICAL || _flipMode == FlipMode::BOTH);
+
+	return geometry;
+}
+
+void ImageResampler::processImage(const uint8_t * data, int width, int height, size_t lineLength, PixelFormat pixelFormat, Image<ColorRgb> &outputImage) const
+{
+	const Geometry geometry = this->geometry(width, height);
+	const int cropLeft = geometry.cropLeft;
+	const int cropRight = geometry.cropRight;
+	const int cropTop = geometry.cropTop;
+	const int cropBottom = geometry.cropBottom;
+	const int outputWidth = geometry.outputWidth;
+	const int outputHeight = geometry.outputHeight;
 
-	int xDestStart {0};
-	int xDestEnd = {outputWidth-1};
-	int yDestStart = {0};
-	int yDestEnd = {outputHeight-1};
+	outputImage.resize(outputWidth, outputHeight);
 
-	switch (_flipMode)
+	switch (pixelFormat)
 	{
-		case FlipMode::NO_CHANGE:
-		//use the initalized values
-			break;
-		case FlipMode::HORIZONTAL:
-			xDestStart = 0;
-			xDestEnd = outputWidth-1;
-			yDestStart = -(outputHeight-1);
-			yDestEnd = 0;
-			break;
-		case FlipMode::VERTICAL:
-			xDestStart = -(outputWidth-1);
-			xDestEnd = 0;
-			yDestStart = 0;
-			yDestEnd = outputHeight-1;
-			break;
-		case FlipMode::BOTH:
-			xDestStart = -(outputWidth-1);
-			xDestEnd = 0;
-			yDestStart = -(outputHeight-1);
-			yDestEnd = 0;
+		case PixelFormat::MJPEG:
+			return;
+		case PixelFormat::P030:
+			Warning(Logger::getInstance("ImageResampler"), "%s",
+					QSTRING_CSTR(QString("Pixel format %1 not supported yet").arg(pixelFormatToString(pixelFormat))));
+			return;
+		case PixelFormat::NO_CHANGE:
+			Error(Logger::getInstance("ImageResampler"), "Invalid pixel format given");
+			return;
+		default:
 			break;
 	}
 
-	switch (pixelFormat)
+	if (outputWidth <= 0 || outputHeight <= 0)
 	{
-		case PixelFormat::UYVY:
+		return;
+	}
+
+	const bool mirrorRows = geometry.mirrorRows;
+	const bool mirrorColumns = geometry.mirrorColumns;
+
+	if (_boxFilter && (_horizontalDecimation > 1 || _verticalDecimation > 1) && _verticalDecimation <= MAX_BOX_FILTER_LINES && pixelFormat != PixelFormat::BGR16)
+	{
+		processImageBoxFilter(data, width, height, lineLength, pixelFormat, cropLeft, cropRight, cropTop, cropBottom, mirrorRows, mirrorColumns, outputImage);
+		outputImage.updateFingerprint();
+		return;
+	}
+
+	const Columns columns { outputWidth, mirrorColumns ? outputWidth - 1 : 0, mirrorColumns ? -1 : 1, cropLeft + (_horizontalDecimation >> 1), _horizontalDecimation };
+
+	// Decimated YUV samples of a row in output order, converted to RGB in one go
+	std::vector<uint8_t> samples;
+	if (isYuv(pixelFormat))
+	{
+		samples.resize(static_cast<size_t>(outputWidth) * 3);
+	}
+	uint8_t * const ySamples = samples.data();
+	uint8_t * const uSamples = ySamples + outputWidth;
+	uint8_t * const vSamples = uSamples + outputWidth;
+
+	for (int row = 0, ySource = cropTop + (_verticalDecimation >> 1); row < outputHeight; ++row, ySource += _verticalDecimation)
+	{
+		ColorRgb * const destination = outputImage.memptr() + static_cast<size_t>(mirrorRows ? outputHeight - 1 - row : row) * outputWidth;
+		const uint8_t * const line = data + lineLength * ySource;
+
+		switch (pixelFormat)
 		{
-			for (int yDest = yDestStart, ySource = cropTop + (_verticalDecimation >> 1); yDest <= yDestEnd; ySource += _verticalDecimation, ++yDest)
+			case PixelFormat::UYVY:
 			{
-				for (int xDest = xDestStart, xSource = cropLeft + (_horizontalDecimation >> 1); xDest <= xDestEnd; xSource += _horizontalDecimation, ++xDest)
-				{
-					ColorRgb & rgb = outputImage(abs(xDest), abs(yDest));
-					size_t index = lineLength * ySource + (xSource << 1);
-					uint8_t y = data[index+1];
-					uint8_t u = ((xSource&1) == 0) ? data[index  ] : data[index-2];
-					uint8_t v = ((xSource&1) == 0) ? data[index+2] : data[index  ];
-					ColorSys::yuv2rgb(y, u, v, rgb.red, rgb.green, rgb.blue);
-				}
+				columns.forEach([&](int xDest, int xSource) {
+					const uint8_t * const pixel = line + (xSource << 1);
+					ySamples[xDest] = pixel[1];
+					uSamples[xDest] = ((xSource&1) == 0) ? pixel[0] : pixel[-2];
+					vSamples[xDest] = ((xSource&1) == 0) ? pixel[2] : pixel[0];
+				});
+				break;
 			}
-			break;
-		}
 
-		case PixelFormat::YUYV:
-		{
-			for (int yDest = yDestStart, ySource = cropTop + (_verticalDecimation >> 1); yDest <= yDestEnd; ySource += _verticalDecimation, ++yDest)
+			case PixelFormat::YUYV:
 			{
-				for (int xDest = xDestStart, xSource = cropLeft + (_horizontalDecimation >> 1); xDest <= xDestEnd; xSource += _horizontalDecimation, ++xDest)
-				{
-					ColorRgb & rgb = outputImage(abs(xDest), abs(yDest));
-					size_t index = lineLength * ySource + (xSource << 1);
-					uint8_t y = data[index];
-					uint8_t u = ((xSource&1) == 0) ? data[index+1] : data[index-1];
-					uint8_t v = ((xSource&1) == 0) ? data[index+3] : data[index+1];
-					ColorSys::yuv2rgb(y, u, v, rgb.red, rgb.green, rgb.blue);
-				}
+				columns.forEach([&](int xDest, int xSource) {
+					const uint8_t * const pixel = line + (xSource << 1);
+					ySamples[xDest] = pixel[0];
+					uSamples[xDest] = ((xSource&1) == 0) ? pixel[1] : pixel[-1];
+					vSamples[xDest] = ((xSource&1) == 0) ? pixel[3] : pixel[1];
+				});
+				break;
 			}
-			break;
-		}
 
-		case PixelFormat::BGR16:
-		{
-			for (int yDest = yDestStart, ySource = cropTop + (_verticalDecimation >> 1); yDest <= yDestEnd; ySource += _verticalDecimation, ++yDest)
+			case PixelFormat::BGR16:
 			{
-				for (int xDest = xDestStart, xSource = cropLeft + (_horizontalDecimation >> 1); xDest <= xDestEnd; xSource += _horizontalDecimation, ++xDest)
-				{
-					ColorRgb & rgb = outputImage(abs(xDest), abs(yDest));
-					size_t index = lineLength * ySource + (xSource << 1);
-					rgb.blue  = static_cast<uint8_t>((data[index] & 0x1f) << 3);
-					rgb.green = static_cast<uint8_t>((((data[index+1] & 0x7) << 3) | (data[index] & 0xE0) >> 5) << 2);
-					rgb.red   = (data[index+1] & 0xF8);
-				}
+				columns.forEach([&](int xDest, int xSource) {
+					const uint8_t * const pixel = line + (xSource << 1);
+					ColorRgb & rgb = destination[xDest];
+					rgb.blue  = static_cast<uint8_t>((pixel[0] & 0x1f) << 3);
+					rgb.green = static_cast<uint8_t>((((pixel[1] & 0x7) << 3) | (pixel[0] & 0xE0) >> 5) << 2);
+					rgb.red   = (pixel[1] & 0xF8);
+				});
+				break;
 			}
-			break;
-		}
 
-		case PixelFormat::RGB24:
-		{
-			for (int yDest = yDestStart, ySource = cropTop + (_verticalDecimation >> 1); yDest <= yDestEnd; ySource += _verticalDecimation, ++yDest)
+			case PixelFormat::RGB24:
 			{
-				for (int xDest = xDestStart, xSource = cropLeft + (_horizontalDecimation >> 1); xDest <= xDestEnd; xSource += _horizontalDecimation, ++xDest)
-				{
-					ColorRgb & rgb = outputImage(abs(xDest), abs(yDest));
-					size_t index = lineLength * ySource + (xSource << 1) + xSource;
-					rgb.red   = data[index  ];
-					rgb.green = data[index+1];
-					rgb.blue  = data[index+2];
-				}
+				columns.forEach([&](int xDest, int xSource) {
+					const uint8_t * const pixel = line + (xSource << 1) + xSource;
+					destination[xDest] = { pixel[0], pixel[1], pixel[2] };
+				});
+				break;
 			}
-			break;
-		}
 
-		case PixelFormat::BGR24:
-		{
-			for (int yDest = yDestStart, ySource = cropTop + (_verticalDecimation >> 1); yDest <= yDestEnd; ySource += _verticalDecimation, ++yDest)
+			case PixelFormat::BGR24:
 			{
-				for (int xDest = xDestStart, xSource = cropLeft + (_horizontalDecimation >> 1); xDest <= xDestEnd; xSource += _horizontalDecimation, ++xDest)
-				{
-					ColorRgb & rgb = outputImage(abs(xDest), abs(yDest));
-					size_t index = lineLength * ySource + (xSource << 1) + xSource;
-					rgb.blue  = data[index  ];
-					rgb.green = data[index+1];
-					rgb.red   = data[index+2];
-				}
+				columns.forEach([&](int xDest, int xSource) {
+					const uint8_t * const pixel = line + (xSource << 1) + xSource;
+					destination[xDest] = { pixel[2], pixel[1], pixel[0] };
+				});
+				break;
 			}
-			break;
-		}
 
-		case PixelFormat::RGB32:
-		{
-			for (int yDest = yDestStart, ySource = cropTop + (_verticalDecimation >> 1); yDest <= yDestEnd; ySource += _verticalDecimation, ++yDest)
+			case PixelFormat::RGB32:
 			{
-				for (int xDest = xDestStart, xSource = cropLeft + (_horizontalDecimation >> 1); xDest <= xDestEnd; xSource += _horizontalDecimation, ++xDest)
-				{
-					ColorRgb & rgb = outputImage(abs(xDest), abs(yDest));
-					size_t index = lineLength * ySource + (xSource << 2);
-					rgb.red   = data[index  ];
-					rgb.green = data[index+1];
-					rgb.blue  = data[index+2];
-				}
+				columns.forEach([&](int xDest, int xSource) {
+					const uint8_t * const pixel = line + (xSource << 2);
+					destination[xDest] = { pixel[0], pixel[1], pixel[2] };
+				});
+				break;
 			}
-			break;
-		}
 
-		case PixelFormat::BGR32:
-		{
-			for (int yDest = yDestStart, ySource = cropTop + (_verticalDecimation >> 1); yDest <= yDestEnd; ySource += _verticalDecimation, ++yDest)
+			case PixelFormat::BGR32:
 			{
-				for (int xDest = xDestStart, xSource = cropLeft + (_horizontalDecimation >> 1); xDest <= xDestEnd; xSource += _horizontalDecimation, ++xDest)
-				{
-					ColorRgb & rgb = outputImage(abs(xDest), abs(yDest));
-					size_t index = lineLength * ySource + (xSource << 2);
-					rgb.blue  = data[index  ];
-					rgb.green = data[index+1];
-					rgb.red   = data[index+2];
-				}
+				columns.forEach([&](int xDest, int xSource) {
+					const uint8_t * const pixel = line + (xSource << 2);
+					destination[xDest] = { pixel[2], pixel[1], pixel[0] };
+				});
+				break;
 			}
-			break;
+
+			case PixelFormat::NV12:
+			{
+				const uint8_t * const chroma = data + (height + ySource / 2) * lineLength;
+				columns.forEach([&](int xDest, int xSource) {
+					ySamples[xDest] = line[xSource];
+					uSamples[xDest] = chroma[((xSource >> 1) << 1)];
+					vSamples[xDest] = chroma[((xSource >> 1) << 1) + 1];
+				});
+				break;
+			}
+
+			case PixelFormat::NV21:
+			{
+				const uint8_t * const chroma = data + (height + ySource / 2) * lineLength;
+				columns.forEach([&](int xDest, int xSource) {
+					ySamples[xDest] = line[xSource];
+					vSamples[xDest] = chroma[((xSource >> 1) << 1)];
+					uSamples[xDest] = chroma[((xSource >> 1) << 1) + 1];
+				});
+				break;
+			}
+
+			case PixelFormat::I420: // YUV 4:2:0 Planar
+			{
+				const uint8_t * const uPlane = data + width * height + (ySource/2) * width/2;
+				const uint8_t * const vPlane = data + width * height + (width * height / 4) + (ySource/2) * width/2;
+				columns.forEach([&](int xDest, int xSource) {
+					ySamples[xDest] = line[xSource];
+					uSamples[xDest] = uPlane[xSource >> 1];
+					vSamples[xDest] = vPlane[xSource >> 1];
+				});
+				break;
+			}
+
+			case PixelFormat::I422: // YUV 4:2:2 Planar
+			{
+				const uint8_t * const uPlane = data + width * height + ySource * (width/2);
+				const uint8_t * const vPlane = data + (width * height) + (width * height / 2) + ySource * (width/2);
+				columns.forEach([&](int xDest, int xSource) {
+					ySamples[xDest] = line[xSource];
+					uSamples[xDest] = uPlane[xSource >> 1];
+					vSamples[xDest] = vPlane[xSource >> 1];
+				});
+				break;
+			}
+
+			default:
+				break;
+		}
+
+		if (isYuv(pixelFormat))
+		{
+			YuvToRgb::convert(ySamples, uSamples, vSamples, outputWidth, destination);
 		}
+	}
+
+	// The decimated frame is hashed while it is still in the cache, the output skips frames that did not change
+	outputImage.updateFingerprint();
+}
 
+void ImageResampler::processImageBoxFilter(const uint8_t * data, int width, int height, size_t lineLength, PixelFormat pixelFormat,
+										   int cropLeft, int cropRight, int cropTop, int cropBottom,
+										   bool mirrorRows, bool mirrorColumns, Image<ColorRgb> & outputImage) const
+{
+	const int outputWidth = outputImage.width();
+	const int outputHeight = outputImage.height();
+
+	// Blocks start at the crop offsets, the last block of a row/column is clipped to the cropped area
+	const int xEnd = width - cropRight;
+	const int yEnd = height - cropBottom;
+
+	const Columns columns { outputWidth, mirrorColumns ? outputWidth - 1 : 0, mirrorColumns ? -1 : 1, cropLeft, _horizontalDecimation };
+
+	// Per line byte sums of the lines of a block, indexed like the bytes of a line (with a margin for the last pixel)
+	int lineBytes = width;
+	int chromaLineBytes = 0;
+	switch (pixelFormat)
+	{
+		case PixelFormat::YUYV:
+		case PixelFormat::UYVY:
+			lineBytes = width * 2;
+			break;
+		case PixelFormat::RGB24:
+		case PixelFormat::BGR24:
+			lineBytes = width * 3;
+			break;
+		case PixelFormat::RGB32:
+		case PixelFormat::BGR32:
+			lineBytes = width * 4;
+			break;
 		case PixelFormat::NV12:
+		case PixelFormat::NV21:
+			chromaLineBytes = width;
+			break;
+		case PixelFormat::I420:
+		case PixelFormat::I422:
+			chromaLineBytes = width / 2;
+			break;
+		default:
+			break;
+	}
+	const int bytesPerPixel = lineBytes / width;
+
+	std::vector<uint16_t> lineSums(static_cast<size_t>(lineBytes) + 4);
+	std::vector<uint16_t> uSums(static_cast<size_t>(chromaLineBytes) + 2);
+	std::vector<uint16_t> vSums(static_cast<size_t>(chromaLineBytes) + 2);
+
+	std::vector<uint8_t> samples;
+	if (isYuv(pixelFormat))
+	{
+		samples.resize(static_cast<size_t>(outputWidth) * 3);
+	}
+	uint8_t * const ySamples = samples.data();
+	uint8_t * const uSamples = ySamples + outputWidth;
+	uint8_t * const vSamples = uSamples + outputWidth;
+
+	for (int row = 0, yBegin = cropTop; row < outputHeight; ++row, yBegin += _verticalDecimation)
+	{
+		ColorRgb * const destination = outputImage.memptr() + static_cast<size_t>(mirrorRows ? outputHeight - 1 - row : row) * outputWidth;
+		const int lines = std::min(yBegin + _verticalDecimation, yEnd) - yBegin;
+
+		// Sum up the lines of the block row, limited to the cropped columns
+		std::fill(lineSums.begin(), lineSums.end(), 0);
+		std::fill(uSums.begin(), uSums.end(), 0);
+		std::fill(vSums.begin(), vSums.end(), 0);
+		for (int ySource = yBegin; ySource < yBegin + lines; ++ySource)
 		{
-			for (int yDest = yDestStart, ySource = cropTop + (_verticalDecimation >> 1); yDest <= yDestEnd; ySource += _verticalDecimation, ++yDest)
+			const uint8_t * const line = data + lineLength * ySource;
+			addLine(line, (cropLeft - 1) * bytesPerPixel, (xEnd + 1) * bytesPerPixel, lineBytes, lineSums.data());
+
+			// Every pixel accounts for the chroma sample it is decoded with
+			switch (pixelFormat)
 			{
-				size_t uOffset = (height + ySource / 2) * lineLength;
-				for (int xDest = xDestStart, xSource = cropLeft + (_horizontalDecimation >> 1); xDest <= xDestEnd; xSource += _horizontalDecimation, ++xDest)
-				{
-					ColorRgb & rgb = outputImage(abs(xDest), abs(yDest));
-					uint8_t y = data[lineLength * ySource + xSource];
-					uint8_t u = data[uOffset + ((xSource >> 1) << 1)];
-					uint8_t v = data[uOffset + ((xSource >> 1) << 1) + 1];
-					ColorSys::yuv2rgb(y, u, v, rgb.red, rgb.green, rgb.blue);
-				}
+				case PixelFormat::NV12:
+				case PixelFormat::NV21:
+					addLine(data + (height + ySource / 2) * lineLength, cropLeft - 2, xEnd + 2, chromaLineBytes, uSums.data());
+					break;
+				case PixelFormat::I420:
+					addLine(data + width * height + (ySource/2) * width/2, cropLeft / 2 - 1, xEnd / 2 + 1, chromaLineBytes, uSums.data());
+					addLine(data + width * height + (width * height / 4) + (ySource/2) * width/2, cropLeft / 2 - 1, xEnd / 2 + 1, chromaLineBytes, vSums.data());
+					break;
+				case PixelFormat::I422:
+					addLine(data + width * height + ySource * (width/2), cropLeft / 2 - 1, xEnd / 2 + 1, chromaLineBytes, uSums.data());
+					addLine(data + (width * height) + (width * height / 2) + ySource * (width/2), cropLeft / 2 - 1, xEnd / 2 + 1, chromaLineBytes, vSums.data());
+					break;
+				default:
+					break;
 			}
-			break;
 		}
 
-		case PixelFormat::NV21:
-		{
-			for (int yDest = yDestStart, ySource = cropTop + (_verticalDecimation >> 1); yDest <= yDestEnd; ySource += _verticalDecimation, ++yDest)
+		const uint16_t * const sums = lineSums.data();
+		columns.forEach([&](int xDest, int xBegin) {
+			const int xBlockEnd = std::min(xBegin + _horizontalDecimation, xEnd);
+			const uint32_t count = static_cast<uint32_t>((xBlockEnd - xBegin) * lines);
+
+			uint32_t first = 0;
+			uint32_t second = 0;
+			uint32_t third = 0;
+			switch (pixelFormat)
 			{
-				size_t uOffset = (height + ySource / 2) * lineLength;
-				for (int xDest = xDestStart, xSource = cropLeft + (_horizontalDecimation >> 1); xDest <= xDestEnd; xSource += _horizontalDecimation, ++xDest)
-				{
-					ColorRgb & rgb = outputImage(abs(xDest), abs(yDest));
-					uint8_t y = data[lineLength * ySource + xSource];
-					uint8_t v = data[uOffset + ((xSource >> 1) << 1)];
-					uint8_t u = data[uOffset + ((xSource >> 1) << 1) + 1];
-					ColorSys::yuv2rgb(y, u, v, rgb.red, rgb.green, rgb.blue);
-				}
+				case PixelFormat::UYVY:
+					for (int x = xBegin; x < xBlockEnd; ++x)
+					{
+						const uint16_t * const pixel = sums + (x << 1);
+						first  += pixel[1];
+						second += ((x&1) == 0) ? pixel[0] : pixel[-2];
+						third  += ((x&1) == 0) ? pixel[2] : pixel[0];
+					}
+					break;
+				case PixelFormat::YUYV:
+					for (int x = xBegin; x < xBlockEnd; ++x)
+					{
+						const uint16_t * const pixel = sums + (x << 1);
+						first  += pixel[0];
+						second += ((x&1) == 0) ? pixel[1] : pixel[-1];
+						third  += ((x&1) == 0) ? pixel[3] : pixel[1];
+					}
+					break;
+				case PixelFormat::RGB24:
+				case PixelFormat::BGR24:
+				case PixelFormat::RGB32:
+				case PixelFormat::BGR32:
+					for (int x = xBegin; x < xBlockEnd; ++x)
+					{
+						const uint16_t * const pixel = sums + x * bytesPerPixel;
+						first  += pixel[0];
+						second += pixel[1];
+						third  += pixel[2];
+					}
+					break;
+				case PixelFormat::NV12:
+				case PixelFormat::NV21:
+					for (int x = xBegin; x < xBlockEnd; ++x)
+					{
+						first  += sums[x];
+						second += uSums[((x >> 1) << 1)];
+						third  += uSums[((x >> 1) << 1) + 1];
+					}
+					if (pixelFormat == PixelFormat::NV21)
+					{
+						std::swap(second, third);
+					}
+					break;
+				case PixelFormat::I420:
+				case PixelFormat::I422:
+					for (int x = xBegin; x < xBlockEnd; ++x)
+					{
+						first  += sums[x];
+						second += uSums[x >> 1];
+						third  += vSums[x >> 1];
+					}
+					break;
+				default:
+					break;
 			}
-			break;
+
+			switch (pixelFormat)
+			{
+				case PixelFormat::RGB24:
+				case PixelFormat::RGB32:
+					destination[xDest] = { average(first, count), average(second, count), average(third, count) };
+					break;
+				case PixelFormat::BGR24:
+				case PixelFormat::BGR32:
+					destination[xDest] = { average(third, count), average(second, count), average(first, count) };
+					break;
+				default:
+					ySamples[xDest] = average(first, count);
+					uSamples[xDest] = average(second, count);
+					vSamples[xDest] = average(third, count);
+					break;
+			}
+		});
+
+		if (isYuv(pixelFormat))
+		{
+			YuvToRgb::convert(ySamples, uSamples, vSamples, outputWidth, destination);
 		}
+	}
+}
+
+size_t ImageResampler::tiledImageSize(int width, int height, const TiledLayout & layout, PixelFormat pixelFormat)
+{
+	if (width <= 0 || height <= 0)
+	{
+		return 0;
+	}
+
+	switch (layout.type)
+	{
+		case TiledLayout::Type::BROADCOM_SAND:
+			if ((pixelFormat != PixelFormat::NV12 && pixelFormat != PixelFormat::NV21) || layout.columnWidth <= 0 || layout.columnHeight <= 0)
+			{
+				return 0;
+			}
+			// Luma and chroma lines are one byte per pixel wide, the planes are placed within the columns
+			return static_cast<size_t>((width + layout.columnWidth - 1) / layout.columnWidth) * static_cast<size_t>(layout.columnWidth) * static_cast<size_t>(layout.columnHeight);
+
+		case TiledLayout::Type::VC4_T_TILED:
+			if ((pixelFormat != PixelFormat::RGB32 && pixelFormat != PixelFormat::BGR32) || layout.pitch < width * 4 || layout.pitch % VC4_TILE_LINE_BYTES != 0)
+			{
+				return 0;
+			}
+			return layout.planeOffsets[0] + static_cast<size_t>((height + VC4_TILE_HEIGHT - 1) / VC4_TILE_HEIGHT) * VC4_TILE_HEIGHT * static_cast<size_t>(layout.pitch);
+
+		default:
+			return 0;
+	}
+}
+
+bool ImageResampler::processTiledImage(const uint8_t * data, int width, int height, const TiledLayout & layout, PixelFormat pixelFormat, Image<ColorRgb> & outputImage) const
+{
+	if (tiledImageSize(width, height, layout, pixelFormat) == 0)
+	{
+		return false;
+	}
+
+	const Geometry geometry = this->geometry(width, height);
+	const int outputWidth = geometry.outputWidth;
+	const int outputHeight = geometry.outputHeight;
+
+	outputImage.resize(outputWidth, outputHeight);
+	if (outputWidth <= 0 || outputHeight <= 0)
+	{
+		return true;
+	}
+
+	const Columns columns { outputWidth, geometry.mirrorColumns ? outputWidth - 1 : 0, geometry.mirrorColumns ? -1 : 1, geometry.cropLeft + (_horizontalDecimation >> 1), _horizontalDecimation };
+
+	// The address of a sample is split into a part depending on the column only, which is resolved once per frame, and a part depending on the line
+	std::vector<size_t> columnOffsets(static_cast<size_t>(outputWidth));
+
+	if (layout.type == TiledLayout::Type::BROADCOM_SAND)
+	{
+		const size_t columnWidth = static_cast<size_t>(layout.columnWidth);
+		const size_t columnSize = columnWidth * static_cast<size_t>(layout.columnHeight);
 
-		case PixelFormat::I420: // YUV 4:2:0 Planar
+		// Interleaved chroma pairs start at even bytes, i.e. never span two columns
+		std::vector<size_t> chromaOffsets(static_cast<size_t>(outputWidth));
+		columns.forEach([&](int xDest, int xSource) {
+			const size_t x = static_cast<size_t>(xSource);
+			const size_t xChroma = (x >> 1) << 1;
+			columnOffsets[xDest] = (x / columnWidth) * columnSize + x % columnWidth;
+			chromaOffsets[xDest] = (xChroma / columnWidth) * columnSize + xChroma % columnWidth;
+		});
+
+		const bool isNV21 = (pixelFormat == PixelFormat::NV21);
+		std::vector<uint8_t> samples(static_cast<size_t>(outputWidth) * 3);
+		uint8_t * const ySamples = samples.data();
+		uint8_t * const uSamples = ySamples + outputWidth;
+		uint8_t * const vSamples = uSamples + outputWidth;
+
+		for (int row = 0, ySource = geometry.cropTop + (_verticalDecimation >> 1); row < outputHeight; ++row, ySource += _verticalDecimation)
 		{
-			for (int yDest = yDestStart, ySource = cropTop + (_verticalDecimation >> 1); yDest <= yDestEnd; ySource += _verticalDecimation, ++yDest)
+			ColorRgb * const destination = outputImage.memptr() + static_cast<size_t>(geometry.mirrorRows ? outputHeight - 1 - row : row) * outputWidth;
+			const uint8_t * const luma = data + layout.planeOffsets[0] + static_cast<size_t>(ySource) * columnWidth;
+			const uint8_t * const chroma = data + layout.planeOffsets[1] + static_cast<size_t>(ySource / 2) * columnWidth;
+
+			for (int xDest = 0; xDest < outputWidth; ++xDest)
 			{
-				int uOffset = width * height + (ySource/2) * width/2;
-				int vOffset = width * height + (width * height / 4) + (ySource/2) * width/2;
-				for (int xDest = xDestStart, xSource = cropLeft + (_horizontalDecimation >> 1); xDest <= xDestEnd; xSource += _horizontalDecimation, ++xDest)
-				{
-					ColorRgb & rgb = outputImage(abs(xDest), abs(yDest));
-					uint8_t y = data[lineLength * ySource + xSource];
-					uint8_t u = data[uOffset + (xSource >> 1)];
-					uint8_t v = data[vOffset + (xSource >> 1)];
-					ColorSys::yuv2rgb(y, u, v, rgb.red, rgb.green, rgb.blue);
-				}
+				const uint8_t * const pair = chroma + chromaOffsets[xDest];
+				ySamples[xDest] = luma[columnOffsets[xDest]];
+				uSamples[xDest] = pair[isNV21 ? 1 : 0];
+				vSamples[xDest] = pair[isNV21 ? 0 : 1];
 			}
-			break;
+
+			YuvToRgb::convert(ySamples, uSamples, vSamples, outputWidth, destination);
 		}
+	}
+	else
+	{
+		// Sub-tile order within a tile for even and odd rows of tiles, indexed by the sub-tile's position (row * 2 + column)
+		static constexpr size_t SUBTILE_ORDER[2][4] = { { 0, 3, 1, 2 }, { 2, 1, 3, 0 } };
+
+		const size_t tilesPerRow = static_cast<size_t>(layout.pitch) / VC4_TILE_LINE_BYTES;
+		std::vector<uint8_t> subtileColumns(static_cast<size_t>(outputWidth));
+		std::vector<size_t> tileColumns(static_cast<size_t>(outputWidth));
+
+		columns.forEach([&](int xDest, int xSource) {
+			const size_t x = static_cast<size_t>(xSource);
+			tileColumns[xDest] = x / VC4_TILE_WIDTH;
+			subtileColumns[xDest] = static_cast<uint8_t>((x % VC4_TILE_WIDTH) / VC4_SUBTILE_WIDTH);
+			// Micro-tile within the sub-tile and pixel within the micro-tile
+			columnOffsets[xDest] = ((x % VC4_SUBTILE_WIDTH) / VC4_MICROTILE_WIDTH) * VC4_MICROTILE_BYTES + (x % VC4_MICROTILE_WIDTH) * 4;
+		});
 
-		case PixelFormat::I422: // YUV 4:2:2 Planar
+		const bool isBGR = (pixelFormat == PixelFormat::BGR32);
+		for (int row = 0, ySource = geometry.cropTop + (_verticalDecimation >> 1); row < outputHeight; ++row, ySource += _verticalDecimation)
 		{
-			for (int yDest = yDestStart, ySource = cropTop + (_verticalDecimation >> 1); yDest <= yDestEnd; ySource += _verticalDecimation, ++yDest)
+			ColorRgb * const destination = outputImage.memptr() + static_cast<size_t>(geometry.mirrorRows ? outputHeight - 1 - row : row) * outputWidth;
+
+			const size_t y = static_cast<size_t>(ySource);
+			const size_t tileRow = y / VC4_TILE_HEIGHT;
+			const size_t isOddRow = tileRow & 1;
+			const size_t subtileRow = (y % VC4_TILE_HEIGHT) / VC4_SUBTILE_HEIGHT;
+			const uint8_t * const line = data + layout.planeOffsets[0] + tileRow * VC4_TILE_HEIGHT * static_cast<size_t>(layout.pitch)
+										 + ((y % VC4_SUBTILE_HEIGHT) / VC4_MICROTILE_HEIGHT) * (VC4_SUBTILE_WIDTH / VC4_MICROTILE_WIDTH) * VC4_MICROTILE_BYTES
+										 + (y % VC4_MICROTILE_HEIGHT) * VC4_MICROTILE_WIDTH * 4;
+
+			for (int xDest = 0; xDest < outputWidth; ++xDest)
 			{
-				int uOffset = width * height + ySource * (width/2);
-				int vOffset = (width * height) + (width * height / 2) + ySource * (width/2);
-				for (int xDest = xDestStart, xSource = cropLeft + (_horizontalDecimation >> 1); xDest <= xDestEnd; xSource += _horizontalDecimation, ++xDest)
-				{
-					ColorRgb & rgb = outputImage(abs(xDest), abs(yDest));
-					uint8_t y = data[lineLength * ySource + xSource];
-					uint8_t u = data[uOffset + (xSource >> 1)];
-					uint8_t v = data[vOffset + (xSource >> 1)];
-					ColorSys::yuv2rgb(y, u, v, rgb.red, rgb.green, rgb.blue);
-				}
+				// Odd rows of tiles are stored right to left
+				const size_t tileColumn = isOddRow ? tilesPerRow - 1 - tileColumns[xDest] : tileColumns[xDest];
+				const size_t subtile = SUBTILE_ORDER[isOddRow][subtileRow * 2 + subtileColumns[xDest]];
+				const uint8_t * const pixel = line + tileColumn * VC4_TILE_BYTES + subtile * VC4_SUBTILE_BYTES + columnOffsets[xDest];
+				destination[xDest] = isBGR ? ColorRgb{ pixel[2], pixel[1], pixel[0] } : ColorRgb{ pixel[0], pixel[1], pixel[2] };
 			}
-			break;
 		}
-
-		case PixelFormat::MJPEG:
-		break;
-		case PixelFormat::P030:
-			Warning(Logger::getInstance("ImageResampler"), "%s",
-					QSTRING_CSTR(QString("Pixel format %1 not supported yet").arg(pixelFormatToString(pixelFormat))));
-			break;
-		case PixelFormat::NO_CHANGE:
-			Error(Logger::getInstance("ImageResampler"), "Invalid pixel format given");
-		break;
 	}
+
+	outputImage.updateFingerprint();
+	return true;
 }
+
@@ -0,0 +1,99 @@
+#include <utils/LatencyHistogram.h>
+
+// STL includes
+#include <algorithm>
+#include <cmath>
+
+#include <QJsonArray>
+
+LatencyHistogram::LatencyHistogram()
+	: _count(0)
+	, _sumUs(0)
+	, _maxUs(0)
+{
+	for (std::atomic<int64_t>& bucket : _buckets)
+	{
+		bucket.store(0, std::memory_order_relaxed);
+	}
+}
+
+void LatencyHistogram::record(std::chrono::microseconds latency)
+{
+	const int64_t latencyUs = std::max<int64_t>(0, latency.count());
+
+	const auto bound = std::lower_bound(BUCKET_BOUNDS_US.begin(), BUCKET_BOUNDS_US.end(), latencyUs);
+	_buckets[static_cast<size_t>(bound - BUCKET_BOUNDS_US.begin())].fetch_add(1, std::memory_order_relaxed);
+
+	_count.fetch_add(1, std::memory_order_relaxed);
+	_sumUs.fetch_add(latencyUs, std::memory_order_relaxed);
+
+	int64_t maxUs = _maxUs.load(std::memory_order_relaxed);
+	while (latencyUs > maxUs && !_maxUs.compare_exchange_weak(maxUs, latencyUs, std::memory_order_relaxed))
+	{
+	}
+}
+
+void LatencyHistogram::reset()
+{
+	for (std::atomic<int64_t>& bucket : _buckets)
+	{
+		bucket.store(0, std::memory_order_relaxed);
+	}
+	_count.store(0, std::memory_order_relaxed);
+	_sumUs.store(0, std::memory_order_relaxed);
+	_maxUs.store(0, std::memory_order_relaxed);
+}
+
+int64_t LatencyHistogram::percentile(double percentile) const
+{
+	std::array<int64_t, BUCKET_COUNT> buckets;
+	int64_t total = 0;
+	for (size_t i = 0; i < buckets.size(); ++i)
+	{
+		buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+		total += buckets[i];
+	}
+
+	if (total == 0)
+	{
+		return 0;
+	}
+
+	const auto rank = static_cast<int64_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<double>(total)));
+	const int64_t maxUs = _maxUs.load(std::memory_order_relaxed);
+
+	int64_t cumulated = 0;
+	for (size_t i = 0; i < BUCKET_BOUNDS_US.size(); ++i)
+	{
+		cumulated += buckets[i];
+		if (cumulated >= std::max<int64_t>(rank, 1))
+		{
+			return std::min(BUCKET_BOUNDS_US[i], maxUs);
+		}
+	}
+	return maxUs;
+}
+
+QJsonObject LatencyHistogram::toJson() const
+{
+	const int64_t count = _count.load(std::memory_order_relaxed);
+
+	QJsonArray buckets;
+	for (size_t i = 0; i < _buckets.size(); ++i)
+	{
+		QJsonObject bucket;
+		bucket["le_us"] = i < BUCKET_BOUNDS_US.size() ? QJsonValue(static_cast<double>(BUCKET_BOUNDS_US[i])) : QJsonValue();
+		bucket["count"] = static_cast<double>(_buckets[i].load(std::memory_order_relaxed));
+		buckets.append(bucket);
+	}
+
+	QJsonObject histogram;
+	histogram["count"] = static_cast<double>(count);
+	histogram["mean_us"] = count > 0 ? static_cast<double>(_sumUs.load(std::memory_order_relaxed)) / static_cast<double>(count) : 0.0;
+	histogram["max_us"] = static_cast<double>(_maxUs.load(std::memory_order_relaxed));
+	histogram["p50_us"] = static_cast<double>(percentile(50));
+	histogram["p95_us"] = static_cast<double>(percentile(95));
+	histogram["p99_us"] = static_cast<double>(percentile(99));
+	histogram["buckets"] = buckets;
+	return histogram;
+}
@@ -0,0 +1,704 @@
+#include <utils/PixelAccumulator.h>
+#include <utils/CpuFeatures.h>
+
+// STL includes
+#include <array>
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PIXELACCUMULATOR_X86
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define PIXELACCUMULATOR_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(PIXELACCUMULATOR_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#endif
+
+namespace {
+
+using Sums = PixelAccumulator::Sums;
+using Implementation = PixelAccumulator::Implementation;
+using AccumulateFunction = void (*)(const ColorRgb *, int, int, Sums &);
+using AddBytesFunction = void (*)(const uint8_t *, int, uint16_t *);
+
+void sumScalar(const ColorRgb *pixels, int length, int stride, Sums &sums)
+{
+	uint64_t red = 0;
+	uint64_t green = 0;
+	uint64_t blue = 0;
+
+	const ColorRgb *pixel = pixels;
+	for (int i = 0; i < length; ++i, pixel += stride)
+	{
+		red += pixel->red;
+		green += pixel->green;
+		blue += pixel->blue;
+	}
+
+	sums.red += red;
+	sums.green += green;
+	sums.blue += blue;
+}
+
+void sumSquaredScalar(const ColorRgb *pixels, int length, int stride, Sums &sums)
+{
+	uint64_t red = 0;
+	uint64_t green = 0;
+	uint64_t blue = 0;
+
+	const ColorRgb *pixel = pixels;
+	for (int i = 0; i < length; ++i, pixel += stride)
+	{
+		red += static_cast<uint32_t>(pixel->red * pixel->red);
+		green += static_cast<uint32_t>(pixel->green * pixel->green);
+		blue += static_cast<uint32_t>(pixel->blue * pixel->blue);
+	}
+
+	sums.red += red;
+	sums.green += green;
+	sums.blue += blue;
+}
+
+void addBytesScalar(const uint8_t *bytes, int length, uint16_t *sums)
+{
+	for (int i = 0; i < length; ++i)
+	{
+		sums[i] = static_cast<uint16_t>(sums[i] + bytes[i]);
+	}
+}
+
+#if defined(PIXELACCUMULATOR_X86) || defined(PIXELACCUMULATOR_NEON)
+
+// Number of vectors needed to hold a block of WIDTH packed RGB24 pixels (WIDTH bytes per vector)
+constexpr int VECTORS_PER_BLOCK = 3;
+constexpr int CHANNELS = 3;
+
+// Vectorized implementations process blocks of WIDTH raw pixels, so the stride has to divide WIDTH
+constexpr bool isBlockStride(int stride, int width)
+{
+	return stride > 0 && stride <= width && (width % stride) == 0;
+}
+
+constexpr int strideIndex(int stride)
+{
+	int index = 0;
+	while ((1 << index) < stride)
+	{
+		++index;
+	}
+	return index;
+}
+
+///
+/// Byte masks selecting the bytes of one color channel of the sampled pixels within a block of WIDTH pixels.
+///
+template <int WIDTH>
+struct ChannelMasks
+{
+	alignas(32) uint8_t bytes[VECTORS_PER_BLOCK][CHANNELS][WIDTH];
+};
+
+template <int WIDTH>
+ChannelMasks<WIDTH> buildChannelMasks(int stride)
+{
+	ChannelMasks<WIDTH> masks {};
+	for (int vector = 0; vector < VECTORS_PER_BLOCK; ++vector)
+	{
+		for (int byte = 0; byte < WIDTH; ++byte)
+		{
+			const int offset = vector * WIDTH + byte;
+			const int pixel = offset / 3;
+			const int channel = offset % 3;
+			if (pixel % stride == 0)
+			{
+				masks.bytes[vector][channel][byte] = 0xFF;
+			}
+		}
+	}
+	return masks;
+}
+
+///
+/// Returns the masks for the given stride, which has to be a power of two dividing WIDTH.
+///
+template <int WIDTH>
+const ChannelMasks<WIDTH> &channelMasks(int stride)
+{
+	static const auto MASKS = [] {
+		std::array<ChannelMasks<WIDTH>, strideIndex(WIDTH) + 1> masks {};
+		for (int index = 0; index < static_cast<int>(masks.size()); ++index)
+		{
+			masks[index] = buildChannelMasks<WIDTH>(1 << index);
+		}
+		return masks;
+	}();
+	return MASKS[strideIndex(stride)];
+}
+
+#endif
+
+#ifdef PIXELACCUMULATOR_X86
+
+// Flush the 32-bit lanes of squared sums before they could overflow
+constexpr int SQUARED_FLUSH_BLOCKS = 4096;
+
+TARGET_SSE2 uint64_t horizontalSum64(__m128i vector)
+{
+	alignas(16) uint64_t lanes[2];
+	_mm_store_si128(reinterpret_cast<__m128i *>(lanes), vector);
+	return lanes[0] + lanes[1];
+}
+
+TARGET_SSE2 uint64_t horizontalSum32(__m128i vector)
+{
+	alignas(16) uint32_t lanes[4];
+	_mm_store_si128(reinterpret_cast<__m128i *>(lanes), vector);
+	return static_cast<uint64_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+}
+
+TARGET_SSE2 void sumSse2(const ColorRgb *pixels, int length, int stride, Sums &sums)
+{
+	constexpr int WIDTH = 16;
+	if (length <= 0 || !isBlockStride(stride, WIDTH))
+	{
+		sumScalar(pixels, length, stride, sums);
+		return;
+	}
+
+	const int blocks = ((length - 1) * stride + 1) / WIDTH;
+	const ChannelMasks<WIDTH> &masks = channelMasks<WIDTH>(stride);
+
+	__m128i mask[VECTORS_PER_BLOCK][CHANNELS];
+	for (int vector = 0; vector < VECTORS_PER_BLOCK; ++vector)
+	{
+		for (int channel = 0; channel < CHANNELS; ++channel)
+		{
+			mask[vector][channel] = _mm_load_si128(reinterpret_cast<const __m128i *>(masks.bytes[vector][channel]));
+		}
+	}
+
+	const __m128i zero = _mm_setzero_si128();
+	__m128i acc[CHANNELS] = { zero, zero, zero };
+
+	const auto *data = reinterpret_cast<const uint8_t *>(pixels);
+	for (int block = 0; block < blocks; ++block, data += VECTORS_PER_BLOCK * WIDTH)
+	{
+		for (int vector = 0; vector < VECTORS_PER_BLOCK; ++vector)
+		{
+			const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + vector * WIDTH));
+			for (int channel = 0; channel < CHANNELS; ++channel)
+			{
+				// Sum of absolute differences to zero adds the selected bytes into two 64-bit lanes
+				acc[channel] = _mm_add_epi64(acc[channel], _mm_sad_epu8(_mm_and_si128(bytes, mask[vector][channel]), zero));
+			}
+		}
+	}
+
+	sums.red += horizontalSum64(acc[0]);
+	sums.green += horizontalSum64(acc[1]);
+	sums.blue += horizontalSum64(acc[2]);
+
+	const int processed = blocks * (WIDTH / stride);
+	sumScalar(pixels + static_cast<ptrdiff_t>(blocks) * WIDTH, length - processed, stride, sums);
+}
+
+TARGET_SSE2 void sumSquaredSse2(const ColorRgb *pixels, int length, int stride, Sums &sums)
+{
+	constexpr int WIDTH = 16;
+	if (length <= 0 || !isBlockStride(stride, WIDTH))
+	{
+		sumSquaredScalar(pixels, length, stride, sums);
+		return;
+	}
+
+	const int blocks = ((length - 1) * stride + 1) / WIDTH;
+	const ChannelMasks<WIDTH> &masks = channelMasks<WIDTH>(stride);
+
+	// Masks widened to the 16-bit lanes of the low and high half of each vector
+	__m128i maskLow[VECTORS_PER_BLOCK][CHANNELS];
+	__m128i maskHigh[VECTORS_PER_BLOCK][CHANNELS];
+	for (int vector = 0; vector < VECTORS_PER_BLOCK; ++vector)
+	{
+		for (int channel = 0; channel < CHANNELS; ++channel)
+		{
+			const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i *>(masks.bytes[vector][channel]));
+			maskLow[vector][channel] = _mm_unpacklo_epi8(mask, mask);
+			maskHigh[vector][channel] = _mm_unpackhi_epi8(mask, mask);
+		}
+	}
+
+	const __m128i zero = _mm_setzero_si128();
+	__m128i acc[CHANNELS] = { zero, zero, zero };
+	uint64_t total[CHANNELS] = { 0, 0, 0 };
+
+	const auto *data = reinterpret_cast<const uint8_t *>(pixels);
+	for (int block = 0; block < blocks; ++block, data += VECTORS_PER_BLOCK * WIDTH)
+	{
+		for (int vector = 0; vector < VECTORS_PER_BLOCK; ++vector)
+		{
+			const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + vector * WIDTH));
+			const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+			const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+			for (int channel = 0; channel < CHANNELS; ++channel)
+			{
+				// Values are <= 255, so the signed multiply-add of the masked lanes is exact
+				const __m128i selectedLow = _mm_and_si128(low, maskLow[vector][channel]);
+				const __m128i selectedHigh = _mm_and_si128(high, maskHigh[vector][channel]);
+				acc[channel] = _mm_add_epi32(acc[channel], _mm_madd_epi16(selectedLow, selectedLow));
+				acc[channel] = _mm_add_epi32(acc[channel], _mm_madd_epi16(selectedHigh, selectedHigh));
+			}
+		}
+
+		if ((block + 1) % SQUARED_FLUSH_BLOCKS == 0)
+		{
+			for (int channel = 0; channel < CHANNELS; ++channel)
+			{
+				total[channel] += horizontalSum32(acc[channel]);
+				acc[channel] = zero;
+			}
+		}
+	}
+
+	sums.red += total[0] + horizontalSum32(acc[0]);
+	sums.green += total[1] + horizontalSum32(acc[1]);
+	sums.blue += total[2] + horizontalSum32(acc[2]);
+
+	const int processed = blocks * (WIDTH / stride);
+	sumSquaredScalar(pixels + static_cast<ptrdiff_t>(blocks) * WIDTH, length - processed, stride, sums);
+}
+
+TARGET_SSE2 void addBytesSse2(const uint8_t *bytes, int length, uint16_t *sums)
+{
+	constexpr int WIDTH = 16;
+	const __m128i zero = _mm_setzero_si128();
+
+	int i = 0;
+	for (; i + WIDTH <= length; i += WIDTH)
+	{
+		const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + i));
+		__m128i *low = reinterpret_cast<__m128i *>(sums + i);
+		__m128i *high = reinterpret_cast<__m128i *>(sums + i + WIDTH / 2);
+		_mm_storeu_si128(low, _mm_add_epi16(_mm_loadu_si128(low), _mm_unpacklo_epi8(data, zero)));
+		_mm_storeu_si128(high, _mm_add_epi16(_mm_loadu_si128(high), _mm_unpackhi_epi8(data, zero)));
+	}
+
+	addBytesScalar(bytes + i, length - i, sums + i);
+}
+
+TARGET_AVX2 uint64_t horizontalSum64(__m256i vector)
+{
+	alignas(32) uint64_t lanes[4];
+	_mm256_store_si256(reinterpret_cast<__m256i *>(lanes), vector);
+	return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+TARGET_AVX2 uint64_t horizontalSum32(__m256i vector)
+{
+	alignas(32) uint32_t lanes[8];
+	_mm256_store_si256(reinterpret_cast<__m256i *>(lanes), vector);
+	uint64_t sum = 0;
+	for (const uint32_t lane : lanes)
+	{
+		sum += lane;
+	}
+	return sum;
+}
+
+TARGET_AVX2 void sumAvx2(const ColorRgb *pixels, int length, int stride, Sums &sums)
+{
+	constexpr int WIDTH = 32;
+	if (length <= 0 || !isBlockStride(stride, WIDTH))
+	{
+		sumScalar(pixels, length, stride, sums);
+		return;
+	}
+
+	const int blocks = ((length - 1) * stride + 1) / WIDTH;
+	const ChannelMasks<WIDTH> &masks = channelMasks<WIDTH>(stride);
+
+	__m256i mask[VECTORS_PER_BLOCK][CHANNELS];
+	for (int vector = 0; vector < VECTORS_PER_BLOCK; ++vector)
+	{
+		for (int channel = 0; channel < CHANNELS; ++channel)
+		{
+			mask[vector][channel] = _mm256_load_si256(reinterpret_cast<const __m256i *>(masks.bytes[vector][channel]));
+		}
+	}
+
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i acc[CHANNELS] = { zero, zero, zero };
+
+	const auto *data = reinterpret_cast<const uint8_t *>(pixels);
+	for (int block = 0; block < blocks; ++block, data += VECTORS_PER_BLOCK * WIDTH)
+	{
+		for (int vector = 0; vector < VECTORS_PER_BLOCK; ++vector)
+		{
+			const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + vector * WIDTH));
+			for (int channel = 0; channel < CHANNELS; ++channel)
+			{
+				acc[channel] = _mm256_add_epi64(acc[channel], _mm256_sad_epu8(_mm256_and_si256(bytes, mask[vector][channel]), zero));
+			}
+		}
+	}
+
+	sums.red += horizontalSum64(acc[0]);
+	sums.green += horizontalSum64(acc[1]);
+	sums.blue += horizontalSum64(acc[2]);
+
+	const int processed = blocks * (WIDTH / stride);
+	sumScalar(pixels + static_cast<ptrdiff_t>(blocks) * WIDTH, length - processed, stride, sums);
+}
+
+TARGET_AVX2 void sumSquaredAvx2(const ColorRgb *pixels, int length, int stride, Sums &sums)
+{
+	constexpr int WIDTH = 32;
+	if (length <= 0 || !isBlockStride(stride, WIDTH))
+	{
+		sumSquaredScalar(pixels, length, stride, sums);
+		return;
+	}
+
+	const int blocks = ((length - 1) * stride + 1) / WIDTH;
+	const ChannelMasks<WIDTH> &masks = channelMasks<WIDTH>(stride);
+
+	// Unpacking works per 128-bit lane; widening the masks the same way keeps them aligned to the data
+	__m256i maskLow[VECTORS_PER_BLOCK][CHANNELS];
+	__m256i maskHigh[VECTORS_PER_BLOCK][CHANNELS];
+	for (int vector = 0; vector < VECTORS_PER_BLOCK; ++vector)
+	{
+		for (int channel = 0; channel < CHANNELS; ++channel)
+		{
+			const __m256i mask = _mm256_load_si256(reinterpret_cast<const __m256i *>(masks.bytes[vector][channel]));
+			maskLow[vector][channel] = _mm256_unpacklo_epi8(mask, mask);
+			maskHigh[vector][channel] = _mm256_unpackhi_epi8(mask, mask);
+		}
+	}
+
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i acc[CHANNELS] = { zero, zero, zero };
+	uint64_t total[CHANNELS] = { 0, 0, 0 };
+
+	const auto *data = reinterpret_cast<const uint8_t *>(pixels);
+	for (int block = 0; block < blocks; ++block, data += VECTORS_PER_BLOCK * WIDTH)
+	{
+		for (int vector = 0; vector < VECTORS_PER_BLOCK; ++vector)
+		{
+			const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + vector * WIDTH));
+			const __m256i low = _mm256_unpacklo_epi8(bytes, zero);
+			const __m256i high = _mm256_unpackhi_epi8(bytes, zero);
+			for (int channel = 0; channel < CHANNELS; ++channel)
+			{
+				const __m256i selectedLow = _mm256_and_si256(low, maskLow[vector][channel]);
+				const __m256i selectedHigh = _mm256_and_si256(high, maskHigh[vector][channel]);
+				acc[channel] = _mm256_add_epi32(acc[channel], _mm256_madd_epi16(selectedLow, selectedLow));
+				acc[channel] = _mm256_add_epi32(acc[channel], _mm256_madd_epi16(selectedHigh, selectedHigh));
+			}
+		}
+
+		if ((block + 1) % SQUARED_FLUSH_BLOCKS == 0)
+		{
+			for (int channel = 0; channel < CHANNELS; ++channel)
+			{
+				total[channel] += horizontalSum32(acc[channel]);
+				acc[channel] = zero;
+			}
+		}
+	}
+
+	sums.red += total[0] + horizontalSum32(acc[0]);
+	sums.green += total[1] + horizontalSum32(acc[1]);
+	sums.blue += total[2] + horizontalSum32(acc[2]);
+
+	const int processed = blocks * (WIDTH / stride);
+	sumSquaredScalar(pixels + static_cast<ptrdiff_t>(blocks) * WIDTH, length - processed, stride, sums);
+}
+
+TARGET_AVX2 void addBytesAvx2(const uint8_t *bytes, int length, uint16_t *sums)
+{
+	constexpr int WIDTH = 32;
+
+	int i = 0;
+	for (; i + WIDTH <= length; i += WIDTH)
+	{
+		const __m128i dataLow = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + i));
+		const __m128i dataHigh = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + i + WIDTH / 2));
+		__m256i *low = reinterpret_cast<__m256i *>(sums + i);
+		__m256i *high = reinterpret_cast<__m256i *>(sums + i + WIDTH / 2);
+		_mm256_storeu_si256(low, _mm256_add_epi16(_mm256_loadu_si256(low), _mm256_cvtepu8_epi16(dataLow)));
+		_mm256_storeu_si256(high, _mm256_add_epi16(_mm256_loadu_si256(high), _mm256_cvtepu8_epi16(dataHigh)));
+	}
+
+	addBytesScalar(bytes + i, length - i, sums + i);
+}
+
+#endif // PIXELACCUMULATOR_X86
+
+#ifdef PIXELACCUMULATOR_NEON
+
+// Flush the 32-bit lanes before they could overflow
+constexpr int NEON_FLUSH_BLOCKS = 4096;
+
+///
+/// Byte mask selecting the sampled pixels out of 16 deinterleaved pixels
+///
+uint8x16_t sampleMask(int stride)
+{
+	alignas(16) uint8_t bytes[16];
+	for (int pixel = 0; pixel < 16; ++pixel)
+	{
+		bytes[pixel] = (pixel % stride == 0) ? 0xFF : 0x00;
+	}
+	return vld1q_u8(bytes);
+}
+
+uint64_t horizontalSum(uint32x4_t vector)
+{
+	const uint64x2_t pairs = vpaddlq_u32(vector);
+	return vgetq_lane_u64(pairs, 0) + vgetq_lane_u64(pairs, 1);
+}
+
+void sumNeon(const ColorRgb *pixels, int length, int stride, Sums &sums)
+{
+	constexpr int WIDTH = 16;
+	if (length <= 0 || !isBlockStride(stride, WIDTH))
+	{
+		sumScalar(pixels, length, stride, sums);
+		return;
+	}
+
+	const int blocks = ((length - 1) * stride + 1) / WIDTH;
+	const uint8x16_t mask = sampleMask(stride);
+
+	uint32x4_t acc[CHANNELS] = { vdupq_n_u32(0), vdupq_n_u32(0), vdupq_n_u32(0) };
+	uint64_t total[CHANNELS] = { 0, 0, 0 };
+
+	const auto *data = reinterpret_cast<const uint8_t *>(pixels);
+	for (int block = 0; block < blocks; ++block, data += VECTORS_PER_BLOCK * WIDTH)
+	{
+		// Load and deinterleave 16 pixels into one vector per channel
+		const uint8x16x3_t rgb = vld3q_u8(data);
+		for (int channel = 0; channel < CHANNELS; ++channel)
+		{
+			acc[channel] = vpadalq_u16(acc[channel], vpaddlq_u8(vandq_u8(rgb.val[channel], mask)));
+		}
+
+		if ((block + 1) % NEON_FLUSH_BLOCKS == 0)
+		{
+			for (int channel = 0; channel < CHANNELS; ++channel)
+			{
+				total[channel] += horizontalSum(acc[channel]);
+				acc[channel] = vdupq_n_u32(0);
+			}
+		}
+	}
+
+	sums.red += total[0] + horizontalSum(acc[0]);
+	sums.green += total[1] + horizontalSum(acc[1]);
+	sums.blue += total[2] + horizontalSum(acc[2]);
+
+	const int processed = blocks * (WIDTH / stride);
+	sumScalar(pixels + static_cast<ptrdiff_t>(blocks) * WIDTH, length - processed, stride, sums);
+}
+
+void sumSquaredNeon(const ColorRgb *pixels, int length, int stride, Sums &sums)
+{
+	constexpr int WIDTH = 16;
+	if (length <= 0 || !isBlockStride(stride, WIDTH))
+	{
+		sumSquaredScalar(pixels, length, stride, sums);
+		return;
+	}
+
+	const int blocks = ((length - 1) * stride + 1) / WIDTH;
+	const uint8x16_t mask = sampleMask(stride);
+
+	uint32x4_t acc[CHANNELS] = { vdupq_n_u32(0), vdupq_n_u32(0), vdupq_n_u32(0) };
+	uint64_t total[CHANNELS] = { 0, 0, 0 };
+
+	const auto *data = reinterpret_cast<const uint8_t *>(pixels);
+	for (int block = 0; block < blocks; ++block, data += VECTORS_PER_BLOCK * WIDTH)
+	{
+		const uint8x16x3_t rgb = vld3q_u8(data);
+		for (int channel = 0; channel < CHANNELS; ++channel)
+		{
+			const uint8x16_t selected = vandq_u8(rgb.val[channel], mask);
+			const uint8x8_t low = vget_low_u8(selected);
+			const uint8x8_t high = vget_high_u8(selected);
+			acc[channel] = vpadalq_u16(acc[channel], vmull_u8(low, low));
+			acc[channel] = vpadalq_u16(acc[channel], vmull_u8(high, high));
+		}
+
+		if ((block + 1) % NEON_FLUSH_BLOCKS == 0)
+		{
+			for (int channel = 0; channel < CHANNELS; ++channel)
+			{
+				total[channel] += horizontalSum(acc[channel]);
+				acc[channel] = vdupq_n_u32(0);
+			}
+		}
+	}
+
+	sums.red += total[0] + horizontalSum(acc[0]);
+	sums.green += total[1] + horizontalSum(acc[1]);
+	sums.blue += total[2] + horizontalSum(acc[2]);
+
+	const int processed = blocks * (WIDTH / stride);
+	sumSquaredScalar(pixels + static_cast<ptrdiff_t>(blocks) * WIDTH, length - processed, stride, sums);
+}
+
+void addBytesNeon(const uint8_t *bytes, int length, uint16_t *sums)
+{
+	constexpr int WIDTH = 16;
+
+	int i = 0;
+	for (; i + WIDTH <= length; i += WIDTH)
+	{
+		const uint8x16_t data = vld1q_u8(bytes + i);
+		vst1q_u16(sums + i, vaddw_u8(vld1q_u16(sums + i), vget_low_u8(data)));
+		vst1q_u16(sums + i + WIDTH / 2, vaddw_u8(vld1q_u16(sums + i + WIDTH / 2), vget_high_u8(data)));
+	}
+
+	addBytesScalar(bytes + i, length - i, sums + i);
+}
+
+#endif // PIXELACCUMULATOR_NEON
+
+struct Kernels
+{
+	Implementation implementation;
+	AccumulateFunction sum;
+	AccumulateFunction sumSquared;
+	AddBytesFunction addBytes;
+};
+
+const Kernels SCALAR_KERNELS { Implementation::SCALAR, sumScalar, sumSquaredScalar, addBytesScalar };
+#ifdef PIXELACCUMULATOR_X86
+const Kernels SSE2_KERNELS { Implementation::SSE2, sumSse2, sumSquaredSse2, addBytesSse2 };
+const Kernels AVX2_KERNELS { Implementation::AVX2, sumAvx2, sumSquaredAvx2, addBytesAvx2 };
+#endif
+#ifdef PIXELACCUMULATOR_NEON
+const Kernels NEON_KERNELS { Implementation::NEON, sumNeon, sumSquaredNeon, addBytesNeon };
+#endif
+
+const Kernels *kernelsFor(Implementation implementation)
+{
+	if (!PixelAccumulator::isSupported(implementation))
+	{
+		return nullptr;
+	}
+
+	switch (implementation)
+	{
+#ifdef PIXELACCUMULATOR_X86
+	case Implementation::SSE2:
+		return &SSE2_KERNELS;
+	case Implementation::AVX2:
+		return &AVX2_KERNELS;
+#endif
+#ifdef PIXELACCUMULATOR_NEON
+	case Implementation::NEON:
+		return &NEON_KERNELS;
+#endif
+	case Implementation::SCALAR:
+		return &SCALAR_KERNELS;
+	default:
+		return nullptr;
+	}
+}
+
+const Kernels *bestKernels()
+{
+	for (const Implementation implementation : { Implementation::AVX2, Implementation::NEON, Implementation::SSE2 })
+	{
+		if (const Kernels *kernels = kernelsFor(implementation))
+		{
+			return kernels;
+		}
+	}
+	return &SCALAR_KERNELS;
+}
+
+std::atomic<const Kernels *> &activeKernels()
+{
+	static std::atomic<const Kernels *> kernels { bestKernels() };
+	return kernels;
+}
+
+} // namespace
+
+void PixelAccumulator::sum(const ColorRgb *pixels, int length, int stride, Sums &sums)
+{
+	activeKernels().load(std::memory_order_relaxed)->sum(pixels, length, stride, sums);
+}
+
+void PixelAccumulator::sumSquared(const ColorRgb *pixels, int length, int stride, Sums &sums)
+{
+	activeKernels().load(std::memory_order_relaxed)->sumSquared(pixels, length, stride, sums);
+}
+
+void PixelAccumulator::addBytes(const uint8_t *bytes, int length, uint16_t *sums)
+{
+	activeKernels().load(std::memory_order_relaxed)->addBytes(bytes, length, sums);
+}
+
+PixelAccumulator::Implementation PixelAccumulator::implementation()
+{
+	return activeKernels().load(std::memory_order_relaxed)->implementation;
+}
+
+bool PixelAccumulator::setImplementation(Implementation implementation)
+{
+	const Kernels *kernels = kernelsFor(implementation);
+	if (kernels == nullptr)
+	{
+		return false;
+	}
+	activeKernels().store(kernels, std::memory_order_relaxed);
+	return true;
+}
+
+bool PixelAccumulator::isSupported(Implementation implementation)
+{
+	switch (implementation)
+	{
+	case Implementation::SCALAR:
+		return true;
+#ifdef PIXELACCUMULATOR_X86
+	case Implementation::SSE2:
+		return CpuFeatures::hasSse2();
+	case Implementation::AVX2:
+		return CpuFeatures::hasAvx2();
+#endif
+#ifdef PIXELACCUMULATOR_NEON
+	case Implementation::NEON:
+		return CpuFeatures::hasNeon();
+#endif
+	default:
+		return false;
+	}
+}
+
+const char *PixelAccumulator::implementationToString(Implementation implementation)
+{
+	switch (implementation)
+	{
+	case Implementation::SSE2:
+		return "SSE2";
+	case Implementation::AVX2:
+		return "AVX2";
+	case Implementation::NEON:
+		return "NEON";
+	case Implementation::SCALAR:
+	default:
+		return "Scalar";
+	}
+}
@@ -0,0 +1,147 @@
+#include <utils/WorkerPool.h>
+
+// STL includes
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
+#include <QWaitCondition>
+
+namespace {
+
+///
+/// A loop to be processed in chunks by the calling thread and the pool's workers
+///
+class Job
+{
+public:
+	Job(int count, int chunkSize, const std::function<void(int, int)>& function)
+		: _count(count)
+		, _chunkSize(chunkSize)
+		, _function(function)
+		, _nextIndex(0)
+		, _pendingChunks((count + chunkSize - 1) / chunkSize)
+	{
+	}
+
+	///
+	/// Processes chunks until all of them have been claimed
+	///
+	void work()
+	{
+		for (;;)
+		{
+			const int begin = _nextIndex.fetch_add(_chunkSize);
+			if (begin >= _count)
+			{
+				return;
+			}
+
+			_function(begin, std::min(begin + _chunkSize, _count));
+
+			if (_pendingChunks.fetch_sub(1) == 1)
+			{
+				QMutexLocker locker(&_mutex);
+				_finished.wakeAll();
+			}
+		}
+	}
+
+	///
+	/// Blocks until all chunks have been processed
+	///
+	void wait()
+	{
+		QMutexLocker locker(&_mutex);
+		while (_pendingChunks.load() > 0)
+		{
+			_finished.wait(&_mutex);
+		}
+	}
+
+private:
+	const int _count;
+	const int _chunkSize;
+	const std::function<void(int, int)> _function;
+
+	std::atomic<int> _nextIndex;
+	std::atomic<int> _pendingChunks;
+
+	QMutex _mutex;
+	QWaitCondition _finished;
+};
+
+class JobRunnable : public QRunnable
+{
+public:
+	explicit JobRunnable(std::shared_ptr<Job> job)
+		: _job(std::move(job))
+	{
+		setAutoDelete(true);
+	}
+
+	void run() override
+	{
+		_job->work();
+	}
+
+private:
+	// Keeps the job alive, if the runnable starts after the loop has completed
+	std::shared_ptr<Job> _job;
+};
+
+} // namespace
+
+WorkerPool& WorkerPool::instance()
+{
+	static WorkerPool pool;
+	return pool;
+}
+
+WorkerPool::WorkerPool()
+	: _helperCount(std::max(0, QThread::idealThreadCount() - 1))
+{
+	// The calling thread takes part in the processing, a pool always runs at least one thread
+	_pool.setMaxThreadCount(std::max(1, _helperCount));
+}
+
+WorkerPool::~WorkerPool()
+{
+	_pool.waitForDone();
+}
+
+int WorkerPool::threadCount() const
+{
+	return _helperCount + 1;
+}
+
+void WorkerPool::run(int count, int chunkSize, const std::function<void(int begin, int end)>& function)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	chunkSize = std::max(1, chunkSize);
+	const int chunks = (count + chunkSize - 1) / chunkSize;
+	if (chunks == 1 || _helperCount == 0)
+	{
+		function(0, count);
+		return;
+	}
+
+	auto job = std::make_shared<Job>(count, chunkSize, function);
+
+	const int helpers = std::min(chunks - 1, _helperCount);
+	for (int i = 0; i < helpers; ++i)
+	{
+		_pool.start(new JobRunnable(job));
+	}
+
+	job->work();
+	job->wait();
+}
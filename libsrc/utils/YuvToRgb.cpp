@@ -0,0 +1,352 @@
+#include <utils/YuvToRgb.h>
+#include <utils/ColorSys.h>
+#include <utils/CpuFeatures.h>
+
+// STL includes
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define YUVTORGB_X86
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define YUVTORGB_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(YUVTORGB_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#endif
+
+namespace {
+
+using Implementation = YuvToRgb::Implementation;
+using ConvertFunction = void (*)(const uint8_t *, const uint8_t *, const uint8_t *, int, ColorRgb *);
+
+void convertScalar(const uint8_t *y, const uint8_t *u, const uint8_t *v, int length, ColorRgb *rgb)
+{
+	for (int x = 0; x < length; ++x)
+	{
+		ColorSys::yuv2rgb(y[x], u[x], v[x], rgb[x].red, rgb[x].green, rgb[x].blue);
+	}
+}
+
+#if defined(YUVTORGB_X86) || defined(YUVTORGB_NEON)
+
+// Coefficients of ColorSys::yuv2rgb applied to c = y - 16, d = u - 128, e = v - 128
+constexpr int16_t COEFFICIENT_Y = 298;
+constexpr int16_t COEFFICIENT_V_RED = 409;
+constexpr int16_t COEFFICIENT_U_GREEN = -100;
+constexpr int16_t COEFFICIENT_V_GREEN = -208;
+constexpr int16_t COEFFICIENT_U_BLUE = 516;
+constexpr int16_t ROUNDING = 128;
+
+///
+/// Interleaves the converted channels of a block into packed pixels
+///
+inline void interleave(const uint8_t *red, const uint8_t *green, const uint8_t *blue, int length, ColorRgb *rgb)
+{
+	for (int x = 0; x < length; ++x)
+	{
+		rgb[x].red = red[x];
+		rgb[x].green = green[x];
+		rgb[x].blue = blue[x];
+	}
+}
+
+#endif
+
+#ifdef YUVTORGB_X86
+
+///
+/// Pair of 16-bit coefficients for _mm_madd_epi16, the low one applies to the even, the high one to the odd lanes
+///
+constexpr int coefficientPair(int16_t low, int16_t high)
+{
+	return static_cast<int>((static_cast<uint32_t>(static_cast<uint16_t>(high)) << 16) | static_cast<uint16_t>(low));
+}
+
+TARGET_SSE2 void convertSse2(const uint8_t *y, const uint8_t *u, const uint8_t *v, int length, ColorRgb *rgb)
+{
+	constexpr int WIDTH = 8;
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i one = _mm_set1_epi16(1);
+	const __m128i lumaOffset = _mm_set1_epi16(16);
+	const __m128i chromaOffset = _mm_set1_epi16(128);
+	const __m128i rounding = _mm_set1_epi32(ROUNDING);
+
+	// The products are summed pairwise into exact 32-bit lanes; pairing e with 1 adds the rounding for green
+	const __m128i redCE = _mm_set1_epi32(coefficientPair(COEFFICIENT_Y, COEFFICIENT_V_RED));
+	const __m128i greenCD = _mm_set1_epi32(coefficientPair(COEFFICIENT_Y, COEFFICIENT_U_GREEN));
+	const __m128i greenE1 = _mm_set1_epi32(coefficientPair(COEFFICIENT_V_GREEN, ROUNDING));
+	const __m128i blueCD = _mm_set1_epi32(coefficientPair(COEFFICIENT_Y, COEFFICIENT_U_BLUE));
+
+	alignas(16) uint8_t red[16];
+	alignas(16) uint8_t green[16];
+	alignas(16) uint8_t blue[16];
+
+	int x = 0;
+	for (; x + WIDTH <= length; x += WIDTH)
+	{
+		const __m128i c = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(y + x)), zero), lumaOffset);
+		const __m128i d = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(u + x)), zero), chromaOffset);
+		const __m128i e = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(v + x)), zero), chromaOffset);
+
+		const __m128i ceLow = _mm_unpacklo_epi16(c, e);
+		const __m128i ceHigh = _mm_unpackhi_epi16(c, e);
+		const __m128i cdLow = _mm_unpacklo_epi16(c, d);
+		const __m128i cdHigh = _mm_unpackhi_epi16(c, d);
+		const __m128i e1Low = _mm_unpacklo_epi16(e, one);
+		const __m128i e1High = _mm_unpackhi_epi16(e, one);
+
+		const __m128i redLow = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(ceLow, redCE), rounding), 8);
+		const __m128i redHigh = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(ceHigh, redCE), rounding), 8);
+		const __m128i greenLow = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(cdLow, greenCD), _mm_madd_epi16(e1Low, greenE1)), 8);
+		const __m128i greenHigh = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(cdHigh, greenCD), _mm_madd_epi16(e1High, greenE1)), 8);
+		const __m128i blueLow = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(cdLow, blueCD), rounding), 8);
+		const __m128i blueHigh = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(cdHigh, blueCD), rounding), 8);
+
+		// Saturating packs clamp the results to [0, 255] like ColorSys::yuv2rgb
+		_mm_storel_epi64(reinterpret_cast<__m128i *>(red), _mm_packus_epi16(_mm_packs_epi32(redLow, redHigh), zero));
+		_mm_storel_epi64(reinterpret_cast<__m128i *>(green), _mm_packus_epi16(_mm_packs_epi32(greenLow, greenHigh), zero));
+		_mm_storel_epi64(reinterpret_cast<__m128i *>(blue), _mm_packus_epi16(_mm_packs_epi32(blueLow, blueHigh), zero));
+
+		interleave(red, green, blue, WIDTH, rgb + x);
+	}
+
+	convertScalar(y + x, u + x, v + x, length - x, rgb + x);
+}
+
+TARGET_AVX2 __m256i packChannel(__m256i low, __m256i high)
+{
+	// Packing works per 128-bit lane, gather the two 8-byte results into the low half
+	const __m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(_mm256_srai_epi32(low, 8), _mm256_srai_epi32(high, 8)), _mm256_setzero_si256());
+	return _mm256_permute4x64_epi64(packed, 0xD8);
+}
+
+TARGET_AVX2 void convertAvx2(const uint8_t *y, const uint8_t *u, const uint8_t *v, int length, ColorRgb *rgb)
+{
+	constexpr int WIDTH = 16;
+
+	const __m256i one = _mm256_set1_epi16(1);
+	const __m256i lumaOffset = _mm256_set1_epi16(16);
+	const __m256i chromaOffset = _mm256_set1_epi16(128);
+	const __m256i rounding = _mm256_set1_epi32(ROUNDING);
+
+	const __m256i redCE = _mm256_set1_epi32(coefficientPair(COEFFICIENT_Y, COEFFICIENT_V_RED));
+	const __m256i greenCD = _mm256_set1_epi32(coefficientPair(COEFFICIENT_Y, COEFFICIENT_U_GREEN));
+	const __m256i greenE1 = _mm256_set1_epi32(coefficientPair(COEFFICIENT_V_GREEN, ROUNDING));
+	const __m256i blueCD = _mm256_set1_epi32(coefficientPair(COEFFICIENT_Y, COEFFICIENT_U_BLUE));
+
+	alignas(16) uint8_t red[16];
+	alignas(16) uint8_t green[16];
+	alignas(16) uint8_t blue[16];
+
+	int x = 0;
+	for (; x + WIDTH <= length; x += WIDTH)
+	{
+		const __m256i c = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(y + x))), lumaOffset);
+		const __m256i d = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(u + x))), chromaOffset);
+		const __m256i e = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(v + x))), chromaOffset);
+
+		// Unpacking works per 128-bit lane as well, packing the low and high parts restores the pixel order
+		const __m256i ceLow = _mm256_unpacklo_epi16(c, e);
+		const __m256i ceHigh = _mm256_unpackhi_epi16(c, e);
+		const __m256i cdLow = _mm256_unpacklo_epi16(c, d);
+		const __m256i cdHigh = _mm256_unpackhi_epi16(c, d);
+		const __m256i e1Low = _mm256_unpacklo_epi16(e, one);
+		const __m256i e1High = _mm256_unpackhi_epi16(e, one);
+
+		const __m256i redPixels = packChannel(
+			_mm256_add_epi32(_mm256_madd_epi16(ceLow, redCE), rounding),
+			_mm256_add_epi32(_mm256_madd_epi16(ceHigh, redCE), rounding));
+		const __m256i greenPixels = packChannel(
+			_mm256_add_epi32(_mm256_madd_epi16(cdLow, greenCD), _mm256_madd_epi16(e1Low, greenE1)),
+			_mm256_add_epi32(_mm256_madd_epi16(cdHigh, greenCD), _mm256_madd_epi16(e1High, greenE1)));
+		const __m256i bluePixels = packChannel(
+			_mm256_add_epi32(_mm256_madd_epi16(cdLow, blueCD), rounding),
+			_mm256_add_epi32(_mm256_madd_epi16(cdHigh, blueCD), rounding));
+
+		_mm_store_si128(reinterpret_cast<__m128i *>(red), _mm256_castsi256_si128(redPixels));
+		_mm_store_si128(reinterpret_cast<__m128i *>(green), _mm256_castsi256_si128(greenPixels));
+		_mm_store_si128(reinterpret_cast<__m128i *>(blue), _mm256_castsi256_si128(bluePixels));
+
+		interleave(red, green, blue, WIDTH, rgb + x);
+	}
+
+	convertScalar(y + x, u + x, v + x, length - x, rgb + x);
+}
+
+#endif // YUVTORGB_X86
+
+#ifdef YUVTORGB_NEON
+
+///
+/// Shifts the sums right by 8 bits and narrows them with saturation to [0, 255] like ColorSys::yuv2rgb
+///
+inline uint8x8_t narrowChannel(int32x4_t low, int32x4_t high)
+{
+	return vqmovun_s16(vcombine_s16(vqshrn_n_s32(low, 8), vqshrn_n_s32(high, 8)));
+}
+
+void convertNeon(const uint8_t *y, const uint8_t *u, const uint8_t *v, int length, ColorRgb *rgb)
+{
+	constexpr int WIDTH = 8;
+
+	const int32x4_t rounding = vdupq_n_s32(ROUNDING);
+
+	int x = 0;
+	for (; x + WIDTH <= length; x += WIDTH)
+	{
+		// Widening subtraction wraps modulo 2^16, reinterpreted as signed the differences are exact
+		const int16x8_t c = vreinterpretq_s16_u16(vsubl_u8(vld1_u8(y + x), vdup_n_u8(16)));
+		const int16x8_t d = vreinterpretq_s16_u16(vsubl_u8(vld1_u8(u + x), vdup_n_u8(128)));
+		const int16x8_t e = vreinterpretq_s16_u16(vsubl_u8(vld1_u8(v + x), vdup_n_u8(128)));
+
+		const int32x4_t lumaLow = vaddq_s32(vmull_n_s16(vget_low_s16(c), COEFFICIENT_Y), rounding);
+		const int32x4_t lumaHigh = vaddq_s32(vmull_n_s16(vget_high_s16(c), COEFFICIENT_Y), rounding);
+
+		uint8x8x3_t pixels;
+		pixels.val[0] = narrowChannel(
+			vmlal_n_s16(lumaLow, vget_low_s16(e), COEFFICIENT_V_RED),
+			vmlal_n_s16(lumaHigh, vget_high_s16(e), COEFFICIENT_V_RED));
+		pixels.val[1] = narrowChannel(
+			vmlal_n_s16(vmlal_n_s16(lumaLow, vget_low_s16(d), COEFFICIENT_U_GREEN), vget_low_s16(e), COEFFICIENT_V_GREEN),
+			vmlal_n_s16(vmlal_n_s16(lumaHigh, vget_high_s16(d), COEFFICIENT_U_GREEN), vget_high_s16(e), COEFFICIENT_V_GREEN));
+		pixels.val[2] = narrowChannel(
+			vmlal_n_s16(lumaLow, vget_low_s16(d), COEFFICIENT_U_BLUE),
+			vmlal_n_s16(lumaHigh, vget_high_s16(d), COEFFICIENT_U_BLUE));
+
+		// Store interleaved as packed RGB24 pixels
+		vst3_u8(reinterpret_cast<uint8_t *>(rgb + x), pixels);
+	}
+
+	convertScalar(y + x, u + x, v + x, length - x, rgb + x);
+}
+
+#endif // YUVTORGB_NEON
+
+struct Kernels
+{
+	Implementation implementation;
+	ConvertFunction convert;
+};
+
+const Kernels SCALAR_KERNELS { Implementation::SCALAR, convertScalar };
+#ifdef YUVTORGB_X86
+const Kernels SSE2_KERNELS { Implementation::SSE2, convertSse2 };
+const Kernels AVX2_KERNELS { Implementation::AVX2, convertAvx2 };
+#endif
+#ifdef YUVTORGB_NEON
+const Kernels NEON_KERNELS { Implementation::NEON, convertNeon };
+#endif
+
+const Kernels *kernelsFor(Implementation implementation)
+{
+	if (!YuvToRgb::isSupported(implementation))
+	{
+		return nullptr;
+	}
+
+	switch (implementation)
+	{
+#ifdef YUVTORGB_X86
+	case Implementation::SSE2:
+		return &SSE2_KERNELS;
+	case Implementation::AVX2:
+		return &AVX2_KERNELS;
+#endif
+#ifdef YUVTORGB_NEON
+	case Implementation::NEON:
+		return &NEON_KERNELS;
+#endif
+	case Implementation::SCALAR:
+		return &SCALAR_KERNELS;
+	default:
+		return nullptr;
+	}
+}
+
+const Kernels *bestKernels()
+{
+	for (const Implementation implementation : { Implementation::AVX2, Implementation::NEON, Implementation::SSE2 })
+	{
+		if (const Kernels *kernels = kernelsFor(implementation))
+		{
+			return kernels;
+		}
+	}
+	return &SCALAR_KERNELS;
+}
+
+std::atomic<const Kernels *> &activeKernels()
+{
+	static std::atomic<const Kernels *> kernels { bestKernels() };
+	return kernels;
+}
+
+} // namespace
+
+void YuvToRgb::convert(const uint8_t *y, const uint8_t *u, const uint8_t *v, int length, ColorRgb *rgb)
+{
+	activeKernels().load(std::memory_order_relaxed)->convert(y, u, v, length, rgb);
+}
+
+YuvToRgb::Implementation YuvToRgb::implementation()
+{
+	return activeKernels().load(std::memory_order_relaxed)->implementation;
+}
+
+bool YuvToRgb::setImplementation(Implementation implementation)
+{
+	const Kernels *kernels = kernelsFor(implementation);
+	if (kernels == nullptr)
+	{
+		return false;
+	}
+	activeKernels().store(kernels, std::memory_order_relaxed);
+	return true;
+}
+
+bool YuvToRgb::isSupported(Implementation implementation)
+{
+	switch (implementation)
+	{
+	case Implementation::SCALAR:
+		return true;
+#ifdef YUVTORGB_X86
+	case Implementation::SSE2:
+		return CpuFeatures::hasSse2();
+	case Implementation::AVX2:
+		return CpuFeatures::hasAvx2();
+#endif
+#ifdef YUVTORGB_NEON
+	case Implementation::NEON:
+		return CpuFeatures::hasNeon();
+#endif
+	default:
+		return false;
+	}
+}
+
+const char *YuvToRgb::implementationToString(Implementation implementation)
+{
+	switch (implementation)
+	{
+	case Implementation::SSE2:
+		return "SSE2";
+	case Implementation::AVX2:
+		return "AVX2";
+	case Implementation::NEON:
+		return "NEON";
+	case Implementation::SCALAR:
+	default:
+		return "Scalar";
+	}
+}
@@ -0,0 +1,93 @@
+// STL includes
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+// Utils includes
+#include <utils/ColorRgb.h>
+
+// Hyperion includes
+#include <hyperion/ColorAdjustment.h>
+#include <hyperion/ColorAdjustmentLut.h>
+
+namespace {
+
+/// Every STEP-th channel value is compared (the exact OKHSV path is too slow for the full cube)
+constexpr int STEP = 3;
+
+///
+/// Compares the table walk to the exact calculation
+///
+/// @return The maximum deviation per channel
+///
+int maxError(ColorAdjustmentLut& lut)
+{
+	int maxError = 0;
+	for (int red = 0; red <= UINT8_MAX; red += STEP)
+	{
+		for (int green = 0; green <= UINT8_MAX; green += STEP)
+		{
+			for (int blue = 0; blue <= UINT8_MAX; blue += STEP)
+			{
+				ColorRgb exact(static_cast<uint8_t>(red), static_cast<uint8_t>(green), static_cast<uint8_t>(blue));
+				ColorRgb interpolated = exact;
+				lut.applyExact(exact);
+				lut.apply(interpolated);
+
+				maxError = std::max({ maxError,
+									  std::abs(exact.red - interpolated.red),
+									  std::abs(exact.green - interpolated.green),
+									  std::abs(exact.blue - interpolated.blue) });
+			}
+		}
+	}
+	return maxError;
+}
+
+bool check(const char* name, ColorAdjustmentLut& lut, bool settingsChanged = true)
+{
+	const bool rebuilt = lut.update();
+	const int error = maxError(lut);
+	const bool passed = rebuilt == settingsChanged && error <= ColorAdjustmentLut::MAX_ERROR;
+
+	std::cout << name << ": max error " << error << (lut.coversOkhsv() ? " (OKHSV in table)" : "")
+			  << (rebuilt == settingsChanged ? "" : " - table rebuild not as expected")
+			  << (passed ? "" : " - FAILED") << '\n';
+	return passed;
+}
+
+}
+
+int main()
+{
+	ColorAdjustment adjustment;
+	adjustment._id = "default";
+	ColorAdjustmentLut lut(adjustment);
+
+	int failures = 0;
+	failures += check("Default", lut) ? 0 : 1;
+	failures += check("Unchanged settings", lut, false) ? 0 : 1;
+
+	adjustment._rgbTransform.setGamma(0.5, 1.0, 4.0);
+	failures += check("Gamma 0.5/1.0/4.0", lut) ? 0 : 1;
+
+	adjustment._rgbTransform.setGamma(2.2, 2.2, 2.2);
+	adjustment._rgbRedAdjustment.setAdjustment(255, 40, 0);
+	adjustment._rgbCyanAdjustment.setAdjustment(0, 200, 255);
+	adjustment._rgbWhiteAdjustment.setAdjustment(255, 230, 200);
+	adjustment._rgbTransform.setBrightness(60);
+	adjustment._rgbTransform.setTemperature(4500);
+	failures += check("Channel adjustments, brightness, temperature", lut) ? 0 : 1;
+
+	adjustment._okhsvTransform.setSaturationGain(0.6);
+	adjustment._okhsvTransform.setBrightnessGain(0.8);
+	failures += check("OKHSV saturation 0.6, brightness 0.8", lut) ? 0 : 1;
+
+	// Distorts colors close to gray too much to be interpolated, OKHSV is calculated exactly
+	adjustment._okhsvTransform.setSaturationGain(2.0);
+	adjustment._okhsvTransform.setBrightnessGain(1.0);
+	failures += check("OKHSV saturation 2.0", lut) ? 0 : 1;
+
+	std::cout << (failures == 0 ? "All tables within the error bound" : "Tables exceed the error bound") << '\n';
+	return failures == 0 ? 0 : 1;
+}
@@ -7,6 +7,7 @@
 // Hyperion includes
 #include <utils/hyperion.h>
 #include <hyperion/ImageToLedsMap.h>
+#include <hyperion/ImageProcessor.h>
 
 int main()
 {
@@ -43,5 +44,53 @@ int main()
 	}
 	std::cout << "]" << '\n';
 
+	// Only the LEDs of changed blocks are recomputed, the result has to match a full calculation
+	Image<ColorRgb> changedImage = image;
+	for (int y = 0; y < 8; ++y)
+	{
+		for (int x = 0; x < 20; ++x)
+		{
+			changedImage(x, y) = ColorRgb{255, 0, 128};
+		}
+	}
+
+	QVector<ColorRgb> trackedColors(ledString.leds().size());
+	map.getMeanLedColor(changedImage, trackedColors);
+
+	hyperion::ImageToLedsMap const referenceMap(log, 64, 64, 0, 0, ledString.leds());
+	QVector<ColorRgb> referenceColors(ledString.leds().size());
+	referenceMap.getMeanLedColor(changedImage, referenceColors);
+
+	if (trackedColors != referenceColors || trackedColors == ledColors)
+	{
+		std::cerr << "LED colors of the changed image differ from a full calculation" << '\n';
+		return 1;
+	}
+
+	// Processing the same image again refines the dominant colors, until the clusters converged
+	hyperion::ImageToLedsMap const kmeansMap(log, 64, 64, 0, 0, ledString.leds(), 0, 4);
+	QVector<ColorRgb> kmeansColors(ledString.leds().size());
+	for (int pass = 0; pass < 16 && (pass == 0 || !kmeansMap.isKMeansConverged()); ++pass)
+	{
+		kmeansMap.getDominantAdvLedColor(changedImage, kmeansColors);
+	}
+
+	QVector<ColorRgb> settledColors(ledString.leds().size());
+	kmeansMap.getDominantAdvLedColor(changedImage, settledColors);
+	if (!kmeansMap.isKMeansConverged() || settledColors != kmeansColors)
+	{
+		std::cerr << "Dominant colors of the same image did not settle" << '\n';
+		return 1;
+	}
+
+	// The LED colors are only shared by mappings of the same accuracy
+	const QByteArray key = ImageProcessor::mappingKey(64, 64, 0, 0, 1, 0, ledString.leds());
+	if (key != ImageProcessor::mappingKey(64, 64, 0, 0, 1, 0, ledString.leds())
+		|| key == ImageProcessor::mappingKey(64, 64, 0, 0, 1, 2, ledString.leds()))
+	{
+		std::cerr << "Mapping key does not follow the accuracy level" << '\n';
+		return 1;
+	}
+
 	return 0;
 }
@@ -0,0 +1,608 @@
+// STL includes
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Utils includes
+#include <utils/ColorRgb.h>
+#include <utils/ColorSys.h>
+#include <utils/Image.h>
+#include <utils/ImageResampler.h>
+#include <utils/PixelFormat.h>
+#include <utils/VideoMode.h>
+#include <utils/YuvToRgb.h>
+
+namespace {
+
+struct Frame
+{
+	int width;
+	int height;
+	size_t lineLength;
+	std::vector<uint8_t> data;
+};
+
+bool isDecoded(PixelFormat pixelFormat)
+{
+	return pixelFormat != PixelFormat::MJPEG && pixelFormat != PixelFormat::P030 && pixelFormat != PixelFormat::NO_CHANGE;
+}
+
+int bytesPerPixel(PixelFormat pixelFormat)
+{
+	switch (pixelFormat)
+	{
+	case PixelFormat::YUYV:
+	case PixelFormat::UYVY:
+	case PixelFormat::BGR16:
+		return 2;
+	case PixelFormat::RGB24:
+	case PixelFormat::BGR24:
+		return 3;
+	case PixelFormat::RGB32:
+	case PixelFormat::BGR32:
+		return 4;
+	default:
+		return 1;
+	}
+}
+
+///
+/// Frame of the given format with padded lines, filled with random data
+///
+Frame createFrame(PixelFormat pixelFormat, int width, int height, std::mt19937& generator)
+{
+	Frame frame { width, height, static_cast<size_t>(width * bytesPerPixel(pixelFormat) + 8), {} };
+
+	size_t size = frame.lineLength * height;
+	switch (pixelFormat)
+	{
+	case PixelFormat::NV12:
+	case PixelFormat::NV21:
+		size += frame.lineLength * (height / 2);
+		break;
+	case PixelFormat::I420:
+		size += width * height / 2;
+		break;
+	case PixelFormat::I422:
+		size += width * height;
+		break;
+	default:
+		break;
+	}
+
+	std::uniform_int_distribution<int> distribution(0, 255);
+	frame.data.resize(size);
+	for (uint8_t& byte : frame.data)
+	{
+		byte = static_cast<uint8_t>(distribution(generator));
+	}
+	return frame;
+}
+
+using Channels = std::array<uint32_t, 3>;
+
+///
+/// Channels of a source pixel as read by ImageResampler (Y, U, V for YUV formats, R, G, B otherwise)
+///
+Channels referenceChannels(const Frame& frame, PixelFormat pixelFormat, int xSource, int ySource)
+{
+	const uint8_t* data = frame.data.data();
+	const size_t lineLength = frame.lineLength;
+	const int width = frame.width;
+	const int height = frame.height;
+
+	switch (pixelFormat)
+	{
+	case PixelFormat::UYVY:
+	{
+		size_t index = lineLength * ySource + (xSource << 1);
+		uint8_t y = data[index+1];
+		uint8_t u = ((xSource&1) == 0) ? data[index  ] : data[index-2];
+		uint8_t v = ((xSource&1) == 0) ? data[index+2] : data[index  ];
+		return { y, u, v };
+	}
+	case PixelFormat::YUYV:
+	{
+		size_t index = lineLength * ySource + (xSource << 1);
+		uint8_t y = data[index];
+		uint8_t u = ((xSource&1) == 0) ? data[index+1] : data[index-1];
+		uint8_t v = ((xSource&1) == 0) ? data[index+3] : data[index+1];
+		return { y, u, v };
+	}
+	case PixelFormat::BGR16:
+	{
+		size_t index = lineLength * ySource + (xSource << 1);
+		return {
+			static_cast<uint8_t>(data[index+1] & 0xF8),
+			static_cast<uint8_t>((((data[index+1] & 0x7) << 3) | (data[index] & 0xE0) >> 5) << 2),
+			static_cast<uint8_t>((data[index] & 0x1f) << 3)
+		};
+	}
+	case PixelFormat::RGB24:
+	case PixelFormat::BGR24:
+	case PixelFormat::RGB32:
+	case PixelFormat::BGR32:
+	{
+		const int bytes = bytesPerPixel(pixelFormat);
+		size_t index = lineLength * ySource + xSource * bytes;
+		const bool bgr = (pixelFormat == PixelFormat::BGR24 || pixelFormat == PixelFormat::BGR32);
+		return { data[index + (bgr ? 2 : 0)], data[index + 1], data[index + (bgr ? 0 : 2)] };
+	}
+	case PixelFormat::NV12:
+	case PixelFormat::NV21:
+	{
+		size_t uOffset = (height + ySource / 2) * lineLength;
+		uint8_t y = data[lineLength * ySource + xSource];
+		uint8_t first = data[uOffset + ((xSource >> 1) << 1)];
+		uint8_t second = data[uOffset + ((xSource >> 1) << 1) + 1];
+		return (pixelFormat == PixelFormat::NV12) ? Channels { y, first, second } : Channels { y, second, first };
+	}
+	case PixelFormat::I420:
+	{
+		int uOffset = width * height + (ySource/2) * width/2;
+		int vOffset = width * height + (width * height / 4) + (ySource/2) * width/2;
+		return { data[lineLength * ySource + xSource], data[uOffset + (xSource >> 1)], data[vOffset + (xSource >> 1)] };
+	}
+	case PixelFormat::I422:
+	{
+		int uOffset = width * height + ySource * (width/2);
+		int vOffset = (width * height) + (width * height / 2) + ySource * (width/2);
+		return { data[lineLength * ySource + xSource], data[uOffset + (xSource >> 1)], data[vOffset + (xSource >> 1)] };
+	}
+	default:
+		return { 0, 0, 0 };
+	}
+}
+
+ColorRgb toRgb(PixelFormat pixelFormat, const Channels& channels)
+{
+	ColorRgb rgb(static_cast<uint8_t>(channels[0]), static_cast<uint8_t>(channels[1]), static_cast<uint8_t>(channels[2]));
+	switch (pixelFormat)
+	{
+	case PixelFormat::UYVY:
+	case PixelFormat::YUYV:
+	case PixelFormat::NV12:
+	case PixelFormat::NV21:
+	case PixelFormat::I420:
+	case PixelFormat::I422:
+		ColorSys::yuv2rgb(static_cast<uint8_t>(channels[0]), static_cast<uint8_t>(channels[1]), static_cast<uint8_t>(channels[2]), rgb.red, rgb.green, rgb.blue);
+		break;
+	default:
+		break;
+	}
+	return rgb;
+}
+
+///
+/// Reference output: decimation, cropping, 3D mode and flip mode as implemented per pixel before.
+/// With the box filter the channels of all pixels of a block are averaged (BGR16 is always sampled).
+///
+Image<ColorRgb> referenceImage(const Frame& frame, PixelFormat pixelFormat, int decimation, int cropLeft, int cropRight, int cropTop, int cropBottom, VideoMode videoMode, FlipMode flipMode, bool boxFilter)
+{
+	switch (videoMode)
+	{
+	case VideoMode::VIDEO_3DSBS:
+		cropRight =  (frame.width >> 1) + (cropRight >> 1);
+		cropLeft = cropLeft >> 1;
+		break;
+	case VideoMode::VIDEO_3DTAB:
+		cropBottom = (frame.height >> 1) + (cropBottom >> 1);
+		cropTop = cropTop >> 1;
+		break;
+	default:
+		break;
+	}
+
+	const int outputWidth = (frame.width - cropLeft - cropRight - (decimation >> 1) + decimation - 1) / decimation;
+	const int outputHeight = (frame.height - cropTop - cropBottom - (decimation >> 1) + decimation - 1) / decimation;
+
+	const bool mirrorRows = (flipMode == FlipMode::HORIZONTAL || flipMode == FlipMode::BOTH);
+	const bool mirrorColumns = (flipMode == FlipMode::VERTICAL || flipMode == FlipMode::BOTH);
+	const bool average = boxFilter && decimation > 1 && pixelFormat != PixelFormat::BGR16;
+
+	Image<ColorRgb> image(outputWidth, outputHeight);
+	for (int yDest = 0; yDest < outputHeight; ++yDest)
+	{
+		for (int xDest = 0; xDest < outputWidth; ++xDest)
+		{
+			Channels channels { 0, 0, 0 };
+			if (average)
+			{
+				const int xBegin = cropLeft + xDest * decimation;
+				const int yBegin = cropTop + yDest * decimation;
+				const int xEnd = std::min(xBegin + decimation, frame.width - cropRight);
+				const int yEnd = std::min(yBegin + decimation, frame.height - cropBottom);
+				const uint32_t count = static_cast<uint32_t>((xEnd - xBegin) * (yEnd - yBegin));
+
+				for (int y = yBegin; y < yEnd; ++y)
+				{
+					for (int x = xBegin; x < xEnd; ++x)
+					{
+						const Channels pixel = referenceChannels(frame, pixelFormat, x, y);
+						for (size_t channel = 0; channel < channels.size(); ++channel)
+						{
+							channels[channel] += pixel[channel];
+						}
+					}
+				}
+
+				for (uint32_t& channel : channels)
+				{
+					channel = (channel + count / 2) / count;
+				}
+			}
+			else
+			{
+				channels = referenceChannels(frame, pixelFormat, cropLeft + (decimation >> 1) + xDest * decimation, cropTop + (decimation >> 1) + yDest * decimation);
+			}
+
+			image(mirrorColumns ? outputWidth - 1 - xDest : xDest, mirrorRows ? outputHeight - 1 - yDest : yDest) = toRgb(pixelFormat, channels);
+		}
+	}
+	return image;
+}
+
+bool isEqual(const Image<ColorRgb>& lhs, const Image<ColorRgb>& rhs)
+{
+	if (lhs.width() != rhs.width() || lhs.height() != rhs.height())
+	{
+		return false;
+	}
+
+	for (int y = 0; y < lhs.height(); ++y)
+	{
+		for (int x = 0; x < lhs.width(); ++x)
+		{
+			if (lhs(x, y) != rhs(x, y))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+///
+/// Known BT.601 colors, encoded as uniform YUV frames of every YUV format
+///
+int testGoldenColors()
+{
+	struct Golden
+	{
+		uint8_t y, u, v;
+		ColorRgb rgb;
+	};
+
+	const Golden goldens[] = {
+		{  16, 128, 128, ColorRgb(  0,   0,   0) },
+		{ 235, 128, 128, ColorRgb(255, 255, 255) },
+		{ 126, 128, 128, ColorRgb(128, 128, 128) },
+		{  81,  90, 240, ColorRgb(255,   0,   0) },
+		{ 145,  53,  34, ColorRgb(  0, 255,   0) },
+		{  41, 240, 110, ColorRgb(  0,   0, 255) },
+	};
+
+	const int width = 40;
+	const int height = 20;
+
+	int errors = 0;
+	for (const Golden& golden : goldens)
+	{
+		for (const PixelFormat pixelFormat : { PixelFormat::YUYV, PixelFormat::UYVY, PixelFormat::NV12, PixelFormat::NV21, PixelFormat::I420, PixelFormat::I422 })
+		{
+			std::vector<uint8_t> data;
+			size_t lineLength = width;
+			switch (pixelFormat)
+			{
+			case PixelFormat::YUYV:
+			case PixelFormat::UYVY:
+			{
+				lineLength = width * 2;
+				const bool yuyv = (pixelFormat == PixelFormat::YUYV);
+				for (int i = 0; i < width * height / 2; ++i)
+				{
+					const uint8_t macroPixel[4] = { yuyv ? golden.y : golden.u, yuyv ? golden.u : golden.y, yuyv ? golden.y : golden.v, yuyv ? golden.v : golden.y };
+					data.insert(data.end(), macroPixel, macroPixel + 4);
+				}
+				break;
+			}
+			case PixelFormat::NV12:
+			case PixelFormat::NV21:
+				data.assign(width * height, golden.y);
+				for (int i = 0; i < width * height / 4; ++i)
+				{
+					data.push_back(pixelFormat == PixelFormat::NV12 ? golden.u : golden.v);
+					data.push_back(pixelFormat == PixelFormat::NV12 ? golden.v : golden.u);
+				}
+				break;
+			case PixelFormat::I420:
+				data.assign(width * height, golden.y);
+				data.insert(data.end(), width * height / 4, golden.u);
+				data.insert(data.end(), width * height / 4, golden.v);
+				break;
+			default:
+				data.assign(width * height, golden.y);
+				data.insert(data.end(), width * height / 2, golden.u);
+				data.insert(data.end(), width * height / 2, golden.v);
+				break;
+			}
+
+			ImageResampler resampler;
+			resampler.setPixelDecimation(1);
+			Image<ColorRgb> image;
+			resampler.processImage(data.data(), width, height, lineLength, pixelFormat, image);
+
+			bool matches = (image.width() == width && image.height() == height);
+			for (int y = 0; matches && y < height; ++y)
+			{
+				for (int x = 0; matches && x < width; ++x)
+				{
+					matches = (image(x, y) == golden.rgb);
+				}
+			}
+
+			if (!matches)
+			{
+				std::cout << "Golden color " << golden.rgb << " not reproduced from " << pixelFormatToString(pixelFormat).toStdString() << '\n';
+				++errors;
+			}
+		}
+	}
+	return errors;
+}
+
+struct Crop
+{
+	int left, right, top, bottom;
+};
+
+///
+/// Output of all available YUV conversion implementations compared to the reference
+///
+int compareToReference(const Frame& frame, PixelFormat pixelFormat, int decimation, const Crop& crop, VideoMode videoMode, FlipMode flipMode, bool boxFilter, int& cases)
+{
+	const Image<ColorRgb> expected = referenceImage(frame, pixelFormat, decimation, crop.left, crop.right, crop.top, crop.bottom, videoMode, flipMode, boxFilter);
+
+	int errors = 0;
+	for (const YuvToRgb::Implementation implementation : { YuvToRgb::Implementation::SCALAR, YuvToRgb::Implementation::SSE2, YuvToRgb::Implementation::AVX2, YuvToRgb::Implementation::NEON })
+	{
+		if (!YuvToRgb::setImplementation(implementation))
+		{
+			continue;
+		}
+
+		ImageResampler resampler;
+		resampler.setPixelDecimation(decimation);
+		resampler.setCropping(crop.left, crop.right, crop.top, crop.bottom);
+		resampler.setVideoMode(videoMode);
+		resampler.setFlipMode(flipMode);
+		resampler.setBoxFilter(boxFilter);
+
+		Image<ColorRgb> actual;
+		resampler.processImage(frame.data.data(), frame.width, frame.height, frame.lineLength, pixelFormat, actual);
+
+		if (!isEqual(actual, expected))
+		{
+			std::cout << pixelFormatToString(pixelFormat).toStdString() << " (" << YuvToRgb::implementationToString(implementation)
+					  << "): mismatch for decimation " << decimation << ", flip mode " << flipModeToString(flipMode).toStdString()
+					  << ", video mode " << videoMode2String(videoMode).toStdString() << (boxFilter ? ", box filter" : "") << '\n';
+			++errors;
+		}
+		++cases;
+	}
+	return errors;
+}
+
+///
+/// Output of every pixel format compared to the per-pixel reference for all flip modes, 3D modes, crops, decimations and filters
+///
+int testAgainstReference()
+{
+	std::mt19937 generator(4711);
+
+	const PixelFormat pixelFormats[] = {
+		PixelFormat::YUYV, PixelFormat::UYVY, PixelFormat::BGR16, PixelFormat::RGB24, PixelFormat::BGR24, PixelFormat::RGB32,
+		PixelFormat::BGR32, PixelFormat::NV12, PixelFormat::NV21, PixelFormat::P030, PixelFormat::I420, PixelFormat::I422,
+		PixelFormat::MJPEG, PixelFormat::NO_CHANGE
+	};
+
+	const Crop crops[] = { { 0, 0, 0, 0 }, { 3, 5, 2, 4 }, { 10, 0, 0, 7 } };
+
+	int errors = 0;
+	for (const PixelFormat pixelFormat : pixelFormats)
+	{
+		if (!isDecoded(pixelFormat))
+		{
+			std::cout << pixelFormatToString(pixelFormat).toStdString() << ": not decoded by the resampler, skipped" << '\n';
+			continue;
+		}
+
+		const Frame frame = createFrame(pixelFormat, 132, 76, generator);
+
+		int cases = 0;
+		for (const int decimation : { 1, 2, 3, 8 })
+		{
+			for (const FlipMode flipMode : { FlipMode::NO_CHANGE, FlipMode::HORIZONTAL, FlipMode::VERTICAL, FlipMode::BOTH })
+			{
+				for (const VideoMode videoMode : { VideoMode::VIDEO_2D, VideoMode::VIDEO_3DSBS, VideoMode::VIDEO_3DTAB })
+				{
+					for (const Crop& crop : crops)
+					{
+						for (const bool boxFilter : { false, true })
+						{
+							errors += compareToReference(frame, pixelFormat, decimation, crop, videoMode, flipMode, boxFilter, cases);
+						}
+					}
+				}
+			}
+		}
+		std::cout << pixelFormatToString(pixelFormat).toStdString() << ": " << cases << " cases compared to reference" << '\n';
+	}
+	return errors;
+}
+
+///
+/// Reference address of a pixel in the Broadcom SAND layout
+///
+size_t sandOffset(size_t columnWidth, size_t columnHeight, size_t x, size_t y)
+{
+	return (x / columnWidth) * columnWidth * columnHeight + y * columnWidth + x % columnWidth;
+}
+
+///
+/// Reference address of a pixel in the VC4 T-tiled layout at 32 bits per pixel (following igt_vc4_t_tiled_offset of igt-gpu-tools)
+///
+size_t tTiledOffset(size_t pitch, size_t x, size_t y)
+{
+	const size_t evenOrder[] = { 0, 3, 1, 2 };
+	const size_t oddOrder[] = { 2, 1, 3, 0 };
+
+	// 4 KiB tiles of 32x32 pixels, right to left in odd rows of tiles
+	const size_t tileY = y / 32;
+	size_t tileX = x / 32;
+	if (tileY % 2)
+	{
+		tileX = pitch / 128 - tileX - 1;
+	}
+	size_t offset = tileY * 32 * pitch + tileX * 4096;
+
+	// 1 KiB sub-tiles of 16x16 pixels
+	x %= 32;
+	y %= 32;
+	const size_t index = (y / 16) * 2 + x / 16;
+	offset += ((tileY % 2) ? oddOrder[index] : evenOrder[index]) * 1024;
+
+	// 64 byte micro-tiles of 4x4 pixels
+	x %= 16;
+	y %= 16;
+	offset += ((y / 4) * 4 + x / 4) * 64;
+	offset += ((y % 4) * 4 + x % 4) * 4;
+
+	return offset;
+}
+
+///
+/// Output of synthetic tiled frames compared to the output of the same frames in linear layout
+///
+int testTiledLayouts()
+{
+	std::mt19937 generator(815);
+	std::uniform_int_distribution<int> distribution(0, 255);
+
+	// Neither a multiple of the SAND columns nor of the T-tiles
+	const int width = 200;
+	const int height = 90;
+
+	// NV12 with a column of 128 bytes holding the luma lines followed by the chroma lines, both with some padding
+	std::vector<uint8_t> linearYuv(static_cast<size_t>(width) * height * 3 / 2);
+	std::generate(linearYuv.begin(), linearYuv.end(), [&]() { return static_cast<uint8_t>(distribution(generator)); });
+
+	const int lumaLines = height + 6;
+	ImageResampler::TiledLayout sand { ImageResampler::TiledLayout::Type::BROADCOM_SAND, 128, lumaLines + height / 2 + 4, 0, { 0, static_cast<size_t>(lumaLines) * 128 } };
+	std::vector<uint8_t> sandFrame(ImageResampler::tiledImageSize(width, height, sand, PixelFormat::NV12));
+	for (int y = 0; y < height; ++y)
+	{
+		for (int x = 0; x < width; ++x)
+		{
+			sandFrame[sand.planeOffsets[0] + sandOffset(128, sand.columnHeight, x, y)] = linearYuv[static_cast<size_t>(y) * width + x];
+			if (y < height / 2)
+			{
+				sandFrame[sand.planeOffsets[1] + sandOffset(128, sand.columnHeight, x, y)] = linearYuv[static_cast<size_t>(height + y) * width + x];
+			}
+		}
+	}
+
+	// RGB32 with a pitch of one tile more than required
+	std::vector<uint8_t> linearRgb(static_cast<size_t>(width) * height * 4);
+	std::generate(linearRgb.begin(), linearRgb.end(), [&]() { return static_cast<uint8_t>(distribution(generator)); });
+
+	const ImageResampler::TiledLayout tTiled { ImageResampler::TiledLayout::Type::VC4_T_TILED, 0, 0, ((width + 31) / 32 + 1) * 128, { 0, 0 } };
+	std::vector<uint8_t> tTiledFrame(ImageResampler::tiledImageSize(width, height, tTiled, PixelFormat::RGB32));
+	for (int y = 0; y < height; ++y)
+	{
+		for (int x = 0; x < width; ++x)
+		{
+			std::copy_n(&linearRgb[(static_cast<size_t>(y) * width + x) * 4], 4, &tTiledFrame[tTiledOffset(tTiled.pitch, x, y)]);
+		}
+	}
+
+	int errors = 0;
+	int cases = 0;
+
+	ImageResampler resampler;
+	Image<ColorRgb> expected;
+	Image<ColorRgb> actual;
+	if (resampler.processTiledImage(tTiledFrame.data(), width, height, tTiled, PixelFormat::NV12, actual)
+		|| resampler.processTiledImage(sandFrame.data(), width, height, sand, PixelFormat::RGB32, actual))
+	{
+		std::cout << "Tiled layouts: unsupported pixel format accepted" << '\n';
+		++errors;
+	}
+
+	const Crop crops[] = { { 0, 0, 0, 0 }, { 3, 5, 2, 4 }, { 10, 0, 0, 7 } };
+	for (const int decimation : { 1, 2, 3, 8 })
+	{
+		for (const FlipMode flipMode : { FlipMode::NO_CHANGE, FlipMode::HORIZONTAL, FlipMode::VERTICAL, FlipMode::BOTH })
+		{
+			for (const VideoMode videoMode : { VideoMode::VIDEO_2D, VideoMode::VIDEO_3DSBS, VideoMode::VIDEO_3DTAB })
+			{
+				for (const Crop& crop : crops)
+				{
+					resampler.setPixelDecimation(decimation);
+					resampler.setCropping(crop.left, crop.right, crop.top, crop.bottom);
+					resampler.setVideoMode(videoMode);
+					resampler.setFlipMode(flipMode);
+
+					for (const PixelFormat pixelFormat : { PixelFormat::NV12, PixelFormat::NV21, PixelFormat::RGB32, PixelFormat::BGR32 })
+					{
+						const bool isYuv = (pixelFormat == PixelFormat::NV12 || pixelFormat == PixelFormat::NV21);
+						if (isYuv)
+						{
+							resampler.processImage(linearYuv.data(), width, height, width, pixelFormat, expected);
+						}
+						else
+						{
+							resampler.processImage(linearRgb.data(), width, height, static_cast<size_t>(width) * 4, pixelFormat, expected);
+						}
+
+						if (!resampler.processTiledImage(isYuv ? sandFrame.data() : tTiledFrame.data(), width, height, isYuv ? sand : tTiled, pixelFormat, actual)
+							|| !isEqual(actual, expected))
+						{
+							std::cout << pixelFormatToString(pixelFormat).toStdString() << (isYuv ? " (SAND128)" : " (T-tiled)")
+									  << ": mismatch for decimation " << decimation << ", flip mode " << flipModeToString(flipMode).toStdString()
+									  << ", video mode " << videoMode2String(videoMode).toStdString() << '\n';
+							++errors;
+						}
+						++cases;
+					}
+				}
+			}
+		}
+	}
+
+	std::cout << "Tiled layouts: " << cases << " cases compared to linear layout" << '\n';
+	return errors;
+}
+
+}
+
+int main()
+{
+	for (const YuvToRgb::Implementation implementation : { YuvToRgb::Implementation::SSE2, YuvToRgb::Implementation::AVX2, YuvToRgb::Implementation::NEON })
+	{
+		if (!YuvToRgb::isSupported(implementation))
+		{
+			std::cout << YuvToRgb::implementationToString(implementation) << ": not supported, skipped" << '\n';
+		}
+	}
+
+	int errors = testGoldenColors();
+	errors += testAgainstReference();
+	errors += testTiledLayouts();
+
+	std::cout << (errors == 0 ? "All images match" : "Images differ") << '\n';
+	return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,130 @@
+// STL includes
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Utils includes
+#include <utils/ColorRgb.h>
+#include <utils/Image.h>
+#include <utils/ImageResampler.h>
+#include <utils/PixelAccumulator.h>
+#include <utils/PixelFormat.h>
+#include <utils/YuvToRgb.h>
+
+namespace {
+
+struct Format
+{
+	PixelFormat pixelFormat;
+	/// Bytes per pixel of the first plane
+	int bytesPerPixel;
+	/// Size of all planes relative to the first one, in halves
+	int sizeInHalves;
+};
+
+PixelAccumulator::Implementation accumulatorImplementation(YuvToRgb::Implementation implementation)
+{
+	switch (implementation)
+	{
+	case YuvToRgb::Implementation::SSE2:
+		return PixelAccumulator::Implementation::SSE2;
+	case YuvToRgb::Implementation::AVX2:
+		return PixelAccumulator::Implementation::AVX2;
+	case YuvToRgb::Implementation::NEON:
+		return PixelAccumulator::Implementation::NEON;
+	case YuvToRgb::Implementation::SCALAR:
+	default:
+		return PixelAccumulator::Implementation::SCALAR;
+	}
+}
+
+///
+/// Average time to resample one frame in microseconds
+///
+double measure(const std::vector<uint8_t>& frame, int width, int height, size_t lineLength, PixelFormat pixelFormat, int decimation, bool boxFilter, int iterations)
+{
+	ImageResampler resampler;
+	resampler.setPixelDecimation(decimation);
+	resampler.setBoxFilter(boxFilter);
+
+	Image<ColorRgb> image;
+	resampler.processImage(frame.data(), width, height, lineLength, pixelFormat, image);
+
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; ++i)
+	{
+		resampler.processImage(frame.data(), width, height, lineLength, pixelFormat, image);
+	}
+	const auto duration = std::chrono::steady_clock::now() - start;
+
+	return std::chrono::duration<double, std::micro>(duration).count() / iterations;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	const int width = 1920;
+	const int height = 1080;
+	const int iterations = (argc > 1) ? std::max(1, std::atoi(argv[1])) : 50;
+
+	const Format formats[] = {
+		{ PixelFormat::YUYV, 2, 2 },
+		{ PixelFormat::UYVY, 2, 2 },
+		{ PixelFormat::NV12, 1, 3 },
+		{ PixelFormat::I420, 1, 3 },
+		{ PixelFormat::I422, 1, 4 },
+		{ PixelFormat::RGB24, 3, 2 },
+		{ PixelFormat::BGR32, 4, 2 },
+	};
+
+	std::mt19937 generator(4711);
+	std::uniform_int_distribution<int> distribution(0, 255);
+
+	std::cout << "Resampling " << width << "x" << height << " frames, " << iterations << " iterations, time per frame [us]" << '\n';
+	std::cout << std::setw(8) << "format" << std::setw(12) << "decimation" << std::setw(8) << "filter";
+	for (const YuvToRgb::Implementation implementation : { YuvToRgb::Implementation::SCALAR, YuvToRgb::Implementation::SSE2, YuvToRgb::Implementation::AVX2, YuvToRgb::Implementation::NEON })
+	{
+		std::cout << std::setw(10) << YuvToRgb::implementationToString(implementation);
+	}
+	std::cout << '\n';
+
+	for (const Format& format : formats)
+	{
+		const size_t lineLength = static_cast<size_t>(width) * format.bytesPerPixel;
+		std::vector<uint8_t> frame(lineLength * height * format.sizeInHalves / 2);
+		for (uint8_t& byte : frame)
+		{
+			byte = static_cast<uint8_t>(distribution(generator));
+		}
+
+		for (const int decimation : { 1, 2, 8 })
+		{
+			for (const bool boxFilter : { false, true })
+			{
+				if (boxFilter && decimation == 1)
+				{
+					continue;
+				}
+
+				std::cout << std::setw(8) << pixelFormatToString(format.pixelFormat).toStdString() << std::setw(12) << decimation << std::setw(8) << (boxFilter ? "box" : "sample");
+				for (const YuvToRgb::Implementation implementation : { YuvToRgb::Implementation::SCALAR, YuvToRgb::Implementation::SSE2, YuvToRgb::Implementation::AVX2, YuvToRgb::Implementation::NEON })
+				{
+					// The implementation is used for the YUV conversion and the line sums of the box filter
+					if (!YuvToRgb::setImplementation(implementation) || !PixelAccumulator::setImplementation(accumulatorImplementation(implementation)))
+					{
+						std::cout << std::setw(10) << "-";
+						continue;
+					}
+					std::cout << std::setw(10) << std::fixed << std::setprecision(1) << measure(frame, width, height, lineLength, format.pixelFormat, decimation, boxFilter, iterations);
+				}
+				std::cout << '\n';
+			}
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,145 @@
+// STL includes
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+
+// Utils includes
+#include <utils/ColorRgb.h>
+
+// Hyperion includes
+#include <hyperion/LedString.h>
+#include <hyperion/LedColorPlanes.h>
+
+namespace {
+
+const ColorOrder ORDERS[] = { ColorOrder::ORDER_RGB, ColorOrder::ORDER_RBG, ColorOrder::ORDER_GRB,
+							  ColorOrder::ORDER_BRG, ColorOrder::ORDER_GBR, ColorOrder::ORDER_BGR };
+
+/// LED counts around the 16 byte vectors and the plane alignment
+const int SIZES[] = { 0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100 };
+
+std::mt19937 generator(4711);
+
+QVector<ColorRgb> randomColors(int size)
+{
+	std::uniform_int_distribution<int> channel(0, UINT8_MAX);
+	QVector<ColorRgb> colors;
+	for (int i = 0; i < size; ++i)
+	{
+		colors.push_back(ColorRgb(static_cast<uint8_t>(channel(generator)), static_cast<uint8_t>(channel(generator)), static_cast<uint8_t>(channel(generator))));
+	}
+	return colors;
+}
+
+///
+/// The blacklist and color order applied per LED (as the output stages did before the color planes)
+///
+QVector<ColorRgb> reference(QVector<ColorRgb> colors, const QVector<int>& blacklist, const QVector<ColorOrder>& colorOrders)
+{
+	for (const int id : blacklist)
+	{
+		if (id < colors.size())
+		{
+			colors[id] = ColorRgb(0, 0, 0);
+		}
+	}
+
+	for (int i = 0; i < colorOrders.size() && i < colors.size(); ++i)
+	{
+		ColorRgb& color = colors[i];
+		switch (colorOrders.at(i))
+		{
+		case ColorOrder::ORDER_RGB:
+			break;
+		case ColorOrder::ORDER_BGR:
+			std::swap(color.red, color.blue);
+			break;
+		case ColorOrder::ORDER_RBG:
+			std::swap(color.green, color.blue);
+			break;
+		case ColorOrder::ORDER_GRB:
+			std::swap(color.red, color.green);
+			break;
+		case ColorOrder::ORDER_GBR:
+			std::swap(color.red, color.green);
+			std::swap(color.green, color.blue);
+			break;
+		case ColorOrder::ORDER_BRG:
+			std::swap(color.red, color.blue);
+			std::swap(color.green, color.blue);
+			break;
+		}
+	}
+	return colors;
+}
+
+bool check(LedColorPlanes& planes, const std::string& name, const QVector<ColorRgb>& colors, const QVector<int>& blacklist, const QVector<ColorOrder>& colorOrders)
+{
+	planes.assign(colors);
+	planes.setBlack(blacklist);
+	planes.applyColorOrder(LedColorPlanes::ColorOrderMap(colorOrders));
+
+	QVector<ColorRgb> result(colors.size());
+	planes.copyTo(result);
+
+	if (result != reference(colors, blacklist, colorOrders))
+	{
+		std::cout << name << ", " << colors.size() << " LEDs - FAILED" << '\n';
+		return false;
+	}
+	return true;
+}
+
+}
+
+int main()
+{
+	// Reused for all sizes, the planes are exchanged by the color order
+	LedColorPlanes planes;
+	int checks = 0;
+	int failures = 0;
+
+	for (const int size : SIZES)
+	{
+		const QVector<ColorRgb> colors = randomColors(size);
+
+		// The first, the last and LEDs beyond the end
+		QVector<int> blacklist { size, size + 17 };
+		if (size > 0)
+		{
+			blacklist << 0 << size / 2 << size - 1;
+		}
+
+		std::uniform_int_distribution<int> order(0, 5);
+		QVector<ColorOrder> mixed;
+		for (int i = 0; i < size; ++i)
+		{
+			mixed.push_back(ORDERS[order(generator)]);
+		}
+
+		// The tail of LEDs not defined by the layout keeps RGB
+		const QVector<ColorOrder> mixedShort = mixed.mid(0, size * 2 / 3);
+
+		for (const ColorOrder colorOrder : ORDERS)
+		{
+			const std::string name = "Uniform " + colorOrderToString(colorOrder).toStdString();
+			const QVector<ColorOrder> uniform(size, colorOrder);
+			const QVector<ColorOrder> uniformShort(size * 2 / 3, colorOrder);
+
+			failures += check(planes, name, colors, {}, uniform) ? 0 : 1;
+			failures += check(planes, name + ", blacklist", colors, blacklist, uniform) ? 0 : 1;
+			failures += check(planes, name + ", shorter map", colors, blacklist, uniformShort) ? 0 : 1;
+			checks += 3;
+		}
+
+		failures += check(planes, "Mixed", colors, {}, mixed) ? 0 : 1;
+		failures += check(planes, "Mixed, blacklist", colors, blacklist, mixed) ? 0 : 1;
+		failures += check(planes, "Mixed, shorter map", colors, blacklist, mixedShort) ? 0 : 1;
+		failures += check(planes, "Empty map", colors, blacklist, {}) ? 0 : 1;
+		checks += 4;
+	}
+
+	std::cout << (checks - failures) << " of " << checks << " checks passed" << '\n';
+	return failures == 0 ? 0 : 1;
+}
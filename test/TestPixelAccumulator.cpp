@@ -0,0 +1,110 @@
+// STL includes
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Utils includes
+#include <utils/ColorRgb.h>
+#include <utils/PixelAccumulator.h>
+
+namespace {
+
+bool operator!=(const PixelAccumulator::Sums& lhs, const PixelAccumulator::Sums& rhs)
+{
+	return lhs.red != rhs.red || lhs.green != rhs.green || lhs.blue != rhs.blue;
+}
+
+}
+
+int main()
+{
+	using Implementation = PixelAccumulator::Implementation;
+
+	// Random pixels, large enough to cover multiple flushes of the vectorized accumulators
+	std::mt19937 generator(4711);
+	std::uniform_int_distribution<int> distribution(0, 255);
+	std::vector<ColorRgb> pixels(300000);
+	for (ColorRgb& pixel : pixels)
+	{
+		pixel = ColorRgb(static_cast<uint8_t>(distribution(generator)), static_cast<uint8_t>(distribution(generator)), static_cast<uint8_t>(distribution(generator)));
+	}
+
+	const int lengths[] = { 0, 1, 2, 15, 16, 17, 31, 32, 33, 47, 48, 49, 100, 1000, 4097, 70000 };
+	const int offsets[] = { 0, 1, 5 };
+
+	int errors = 0;
+	for (const Implementation implementation : { Implementation::SSE2, Implementation::AVX2, Implementation::NEON })
+	{
+		if (!PixelAccumulator::isSupported(implementation))
+		{
+			std::cout << PixelAccumulator::implementationToString(implementation) << ": not supported, skipped" << '\n';
+			continue;
+		}
+
+		int cases = 0;
+		for (int stride = 1; stride <= 8; ++stride)
+		{
+			for (const int length : lengths)
+			{
+				for (const int offset : offsets)
+				{
+					const ColorRgb* run = pixels.data() + offset;
+					if (length > 0 && offset + (length - 1) * stride >= static_cast<int>(pixels.size()))
+					{
+						continue;
+					}
+
+					PixelAccumulator::Sums expectedSum;
+					PixelAccumulator::Sums expectedSquared;
+					PixelAccumulator::setImplementation(Implementation::SCALAR);
+					PixelAccumulator::sum(run, length, stride, expectedSum);
+					PixelAccumulator::sumSquared(run, length, stride, expectedSquared);
+
+					PixelAccumulator::Sums actualSum;
+					PixelAccumulator::Sums actualSquared;
+					PixelAccumulator::setImplementation(implementation);
+					PixelAccumulator::sum(run, length, stride, actualSum);
+					PixelAccumulator::sumSquared(run, length, stride, actualSquared);
+
+					if (actualSum != expectedSum || actualSquared != expectedSquared)
+					{
+						std::cout << PixelAccumulator::implementationToString(implementation)
+								  << ": mismatch for length " << length << ", stride " << stride << ", offset " << offset << '\n';
+						++errors;
+					}
+					++cases;
+				}
+			}
+		}
+
+		// Element-wise byte sums, as used to sum up the lines of an image block
+		const auto* bytes = reinterpret_cast<const uint8_t*>(pixels.data());
+		for (const int length : lengths)
+		{
+			for (const int offset : offsets)
+			{
+				std::vector<uint16_t> expected(static_cast<size_t>(length) + 1, 1000);
+				std::vector<uint16_t> actual(expected);
+				for (int line = 0; line < 3; ++line)
+				{
+					PixelAccumulator::setImplementation(Implementation::SCALAR);
+					PixelAccumulator::addBytes(bytes + offset + line * 7, length, expected.data());
+					PixelAccumulator::setImplementation(implementation);
+					PixelAccumulator::addBytes(bytes + offset + line * 7, length, actual.data());
+				}
+
+				if (actual != expected)
+				{
+					std::cout << PixelAccumulator::implementationToString(implementation)
+							  << ": byte sums mismatch for length " << length << ", offset " << offset << '\n';
+					++errors;
+				}
+				++cases;
+			}
+		}
+		std::cout << PixelAccumulator::implementationToString(implementation) << ": " << cases << " cases compared to scalar" << '\n';
+	}
+
+	std::cout << (errors == 0 ? "All results are bit-identical" : "Results differ") << '\n';
+	return errors == 0 ? 0 : 1;
+}
@@ -36,11 +36,58 @@ int main()
 			std::cout << "RGB error idx " << i << " " << rgb << std::endl;
 	}
 
-	
-	
-	
+	// fingerprint
+	std::cout << "Fingerprinting image" << std::endl;
+	int errors = 0;
+	image_rgb.updateFingerprint();
+	const Image<ColorRgb> image_copy = image_rgb;
+	const quint64 fingerprint = image_rgb.fingerprint();
+	if (fingerprint == 0 || image_copy.fingerprint() != fingerprint)
+	{
+		std::cout << "Fingerprint error: shallow copy differs" << std::endl;
+		++errors;
+	}
+
+	image_rgb.memptr()[l / 2] = ColorRgb{255,128,1};
+	if (image_rgb.fingerprint() == fingerprint || image_copy.fingerprint() != fingerprint)
+	{
+		std::cout << "Fingerprint error: modified pixel not detected" << std::endl;
+		++errors;
+	}
+
+	image_rgb.memptr()[l / 2] = ColorRgb{255,128,0};
+	if (image_rgb.fingerprint() != fingerprint)
+	{
+		std::cout << "Fingerprint error: restored image differs" << std::endl;
+		++errors;
+	}
+
+	// pixel buffer pool (sizes not used otherwise)
+	std::cout << "Recycling pixel buffers" << std::endl;
+	const ColorRgb* released = nullptr;
+	{
+		Image<ColorRgb> image(37, 23, ColorRgb::BLACK);
+		released = image.memptr();
+	}
+
+	Image<ColorRgb> resized;
+	resized.resize(37, 23);
+	if (resized.memptr() != released)
+	{
+		std::cout << "Pool error: resized image does not reuse the released buffer" << std::endl;
+		++errors;
+	}
+
+	const ColorRgb* previous = resized.memptr();
+	resized.resize(41, 19);
+	const Image<ColorRgb> same_size(37, 23, ColorRgb::BLACK);
+	if (same_size.memptr() != previous)
+	{
+		std::cout << "Pool error: buffer of the previous size not released on resize" << std::endl;
+		++errors;
+	}
 
 	std::cout << "Finished (destruction will be performed)" << std::endl;
 
-	return 0;
+	return errors == 0 ? 0 : 1;
 }
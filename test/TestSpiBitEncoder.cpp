@@ -0,0 +1,71 @@
+// STL includes
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+// Utils includes
+#include <utils/ColorRgb.h>
+#include <utils/ColorRgbw.h>
+
+// LED-device includes
+#include <leddevice/dev_spi/SpiBitEncoder.h>
+
+namespace {
+
+///
+/// Encodes the bits of a LED two at a time, most significant first (as the SPI LED-devices did before the encoder)
+///
+void encodeBitPairs(const uint8_t bitpairToByte[4], uint64_t colorBits, int spiBytes, uint8_t* spi)
+{
+	for (int j = spiBytes - 1; j >= 0; j--)
+	{
+		spi[j] = bitpairToByte[colorBits & 0x3];
+		colorBits >>= 2;
+	}
+}
+
+template <typename Encoder>
+bool check(const char* name, const uint8_t bitpairToByte[4])
+{
+	int mismatches = 0;
+	for (int value = 0; value <= UINT8_MAX; ++value)
+	{
+		// Every channel is checked with every value, the other channels vary
+		const uint8_t channel = static_cast<uint8_t>(value);
+		const uint8_t other = static_cast<uint8_t>(value * 37 + 11);
+
+		const ColorRgb rgb(channel, other, static_cast<uint8_t>(~channel));
+		uint8_t expected[16];
+		uint8_t encoded[16];
+		encodeBitPairs(bitpairToByte, (uint64_t(rgb.red) << 16) | (uint64_t(rgb.green) << 8) | rgb.blue, 12, expected);
+		if (Encoder::encode(rgb, encoded) != encoded + 12 || memcmp(expected, encoded, 12) != 0)
+		{
+			++mismatches;
+		}
+
+		const ColorRgbw rgbw(other, channel, static_cast<uint8_t>(~other), static_cast<uint8_t>(channel ^ 0x5a));
+		encodeBitPairs(bitpairToByte, (uint64_t(rgbw.red) << 24) | (uint64_t(rgbw.green) << 16) | (uint64_t(rgbw.blue) << 8) | rgbw.white, 16, expected);
+		if (Encoder::encode(rgbw, encoded) != encoded + 16 || memcmp(expected, encoded, 16) != 0)
+		{
+			++mismatches;
+		}
+	}
+
+	std::cout << name << ": " << mismatches << " mismatches" << (mismatches == 0 ? "" : " - FAILED") << '\n';
+	return mismatches == 0;
+}
+
+}
+
+int main()
+{
+	const uint8_t ws2812[4] = { 0b10001000, 0b10001100, 0b11001000, 0b11001100 };
+	const uint8_t sk6822[4] = { 0b10001000, 0b10001110, 0b11101000, 0b11101110 };
+
+	int failures = 0;
+	failures += check<SpiBitEncoderWs2812>("WS2812/SK6812", ws2812) ? 0 : 1;
+	failures += check<SpiBitEncoderSk6822>("SK6822/APA104", sk6822) ? 0 : 1;
+
+	std::cout << (failures == 0 ? "All encoders match the bit-pair encoding" : "Encoders differ from the bit-pair encoding") << '\n';
+	return failures == 0 ? 0 : 1;
+}